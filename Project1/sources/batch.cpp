@@ -0,0 +1,865 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+#include <algorithm>	// std::swap, std::copy
+#include <thread>		// std::thread
+#include <vector>
+
+#include "batch.h"
+
+// SIMD kernels are compiled into every x86 build and picked at run time by CPUID
+// (GCC/Clang compile each kernel for its instruction set with a target attribute,
+// MSVC takes the intrinsics in any function, AVX-512 intrinsics need Visual Studio 2017)
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>		// __cpuid, __cpuidex
+#define BATCH_TARGET(isa)
+#define BATCH_AVX2		1
+#define BATCH_AVX512	(_MSC_VER >= 1910)
+#else
+#define BATCH_TARGET(isa) __attribute__((target(isa)))
+#define BATCH_AVX2		1
+#define BATCH_AVX512	1
+#endif
+#else
+#define BATCH_AVX2		0
+#define BATCH_AVX512	0
+#endif
+
+using namespace POKER;
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           Select
+
+Description:	Pick one of two values without a branch.
+
+Arguments:      mask: -1 to pick a, 0 to pick b.
+				a: First value.
+				b: Second value.
+
+Returns:        a or b.
+*---------------------------------------------------------------------------*/
+static inline int Select(int mask, int a, int b)
+{
+	return (a & mask) | (b & ~mask);
+}
+
+#if BATCH_AVX512
+
+/*--------------------------------------------------------------------------*
+Name:           Gather512
+
+Description:	Load 16 ints at the given indices. The masked gather with a
+				zeroed source is used, the plain one leaves its source register
+				undefined and GCC warns about it (-Wmaybe-uninitialized).
+
+Arguments:      base: Array to load from.
+				index: Index of each lane.
+
+Returns:        base[index] of each lane.
+*---------------------------------------------------------------------------*/
+BATCH_TARGET("avx512f") static inline __m512i Gather512(const int *base, __m512i index)
+{
+	return _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), (__mmask16)0xFFFF, index, base, 4);
+}
+
+#endif
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           GetBatchSimd
+
+Description:	Get the SIMD kernels the batch engine can use on this CPU.
+				Needs the instruction set, the OS saving its registers
+				(XGETBV) and the kernel compiled into this build.
+
+Arguments:      None.
+
+Returns:        Widest kernels supported.
+*---------------------------------------------------------------------------*/
+BATCH_SIMD POKER::GetBatchSimd(void)
+{
+#if BATCH_AVX2 && defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return BS_SCALAR;
+
+	// AVX and OSXSAVE
+	__cpuid(info, 1);
+	if ((info[2] & ((1 << 27) | (1 << 28))) != ((1 << 27) | (1 << 28)))
+		return BS_SCALAR;
+
+	// XMM and YMM state, then opmask and ZMM state
+	unsigned long long xcr0 = _xgetbv(0);
+	if ((xcr0 & 0x06) != 0x06)
+		return BS_SCALAR;
+
+	__cpuidex(info, 7, 0);
+	if (BATCH_AVX512 && ((info[1] & (1 << 16)) != 0) && ((xcr0 & 0xe6) == 0xe6))
+		return BS_AVX512;
+	if ((info[1] & (1 << 5)) != 0)
+		return BS_AVX2;
+
+	return BS_SCALAR;
+#elif BATCH_AVX2
+	if (__builtin_cpu_supports("avx512f"))
+		return BS_AVX512;
+	if (__builtin_cpu_supports("avx2"))
+		return BS_AVX2;
+
+	return BS_SCALAR;
+#else
+	return BS_SCALAR;
+#endif
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetBatchSimdName
+
+Description:	Get the name of SIMD kernels.
+
+Arguments:      simd: SIMD kernels.
+
+Returns:        Name of the instruction set.
+*---------------------------------------------------------------------------*/
+const char *POKER::GetBatchSimdName(BATCH_SIMD simd)
+{
+	switch (simd)
+	{
+	case BS_AVX512:
+		return "AVX-512";
+	case BS_AVX2:
+		return "AVX2";
+	default:
+		return "scalar";
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           BatchEngine
+
+Description:	Constructor.
+
+Arguments:      ai_list: AI of each player (no human player).
+				seed: Random seed.
+				stream: Random stream of this engine (not used in counter-based mode).
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <int LANES>
+BatchEngine<LANES>::BatchEngine(const int ai_list[], unsigned long long seed, unsigned long long stream)
+	: seed_(seed), next_game_(0), last_game_(0), simd_(GetBatchSimd())
+{
+	NintyNine::CreateCards(cards_);
+
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+		ai_[i] = ai_list[i];
+
+	for (int lane = 0; lane < LANES; ++lane)
+	{
+		std::copy(cards_, cards_ + NUM_CARDS, deck_[lane]);
+		rng_[lane].Seed(seed_, stream * LANES + lane);
+		game_[lane] = -1;
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Run
+
+Description:	Play games [first_game, last_game) in lockstep.
+				Each step plays one turn of every lane, a lane that finishes
+				its game starts the next one.
+
+Arguments:      first_game: Index of the first game.
+				last_game: Index after the last game.
+				result: Stats of the games.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <int LANES>
+void BatchEngine<LANES>::Run(int first_game, int last_game, SimResult &result)
+{
+	next_game_ = first_game;
+	last_game_ = last_game;
+
+	int num_running = 0;
+	for (int lane = 0; lane < LANES; ++lane)
+	{
+		if (StartGame(lane))
+			++num_running;
+	}
+
+	while (num_running > 0)
+	{
+		// start a turn, find out who plays a card
+
+		for (int lane = 0; lane < LANES; ++lane)
+		{
+			int player_num = player_num_[lane];
+			int is_running = (game_[lane] >= 0);
+			int is_new_round = is_running && (player_num == FirstActiveSeat(ActiveMask(lane), is_order_increase_[lane] != 0));
+
+			num_turns_[lane] += is_running;
+			num_rounds_[lane] += is_running & is_new_round;
+
+			is_active_[lane] = is_running & (((defeat_mask_[lane] >> player_num) & 1) ^ 1);
+			ai_num_[lane] = ai_[player_num];
+		}
+
+		// pick cards (dumb and smart AI for all lanes at once, random AI one by one)
+
+		ChooseCards();
+
+		for (int lane = 0; lane < LANES; ++lane)
+		{
+			if (is_active_[lane] && (ai_num_[lane] == AI_RANDOM))
+			{
+				choice_[lane] = rng_[lane].Range(NUM_CARDS_PER_PLAYER);
+				card_value_[lane] = hand_value_[choice_[lane]][player_num_[lane] * LANES + lane];
+			}
+		}
+
+		AddRunningTotals();
+
+		// refill hands, remove defeated players, move to next player
+
+		for (int lane = 0; lane < LANES; ++lane)
+		{
+			if (game_[lane] < 0)
+				continue;
+
+			int player_num = player_num_[lane];
+
+			if (is_active_[lane])
+			{
+				Cards card = DrawCard(lane);
+				hand_value_[choice_[lane]][player_num * LANES + lane] = card.GetValue();
+				hand_weight_[choice_[lane]][player_num * LANES + lane] = card.GetWeight();
+
+				if (is_lost_[lane])
+				{
+					defeat_mask_[lane] |= 1 << player_num;
+					--players_left_[lane];
+				}
+			}
+
+			if (players_left_[lane] <= 1)
+			{
+				FinishGame(lane, result);
+				if (!StartGame(lane))
+					--num_running;
+
+				continue;
+			}
+
+			player_num_[lane] = NextActiveSeat(ActiveMask(lane), player_num, is_order_increase_[lane] != 0);
+		}
+	}
+}
+
+// private functions
+
+/*--------------------------------------------------------------------------*
+Name:           StartGame
+
+Description:	Start the next game on a lane (shuffle and deal cards).
+
+Arguments:      lane: Index of the lane.
+
+Returns:        false if there are no more games, the lane becomes idle.
+*---------------------------------------------------------------------------*/
+template <int LANES>
+bool BatchEngine<LANES>::StartGame(int lane)
+{
+	if (next_game_ >= last_game_)
+	{
+		game_[lane] = -1;
+		return false;
+	}
+
+	game_[lane] = next_game_++;
+
+	// same as NintyNine::SeedStream
+	if (USE_COUNTER_RNG)
+	{
+		rng_[lane].Seed(seed_, game_[lane]);
+		std::copy(cards_, cards_ + NUM_CARDS, deck_[lane]);
+	}
+
+	total_[lane] = 0;
+	is_order_increase_[lane] = 1;
+	player_num_[lane] = 0;
+	players_left_[lane] = NUM_PLAYERS;
+	defeat_mask_[lane] = 0;
+	num_rounds_[lane] = 0;
+	num_turns_[lane] = 0;
+
+	Shuffle(lane);
+
+	// random numbers of the lazy shuffle steps of the deal, generated in one go (as NintyNine::DealCards)
+	uint32_t steps[NUM_PLAYERS * NUM_CARDS_PER_PLAYER];
+
+	if (USE_LAZY_SHUFFLE)
+		rng_[lane].Fill(steps, NUM_PLAYERS * NUM_CARDS_PER_PLAYER);
+
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+	{
+		for (int j = 0; j < NUM_CARDS_PER_PLAYER; ++j)
+		{
+			if (deck_index_[lane] >= NUM_CARDS)
+				Shuffle(lane);
+
+			Cards card = USE_LAZY_SHUFFLE ?
+				DrawShuffled(deck_[lane], deck_index_[lane], rng_[lane], steps[i * NUM_CARDS_PER_PLAYER + j]) :
+				deck_[lane][deck_index_[lane]++];
+			hand_value_[j][i * LANES + lane] = card.GetValue();
+			hand_weight_[j][i * LANES + lane] = card.GetWeight();
+		}
+	}
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           FinishGame
+
+Description:	Record stats and winner of the game on a lane.
+
+Arguments:      lane: Index of the lane.
+				result: Stats of the games.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <int LANES>
+void BatchEngine<LANES>::FinishGame(int lane, SimResult &result)
+{
+	result.stats_.Record(num_rounds_[lane], num_turns_[lane], NUM_TURNS_LIMIT);
+	++result.stats_.num_games_;
+
+	int winner = 0;
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+	{
+		if (!((defeat_mask_[lane] >> i) & 1))
+		{
+			winner = i;
+			break;
+		}
+	}
+
+	++result.win_player_[winner];
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Shuffle
+
+Description:	Shuffle the deck of a lane (same as NintyNine::Shuffle).
+
+Arguments:      lane: Index of the lane.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <int LANES>
+void BatchEngine<LANES>::Shuffle(int lane)
+{
+	Cards *deck = deck_[lane];
+
+	if (!USE_LAZY_SHUFFLE)
+	{
+		for (int i = NUM_CARDS - 1; i > 0; --i)
+			std::swap(deck[i], deck[rng_[lane].Range(i + 1)]);
+	}
+
+	deck_index_[lane] = 0;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           DrawCard
+
+Description:	Draw a card from the deck of a lane, open a new deck if all
+				cards are dealt.
+
+Arguments:      lane: Index of the lane.
+
+Returns:        The card.
+*---------------------------------------------------------------------------*/
+template <int LANES>
+Cards BatchEngine<LANES>::DrawCard(int lane)
+{
+	if (deck_index_[lane] >= NUM_CARDS)
+		Shuffle(lane);
+
+	if (USE_LAZY_SHUFFLE)
+		return DrawShuffled(deck_[lane], deck_index_[lane], rng_[lane], rng_[lane].Next32());
+
+	return deck_[lane][deck_index_[lane]++];
+}
+
+/*--------------------------------------------------------------------------*
+Name:           ChooseCards
+
+Description:	Pick a card for the current player of every lane.
+				Computes the choice of both dumb and smart AI (see PlayerDumb
+				and PlayerSmart) with masks, then keeps the one of the lane's AI.
+				Random AI lanes are handled by the caller.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <int LANES>
+void BatchEngine<LANES>::ChooseCards(void)
+{
+	int lane = 0;
+
+#if BATCH_AVX512
+	if (simd_ >= BS_AVX512)
+		lane = ChooseCardsAvx512(lane);
+#endif
+
+#if BATCH_AVX2
+	if (simd_ >= BS_AVX2)
+		lane = ChooseCardsAvx2(lane);
+#endif
+
+	// scalar fallback
+	// copy hands of current players next to each other, then update all lanes slot by slot
+	// (the loops over lanes have no branches, so the compiler can vectorize them)
+
+	if (lane == LANES)
+		return;
+
+	int hand_value[NUM_CARDS_PER_PLAYER][LANES];
+	int hand_weight[NUM_CARDS_PER_PLAYER][LANES];
+
+	for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
+	{
+		for (int j = lane; j < LANES; ++j)
+		{
+			hand_value[i][j] = hand_value_[i][player_num_[j] * LANES + j];
+			hand_weight[i][j] = hand_weight_[i][player_num_[j] * LANES + j];
+		}
+	}
+
+	int dumb_value[LANES], dumb_index[LANES];
+	int smart_value[LANES], smart_index[LANES], special_index[LANES];
+
+	for (int j = lane; j < LANES; ++j)
+	{
+		dumb_value[j] = dumb_index[j] = 0;
+		smart_value[j] = smart_index[j] = special_index[j] = 0;
+	}
+
+	for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
+	{
+		for (int j = lane; j < LANES; ++j)
+		{
+			int value = hand_value[i][j];
+			int weight = hand_weight[i][j];
+			int first_weight = hand_weight[0][j];
+			int fits = -(value <= RUNNING_TOTAL_LIMIT - total_[j]);
+
+			int mask = fits & -(value > dumb_value[j]);
+			dumb_value[j] = Select(mask, value, dumb_value[j]);
+			dumb_index[j] = Select(mask, i, dumb_index[j]);
+
+			mask = fits & -(weight == SP_NULL_WEIGHT) & -(value > smart_value[j]);
+			smart_value[j] = Select(mask, value, smart_value[j]);
+			smart_index[j] = Select(mask, i, smart_index[j]);
+
+			mask = -(special_index[j] == 0) & (-((weight == 2) & (first_weight == 0)) | -((weight == 1) & (first_weight != 1)));
+			special_index[j] = Select(mask, i, special_index[j]);
+		}
+	}
+
+	for (int j = lane; j < LANES; ++j)
+	{
+		int smart = Select(-(smart_value[j] > 0), smart_index[j], special_index[j]);
+		choice_[j] = Select(-(ai_num_[j] == AI_DUMB), dumb_index[j], smart);
+	}
+
+	for (int j = lane; j < LANES; ++j)
+		card_value_[j] = hand_value_[choice_[j]][player_num_[j] * LANES + j];
+}
+
+#if BATCH_AVX512
+
+/*--------------------------------------------------------------------------*
+Name:           ChooseCardsAvx512
+
+Description:	ChooseCards kernel, 16 lanes per instruction.
+
+Arguments:      lane: First lane to be processed.
+
+Returns:        First lane not processed.
+*---------------------------------------------------------------------------*/
+template <int LANES>
+BATCH_TARGET("avx512f") int BatchEngine<LANES>::ChooseCardsAvx512(int lane)
+{
+	for (; lane + 16 <= LANES; lane += 16)
+	{
+		const __m512i zero = _mm512_setzero_si512();
+		const __m512i one = _mm512_set1_epi32(1);
+		const __m512i two = _mm512_set1_epi32(2);
+
+		__m512i lanes = _mm512_add_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(lane));
+		__m512i index = _mm512_add_epi32(_mm512_mullo_epi32(_mm512_loadu_si512(player_num_ + lane), _mm512_set1_epi32(LANES)), lanes);
+		__m512i value_limit = _mm512_sub_epi32(_mm512_set1_epi32(RUNNING_TOTAL_LIMIT), _mm512_loadu_si512(total_ + lane));
+
+		__m512i dumb_value = zero, dumb_index = zero;
+		__m512i smart_value = zero, smart_index = zero, special_index = zero;
+
+		__m512i first_weight = Gather512(hand_weight_[0], index);
+		__mmask16 first_is_null = _mm512_cmpeq_epi32_mask(first_weight, zero);
+		__mmask16 first_not_1 = _mm512_cmpneq_epi32_mask(first_weight, one);
+
+		for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
+		{
+			__m512i slot = _mm512_set1_epi32(i);
+			__m512i value = Gather512(hand_value_[i], index);
+			__m512i weight = Gather512(hand_weight_[i], index);
+			__mmask16 fits = _mm512_cmple_epi32_mask(value, value_limit);
+
+			__mmask16 mask = fits & _mm512_cmpgt_epi32_mask(value, dumb_value);
+			dumb_value = _mm512_mask_mov_epi32(dumb_value, mask, value);
+			dumb_index = _mm512_mask_mov_epi32(dumb_index, mask, slot);
+
+			mask = fits & _mm512_cmpeq_epi32_mask(weight, zero) & _mm512_cmpgt_epi32_mask(value, smart_value);
+			smart_value = _mm512_mask_mov_epi32(smart_value, mask, value);
+			smart_index = _mm512_mask_mov_epi32(smart_index, mask, slot);
+
+			mask = (_mm512_cmpeq_epi32_mask(weight, two) & first_is_null) | (_mm512_cmpeq_epi32_mask(weight, one) & first_not_1);
+			mask &= _mm512_cmpeq_epi32_mask(special_index, zero);
+			special_index = _mm512_mask_mov_epi32(special_index, mask, slot);
+		}
+
+		__m512i smart = _mm512_mask_mov_epi32(special_index, _mm512_cmpgt_epi32_mask(smart_value, zero), smart_index);
+		__m512i choice = _mm512_mask_mov_epi32(smart, _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(ai_num_ + lane), _mm512_set1_epi32(AI_DUMB)), dumb_index);
+		__m512i card_index = _mm512_add_epi32(_mm512_mullo_epi32(choice, _mm512_set1_epi32(NUM_PLAYERS * LANES)), index);
+
+		_mm512_storeu_si512(choice_ + lane, choice);
+		_mm512_storeu_si512(card_value_ + lane, Gather512(hand_value_[0], card_index));
+	}
+
+	return lane;
+}
+
+#endif
+
+#if BATCH_AVX2
+
+/*--------------------------------------------------------------------------*
+Name:           ChooseCardsAvx2
+
+Description:	ChooseCards kernel, 8 lanes per instruction.
+
+Arguments:      lane: First lane to be processed.
+
+Returns:        First lane not processed.
+*---------------------------------------------------------------------------*/
+template <int LANES>
+BATCH_TARGET("avx2") int BatchEngine<LANES>::ChooseCardsAvx2(int lane)
+{
+	for (; lane + 8 <= LANES; lane += 8)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i one = _mm256_set1_epi32(1);
+		const __m256i two = _mm256_set1_epi32(2);
+
+		__m256i lanes = _mm256_add_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(lane));
+		__m256i index = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_loadu_si256((const __m256i *)(player_num_ + lane)), _mm256_set1_epi32(LANES)), lanes);
+		__m256i value_limit = _mm256_sub_epi32(_mm256_set1_epi32(RUNNING_TOTAL_LIMIT), _mm256_loadu_si256((const __m256i *)(total_ + lane)));
+
+		__m256i dumb_value = zero, dumb_index = zero;
+		__m256i smart_value = zero, smart_index = zero, special_index = zero;
+
+		__m256i first_weight = _mm256_i32gather_epi32(hand_weight_[0], index, 4);
+		__m256i first_is_null = _mm256_cmpeq_epi32(first_weight, zero);
+		__m256i first_is_1 = _mm256_cmpeq_epi32(first_weight, one);
+
+		for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
+		{
+			__m256i slot = _mm256_set1_epi32(i);
+			__m256i value = _mm256_i32gather_epi32(hand_value_[i], index, 4);
+			__m256i weight = _mm256_i32gather_epi32(hand_weight_[i], index, 4);
+			__m256i over = _mm256_cmpgt_epi32(value, value_limit);
+
+			__m256i mask = _mm256_andnot_si256(over, _mm256_cmpgt_epi32(value, dumb_value));
+			dumb_value = _mm256_blendv_epi8(dumb_value, value, mask);
+			dumb_index = _mm256_blendv_epi8(dumb_index, slot, mask);
+
+			mask = _mm256_andnot_si256(over, _mm256_and_si256(_mm256_cmpeq_epi32(weight, zero), _mm256_cmpgt_epi32(value, smart_value)));
+			smart_value = _mm256_blendv_epi8(smart_value, value, mask);
+			smart_index = _mm256_blendv_epi8(smart_index, slot, mask);
+
+			mask = _mm256_or_si256(_mm256_and_si256(_mm256_cmpeq_epi32(weight, two), first_is_null),
+				_mm256_andnot_si256(first_is_1, _mm256_cmpeq_epi32(weight, one)));
+			mask = _mm256_and_si256(mask, _mm256_cmpeq_epi32(special_index, zero));
+			special_index = _mm256_blendv_epi8(special_index, slot, mask);
+		}
+
+		__m256i smart = _mm256_blendv_epi8(special_index, smart_index, _mm256_cmpgt_epi32(smart_value, zero));
+		__m256i is_dumb = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(ai_num_ + lane)), _mm256_set1_epi32(AI_DUMB));
+		__m256i choice = _mm256_blendv_epi8(smart, dumb_index, is_dumb);
+		__m256i card_index = _mm256_add_epi32(_mm256_mullo_epi32(choice, _mm256_set1_epi32(NUM_PLAYERS * LANES)), index);
+
+		_mm256_storeu_si256((__m256i *)(choice_ + lane), choice);
+		_mm256_storeu_si256((__m256i *)(card_value_ + lane), _mm256_i32gather_epi32(hand_value_[0], card_index, 4));
+	}
+
+	return lane;
+}
+
+#endif
+
+/*--------------------------------------------------------------------------*
+Name:           AddRunningTotals
+
+Description:	Add picked card to the running total of every active lane,
+				also deals special cards (see NintyNine::AddRunningTotal),
+				then detect if the player loses (see NintyNine::CheckRunningTotal).
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <int LANES>
+void BatchEngine<LANES>::AddRunningTotals(void)
+{
+	int lane = 0;
+
+#if BATCH_AVX512
+	if (simd_ >= BS_AVX512)
+		lane = AddRunningTotalsAvx512(lane);
+#endif
+
+#if BATCH_AVX2
+	if (simd_ >= BS_AVX2)
+		lane = AddRunningTotalsAvx2(lane);
+#endif
+
+	// scalar fallback (same masks as the SIMD kernels, so the compiler can vectorize it)
+
+	for (; lane < LANES; ++lane)
+	{
+		int total = total_[lane];
+		int value = card_value_[lane];
+		int active = -is_active_[lane];
+
+		int is_10 = -(value == SP_10);
+		int is_20 = -(value == SP_20);
+		int is_99 = -(value == SP_99);
+		int is_reverse = -(value == SP_REVERSE);
+		int is_special = is_10 | is_20 | is_99 | is_reverse | -(value == SP_SKIP) | -(value == SP_PICK);
+
+		int add = value & ~is_special;
+		add |= is_10 & Select(-(total > 90), -10, 10);
+		add |= is_20 & Select(-(total > 80), -20, 20);
+
+		int new_total = Select(is_99, 99, total + add);
+		new_total = Select(active, new_total, total);
+
+		int lost = active & -(new_total > RUNNING_TOTAL_LIMIT);
+		total_[lane] = Select(lost, RUNNING_TOTAL_LIMIT, new_total);
+		is_order_increase_[lane] ^= is_reverse & active & 1;
+		is_lost_[lane] = lost & 1;
+	}
+}
+
+#if BATCH_AVX512
+
+/*--------------------------------------------------------------------------*
+Name:           AddRunningTotalsAvx512
+
+Description:	AddRunningTotals kernel, 16 lanes per instruction.
+
+Arguments:      lane: First lane to be processed.
+
+Returns:        First lane not processed.
+*---------------------------------------------------------------------------*/
+template <int LANES>
+BATCH_TARGET("avx512f") int BatchEngine<LANES>::AddRunningTotalsAvx512(int lane)
+{
+	for (; lane + 16 <= LANES; lane += 16)
+	{
+		__m512i total = _mm512_loadu_si512(total_ + lane);
+		__m512i value = _mm512_loadu_si512(card_value_ + lane);
+		__mmask16 active = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(is_active_ + lane), _mm512_set1_epi32(1));
+
+		__mmask16 is_10 = _mm512_cmpeq_epi32_mask(value, _mm512_set1_epi32(SP_10));
+		__mmask16 is_20 = _mm512_cmpeq_epi32_mask(value, _mm512_set1_epi32(SP_20));
+		__mmask16 is_99 = _mm512_cmpeq_epi32_mask(value, _mm512_set1_epi32(SP_99));
+		__mmask16 is_reverse = _mm512_cmpeq_epi32_mask(value, _mm512_set1_epi32(SP_REVERSE));
+		__mmask16 is_special = is_10 | is_20 | is_99 | is_reverse
+			| _mm512_cmpeq_epi32_mask(value, _mm512_set1_epi32(SP_SKIP)) | _mm512_cmpeq_epi32_mask(value, _mm512_set1_epi32(SP_PICK));
+
+		__m512i add = _mm512_maskz_mov_epi32((__mmask16)~is_special, value);
+		__m512i add_10 = _mm512_mask_mov_epi32(_mm512_set1_epi32(10), _mm512_cmpgt_epi32_mask(total, _mm512_set1_epi32(90)), _mm512_set1_epi32(-10));
+		__m512i add_20 = _mm512_mask_mov_epi32(_mm512_set1_epi32(20), _mm512_cmpgt_epi32_mask(total, _mm512_set1_epi32(80)), _mm512_set1_epi32(-20));
+		add = _mm512_mask_mov_epi32(add, is_10, add_10);
+		add = _mm512_mask_mov_epi32(add, is_20, add_20);
+
+		__m512i new_total = _mm512_mask_mov_epi32(_mm512_add_epi32(total, add), is_99, _mm512_set1_epi32(99));
+		new_total = _mm512_mask_mov_epi32(total, active, new_total);
+
+		__mmask16 lost = active & _mm512_cmpgt_epi32_mask(new_total, _mm512_set1_epi32(RUNNING_TOTAL_LIMIT));
+		new_total = _mm512_mask_mov_epi32(new_total, lost, _mm512_set1_epi32(RUNNING_TOTAL_LIMIT));
+
+		__m512i order = _mm512_loadu_si512(is_order_increase_ + lane);
+		order = _mm512_mask_xor_epi32(order, is_reverse & active, order, _mm512_set1_epi32(1));
+
+		_mm512_storeu_si512(total_ + lane, new_total);
+		_mm512_storeu_si512(is_order_increase_ + lane, order);
+		_mm512_storeu_si512(is_lost_ + lane, _mm512_maskz_mov_epi32(lost, _mm512_set1_epi32(1)));
+	}
+
+	return lane;
+}
+
+#endif
+
+#if BATCH_AVX2
+
+/*--------------------------------------------------------------------------*
+Name:           AddRunningTotalsAvx2
+
+Description:	AddRunningTotals kernel, 8 lanes per instruction.
+
+Arguments:      lane: First lane to be processed.
+
+Returns:        First lane not processed.
+*---------------------------------------------------------------------------*/
+template <int LANES>
+BATCH_TARGET("avx2") int BatchEngine<LANES>::AddRunningTotalsAvx2(int lane)
+{
+	for (; lane + 8 <= LANES; lane += 8)
+	{
+		const __m256i one = _mm256_set1_epi32(1);
+
+		__m256i total = _mm256_loadu_si256((const __m256i *)(total_ + lane));
+		__m256i value = _mm256_loadu_si256((const __m256i *)(card_value_ + lane));
+		__m256i active = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(is_active_ + lane)), one);
+
+		__m256i is_10 = _mm256_cmpeq_epi32(value, _mm256_set1_epi32(SP_10));
+		__m256i is_20 = _mm256_cmpeq_epi32(value, _mm256_set1_epi32(SP_20));
+		__m256i is_99 = _mm256_cmpeq_epi32(value, _mm256_set1_epi32(SP_99));
+		__m256i is_reverse = _mm256_cmpeq_epi32(value, _mm256_set1_epi32(SP_REVERSE));
+		__m256i is_special = _mm256_or_si256(_mm256_or_si256(is_10, is_20), _mm256_or_si256(is_99, is_reverse));
+		is_special = _mm256_or_si256(is_special, _mm256_or_si256(_mm256_cmpeq_epi32(value, _mm256_set1_epi32(SP_SKIP)),
+			_mm256_cmpeq_epi32(value, _mm256_set1_epi32(SP_PICK))));
+
+		__m256i add_10 = _mm256_blendv_epi8(_mm256_set1_epi32(10), _mm256_set1_epi32(-10), _mm256_cmpgt_epi32(total, _mm256_set1_epi32(90)));
+		__m256i add_20 = _mm256_blendv_epi8(_mm256_set1_epi32(20), _mm256_set1_epi32(-20), _mm256_cmpgt_epi32(total, _mm256_set1_epi32(80)));
+		__m256i add = _mm256_andnot_si256(is_special, value);
+		add = _mm256_or_si256(add, _mm256_and_si256(is_10, add_10));
+		add = _mm256_or_si256(add, _mm256_and_si256(is_20, add_20));
+
+		__m256i new_total = _mm256_blendv_epi8(_mm256_add_epi32(total, add), _mm256_set1_epi32(99), is_99);
+		new_total = _mm256_blendv_epi8(total, new_total, active);
+
+		__m256i lost = _mm256_and_si256(active, _mm256_cmpgt_epi32(new_total, _mm256_set1_epi32(RUNNING_TOTAL_LIMIT)));
+		new_total = _mm256_blendv_epi8(new_total, _mm256_set1_epi32(RUNNING_TOTAL_LIMIT), lost);
+
+		__m256i order = _mm256_loadu_si256((const __m256i *)(is_order_increase_ + lane));
+		order = _mm256_xor_si256(order, _mm256_and_si256(_mm256_and_si256(is_reverse, active), one));
+
+		_mm256_storeu_si256((__m256i *)(total_ + lane), new_total);
+		_mm256_storeu_si256((__m256i *)(is_order_increase_ + lane), order);
+		_mm256_storeu_si256((__m256i *)(is_lost_ + lane), _mm256_and_si256(lost, one));
+	}
+
+	return lane;
+}
+
+#endif
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           SimulateBatch
+
+Description:	Worker thread. Play games [first_game, last_game) on a batch engine.
+
+Arguments:      ai_list: AI of each player.
+				seed: Random seed of the main engine.
+				thread_num: Index of the thread.
+				first_game: Index of the first game.
+				last_game: Index after the last game.
+				result: Stats of this thread.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void SimulateBatch(const int *ai_list, unsigned long long seed, int thread_num,
+	int first_game, int last_game, ThreadResult *result)
+{
+	BatchEngine<BATCH_LANES> engine(ai_list, seed, thread_num + 1);
+
+	engine.Run(first_game, last_game, result->result_);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           RunBatchSimulation
+
+Description:	Simulate games on batch engines. The games are split evenly
+				across threads, each thread runs its own batch engine with the
+				same AI line-up as the given engine.
+
+Arguments:      game: Initialized engine (provides AI line-up and seed).
+				settings: Simulation settings.
+				result: Merged result of all threads.
+
+Returns:        false if the line-up has a human, MCTS or external player.
+*---------------------------------------------------------------------------*/
+bool POKER::RunBatchSimulation(NintyNine &game, const SimSettings &settings, SimResult &result)
+{
+	result.num_players_ = NUM_PLAYERS;
+	result.seed_ = game.GetSeed();
+	result.confidence_ = settings.confidence_;
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+	{
+		result.ai_[i] = game.GetPlayer(i).AI_;
+		if ((result.ai_[i] == AI_PLAYER) || (result.ai_[i] >= AI_MCTS))
+			return false;
+	}
+
+	int num_games = settings.num_games_;
+	int num_threads = GetNumThreads(settings.num_threads_, num_games);
+
+	// split games across threads
+
+	std::vector<ThreadResult> results(num_threads);
+	std::vector<std::thread> threads;
+
+	int games_per_thread = num_games / num_threads;
+	int games_left = num_games % num_threads;
+	int first_game = 0;
+
+	for (int i = 0; i < num_threads; ++i)
+	{
+		int last_game = first_game + games_per_thread + ((i < games_left) ? 1 : 0);
+		threads.emplace_back(SimulateBatch, result.ai_, result.seed_, i, first_game, last_game, &results[i]);
+		first_game = last_game;
+	}
+
+	// merge results
+
+	for (int i = 0; i < num_threads; ++i)
+	{
+		threads[i].join();
+		result.Merge(results[i].result_);
+	}
+
+	return true;
+}
+
+// pre-instantiated batch engines
+
+template class POKER::BatchEngine<8>;
+template class POKER::BatchEngine<16>;
+template class POKER::BatchEngine<32>;
@@ -0,0 +1,109 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Batched lockstep engine
+// plays LANES independent games of the default rules at the same time, one turn of every game per step
+// game state is stored as structure of arrays, so card selection of dumb/smart AI and
+// running total update are done for 8 (AVX2) or 16 (AVX-512) games with one instruction
+// (the kernels are picked at run time by CPUID, a scalar loop is used if the CPU has neither)
+// a lane that finishes its game is refilled with the next game right away
+// in counter-based mode, game i plays exactly as game i of NintyNine::Play
+
+#pragma once
+
+#include "nintynine.h"
+#include "simulation.h"
+
+namespace POKER
+{
+	// number of games played in lockstep by the batch engine (8, 16 or 32)
+	static const int BATCH_LANES = 16;
+
+	// SIMD kernels of the batch engine
+	enum BATCH_SIMD
+	{
+		BS_SCALAR,
+		BS_AVX2,
+		BS_AVX512,
+	};
+
+	template <int LANES>
+	class BatchEngine
+	{
+	public:
+		NINTYNINE_RULE_PARAMETERS(DefaultRules)
+
+		static_assert((LANES % 16) == 0 || (LANES == 8), "number of lanes must be 8 or a multiple of 16");
+
+		// constructor
+		BatchEngine(const int ai_list[], unsigned long long seed, unsigned long long stream);
+
+		// play games [first_game, last_game), record stats into result
+		void Run(int first_game, int last_game, SimResult &result);
+		// SIMD kernels used
+		BATCH_SIMD GetSimd(void) const { return simd_; }
+
+	private:
+		// hands of every player of every lane: [card slot][player * LANES + lane]
+		alignas(64) int hand_value_[NUM_CARDS_PER_PLAYER][NUM_PLAYERS * LANES];
+		alignas(64) int hand_weight_[NUM_CARDS_PER_PLAYER][NUM_PLAYERS * LANES];
+
+		// per-lane game state
+		alignas(64) int total_[LANES];				// running total
+		alignas(64) int is_order_increase_[LANES];	// player order (1: increase, 0: decrease)
+		alignas(64) int player_num_[LANES];			// current player
+		alignas(64) int ai_num_[LANES];				// AI of current player
+		alignas(64) int is_active_[LANES];			// current player plays a card this turn (1 or 0)
+		alignas(64) int choice_[LANES];				// card slot picked this turn
+		alignas(64) int card_value_[LANES];			// card value picked this turn
+		alignas(64) int is_lost_[LANES];			// current player loses this turn (1 or 0)
+		int deck_index_[LANES];						// index of the current card of deck
+		int players_left_[LANES];					// number of players left
+		int defeat_mask_[LANES];					// bit i is set if player i is defeated
+		int num_rounds_[LANES];						// number of rounds
+		int num_turns_[LANES];						// number of turns
+		int game_[LANES];							// index of the game played (-1: lane is idle)
+		Cards deck_[LANES][NUM_CARDS];				// deck of each lane
+		Random rng_[LANES];							// random number generator of each lane
+
+		Cards cards_[NUM_CARDS];					// cards in the order of a new deck
+		int ai_[NUM_PLAYERS];						// AI of each player (same for all lanes)
+		unsigned long long seed_;					// random seed
+		int next_game_;								// next game to be played
+		int last_game_;								// index after the last game
+		BATCH_SIMD simd_;							// SIMD kernels used (picked at run time)
+
+		// start the next game on a lane, returns false if no more games
+		bool StartGame(int lane);
+		// finish the game on a lane, record stats
+		void FinishGame(int lane, SimResult &result);
+		// shuffle the deck of a lane
+		void Shuffle(int lane);
+		// draw a card from the deck of a lane
+		Cards DrawCard(int lane);
+		// players of a lane not defeated (active-seat ring)
+		unsigned int ActiveMask(int lane) const { return ((1u << NUM_PLAYERS) - 1) & ~(unsigned int)defeat_mask_[lane]; }
+
+		// pick a card for the current player of every lane
+		void ChooseCards(void);
+		// add picked card to running total of every lane, detect who loses
+		void AddRunningTotals(void);
+
+		// SIMD kernels of ChooseCards and AddRunningTotals, return the first lane not processed
+		int ChooseCardsAvx512(int lane);
+		int ChooseCardsAvx2(int lane);
+		int AddRunningTotalsAvx512(int lane);
+		int AddRunningTotalsAvx2(int lane);
+	};
+
+	// get the widest SIMD kernels of the batch engine this CPU can run
+	BATCH_SIMD GetBatchSimd(void);
+	// get the name of SIMD kernels
+	const char *GetBatchSimdName(BATCH_SIMD simd);
+
+	// simulate games on batch engines, using the AI line-up of the given engine
+	// (the batch engine always picks cards by scanning hands, settings.table_ is not used)
+	// returns false if the line-up has a human, MCTS or external player (not played by the batch engine)
+	bool RunBatchSimulation(NintyNine &game, const SimSettings &settings, SimResult &result);
+}
@@ -0,0 +1,439 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Microbenchmarks of the engine's hot paths (separate program, see Benchmark.vcxproj)
+// every benchmark runs a fixed number of operations per repetition from a fixed seed,
+// time per operation of each repetition is collected and reported as median and percentiles
+// results are written as JSON, so runs of different commits can be compared
+
+#include <algorithm>	// std::sort
+#include <chrono>		// std::chrono::steady_clock
+#include <cstdio>
+#include <cstdlib>		// std::atoi, std::strtoull
+#include <cstring>		// std::strcmp, std::strstr
+#include <fstream>
+#include <iomanip>		// std::setprecision
+#include <iostream>
+#include <vector>
+
+#include "decision.h"
+#include "nintynine.h"
+
+using namespace POKER;
+
+// default number of repetitions of each benchmark
+static const int BENCH_REPETITIONS	= 11;
+// default number of operations of each repetition (games and turns use fewer, see RunBenchmarks)
+static const int BENCH_OPERATIONS	= 100000;
+// default seed of all benchmarks
+static const unsigned long long BENCH_SEED = 1;
+// number of pre-generated hands played by the strategy benchmarks
+static const int BENCH_HANDS		= 1024;
+
+// keeps results of benchmarked code alive, so the compiler can't remove it
+static volatile int bench_sink = 0;
+
+// settings of a benchmark run
+struct BenchSettings
+{
+	int repetitions_;				// number of repetitions of each benchmark
+	int operations_;				// number of operations of each repetition
+	unsigned long long seed_;		// random seed
+	const char *filter_;			// only run benchmarks whose name contains this (null: all)
+};
+
+// result of a benchmark
+struct BenchResult
+{
+	const char *name_;				// benchmark name
+	const char *unit_;				// what an operation is
+	int operations_;				// number of operations of each repetition
+	std::vector<double> ns_;		// time per operation of each repetition (sorted)
+};
+
+// pre-generated hands and running totals for the strategy benchmarks
+struct BenchHands
+{
+	HandT<NUM_CARDS_PER_PLAYER> hands_[BENCH_HANDS];
+	int totals_[BENCH_HANDS];
+};
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           GetPercentile
+
+Description:	Get a percentile of sorted samples (nearest rank).
+
+Arguments:      samples: Sorted samples.
+				percent: Percentile (0 ~ 100).
+
+Returns:        Value of the percentile.
+*---------------------------------------------------------------------------*/
+static double GetPercentile(const std::vector<double> &samples, int percent)
+{
+	int index = (int)((percent * (samples.size() - 1) + 50) / 100);
+
+	return samples[index];
+}
+
+/*--------------------------------------------------------------------------*
+Name:           CreateHands
+
+Description:	Deal BENCH_HANDS hands from shuffled decks, and pick a running total for each.
+
+Arguments:      seed: Random seed.
+				hands: Hands to be filled.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void CreateHands(unsigned long long seed, BenchHands &hands)
+{
+	Cards cards[NUM_CARDS];
+	NintyNine::CreateCards(cards);
+
+	Random rng(seed);
+
+	for (int i = 0; i < BENCH_HANDS; ++i)
+	{
+		for (int j = 0; j < NUM_CARDS_PER_PLAYER; ++j)
+			hands.hands_[i][j] = cards[rng.Range(NUM_CARDS)];
+
+		hands.totals_[i] = rng.Range(RUNNING_TOTAL_LIMIT + 1);
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Measure
+
+Description:	Run a benchmark and collect time per operation of each repetition.
+
+Arguments:      name: Benchmark name.
+				unit: What an operation is.
+				settings: Benchmark settings.
+				operations: Number of operations of each repetition.
+				bench: Runs one repetition, returns number of operations done.
+				results: Result is appended to this list.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename BENCH>
+static void Measure(const char *name, const char *unit, const BenchSettings &settings, int operations,
+	BENCH bench, std::vector<BenchResult> &results)
+{
+	if ((settings.filter_ != nullptr) && (std::strstr(name, settings.filter_) == nullptr))
+		return;
+
+	BenchResult result;
+	result.name_ = name;
+	result.unit_ = unit;
+	result.operations_ = operations;
+
+	// warm up (caches, branch predictors, page faults)
+	bench(operations);
+
+	for (int i = 0; i < settings.repetitions_; ++i)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		int done = bench(operations);
+		std::chrono::steady_clock::duration time = std::chrono::steady_clock::now() - start;
+
+		result.ns_.push_back(std::chrono::duration<double, std::nano>(time).count() / done);
+	}
+
+	std::sort(result.ns_.begin(), result.ns_.end());
+	results.push_back(result);
+
+	fprintf(stderr, "%-24s %12.1f ns/%s\n", name, GetPercentile(result.ns_, 50), unit);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           RunBenchmarks
+
+Description:	Run all benchmarks.
+
+Arguments:      settings: Benchmark settings.
+				results: Results of the benchmarks.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void RunBenchmarks(const BenchSettings &settings, std::vector<BenchResult> &results)
+{
+	// mixed line-up, so full games run every strategy except human
+	int ai_list[NUM_PLAYERS];
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+		ai_list[i] = AI_SMART - (i % 3);
+
+	NintyNine game(false, settings.seed_);
+	game.Initialize(ai_list);
+
+	BenchHands hands;
+	CreateHands(settings.seed_, hands);
+
+	Cards cards[NUM_CARDS];
+	NintyNine::CreateCards(cards);
+	DecisionTable table;
+	table.Generate(cards, RUNNING_TOTAL_LIMIT);
+
+	Random rng(settings.seed_);
+
+	// engine
+
+	Measure("shuffle", "op", settings, settings.operations_, [&](int operations)
+	{
+		for (int i = 0; i < operations; ++i)
+			game.Shuffle();
+		bench_sink += game.GetDeck()[0].GetValue();
+		return operations;
+	}, results);
+
+	// dealing draws from the deck, the deck is shuffled again when it runs out (as in a game)
+	Measure("deal_cards", "op", settings, settings.operations_, [&](int operations)
+	{
+		game.Shuffle();
+		for (int i = 0; i < operations; ++i)
+			game.DealCards();
+		bench_sink += game.GetPlayer(0).hands_[0].GetValue();
+		return operations;
+	}, results);
+
+	// setup of a new game: shuffle and deal (with USE_LAZY_SHUFFLE, only the cards dealt are shuffled)
+	Measure("start_game", "game", settings, settings.operations_, [&](int operations)
+	{
+		for (int i = 0; i < operations; ++i)
+			game.StartGame();
+		bench_sink += game.GetPlayer(0).hands_[0].GetValue();
+		return operations;
+	}, results);
+
+	// turns of games played from start to end, starting a new game is included
+	Measure("player_turn", "turn", settings, settings.operations_, [&](int operations)
+	{
+		int player_num = 0;
+
+		game.SeedStream(0);
+		game.StartGame();
+		for (int i = 0; i < operations; ++i)
+		{
+			if (game.PlayerTurn(player_num))
+			{
+				game.StartGame();
+				player_num = 0;
+			}
+			else
+				player_num = game.NextPlayer(player_num);
+		}
+		bench_sink += game.GetRunningTotal();
+		return operations;
+	}, results);
+
+	Measure("play_game", "game", settings, settings.operations_ / 100, [&](int operations)
+	{
+		GameStats stats;
+		for (int i = 0; i < operations; ++i)
+		{
+			game.SeedStream(i);
+			bench_sink += game.Play(stats);
+		}
+		return operations;
+	}, results);
+
+	// strategies (a player of the engine, it holds the effect table dumb/smart AI score cards with)
+
+	Player player = game.GetPlayer(0);
+
+	Measure("play_random", "op", settings, settings.operations_, [&](int operations)
+	{
+		int sum = 0;
+		for (int i = 0; i < operations; ++i)
+		{
+			player.hands_ = hands.hands_[i % BENCH_HANDS];
+			sum += player.PlayRandom(rng);
+		}
+		bench_sink += sum;
+		return operations;
+	}, results);
+
+	Measure("play_dumb", "op", settings, settings.operations_, [&](int operations)
+	{
+		int sum = 0;
+		for (int i = 0; i < operations; ++i)
+		{
+			player.hands_ = hands.hands_[i % BENCH_HANDS];
+			sum += player.PlayerDumb(hands.totals_[i % BENCH_HANDS]);
+		}
+		bench_sink += sum;
+		return operations;
+	}, results);
+
+	Measure("play_smart", "op", settings, settings.operations_, [&](int operations)
+	{
+		int sum = 0;
+		for (int i = 0; i < operations; ++i)
+		{
+			player.hands_ = hands.hands_[i % BENCH_HANDS];
+			sum += player.PlayerSmart(hands.totals_[i % BENCH_HANDS]);
+		}
+		bench_sink += sum;
+		return operations;
+	}, results);
+
+	player.table_ = &table;
+
+	Measure("play_dumb_table", "op", settings, settings.operations_, [&](int operations)
+	{
+		int sum = 0;
+		for (int i = 0; i < operations; ++i)
+		{
+			player.hands_ = hands.hands_[i % BENCH_HANDS];
+			sum += player.PlayerDumb(hands.totals_[i % BENCH_HANDS]);
+		}
+		bench_sink += sum;
+		return operations;
+	}, results);
+
+	Measure("play_smart_table", "op", settings, settings.operations_, [&](int operations)
+	{
+		int sum = 0;
+		for (int i = 0; i < operations; ++i)
+		{
+			player.hands_ = hands.hands_[i % BENCH_HANDS];
+			sum += player.PlayerSmart(hands.totals_[i % BENCH_HANDS]);
+		}
+		bench_sink += sum;
+		return operations;
+	}, results);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           WriteJson
+
+Description:	Write results as JSON.
+
+Arguments:      out: Output stream.
+				settings: Benchmark settings.
+				results: Results of the benchmarks.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void WriteJson(std::ostream &out, const BenchSettings &settings, const std::vector<BenchResult> &results)
+{
+	out << std::fixed << std::setprecision(2);
+
+	out << "{\n";
+	out << "  \"players\": " << NUM_PLAYERS << ",\n";
+	out << "  \"cards_per_player\": " << NUM_CARDS_PER_PLAYER << ",\n";
+	out << "  \"seed\": " << settings.seed_ << ",\n";
+	out << "  \"repetitions\": " << settings.repetitions_ << ",\n";
+	out << "  \"benchmarks\": [";
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const BenchResult &result = results[i];
+		double median = GetPercentile(result.ns_, 50);
+
+		out << ((i == 0) ? "" : ",") << "\n    {";
+		out << "\"name\": \"" << result.name_ << "\", ";
+		out << "\"unit\": \"" << result.unit_ << "\", ";
+		out << "\"operations\": " << result.operations_ << ", ";
+		out << "\"ns_per_op\": {";
+		out << "\"min\": " << result.ns_.front() << ", ";
+		out << "\"p10\": " << GetPercentile(result.ns_, 10) << ", ";
+		out << "\"median\": " << median << ", ";
+		out << "\"p90\": " << GetPercentile(result.ns_, 90) << ", ";
+		out << "\"max\": " << result.ns_.back() << "}, ";
+		out << "\"ops_per_sec\": " << 1e9 / median << "}";
+	}
+
+	out << "\n  ]\n}\n";
+}
+
+/*--------------------------------------------------------------------------*
+Name:           DisplayUsage
+
+Description:    Display command line options.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void DisplayUsage(void)
+{
+	printf("Usage: Benchmark [options]\n");
+	printf("  --repetitions N  repetitions of each benchmark (default %d)\n", BENCH_REPETITIONS);
+	printf("  --operations N   operations of each repetition (default %d, games use 1/100)\n", BENCH_OPERATIONS);
+	printf("  --seed N         random seed (default %llu)\n", BENCH_SEED);
+	printf("  --filter NAME    only run benchmarks whose name contains NAME\n");
+	printf("  --out FILE       write JSON to FILE instead of standard output\n");
+}
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           main
+
+Description:    Main function of the benchmark program.
+
+Arguments:      argc: Number of arguments.
+				argv: Arguments (see DisplayUsage).
+
+Returns:        0 on success, 1 on bad arguments.
+*---------------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+	BenchSettings settings;
+	settings.repetitions_ = BENCH_REPETITIONS;
+	settings.operations_ = BENCH_OPERATIONS;
+	settings.seed_ = BENCH_SEED;
+	settings.filter_ = nullptr;
+
+	const char *out_path = nullptr;
+
+	// read command line
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if ((std::strcmp(argv[i], "--repetitions") == 0) && (i + 1 < argc))
+			settings.repetitions_ = std::atoi(argv[++i]);
+		else if ((std::strcmp(argv[i], "--operations") == 0) && (i + 1 < argc))
+			settings.operations_ = std::atoi(argv[++i]);
+		else if ((std::strcmp(argv[i], "--seed") == 0) && (i + 1 < argc))
+			settings.seed_ = std::strtoull(argv[++i], nullptr, 10);
+		else if ((std::strcmp(argv[i], "--filter") == 0) && (i + 1 < argc))
+			settings.filter_ = argv[++i];
+		else if ((std::strcmp(argv[i], "--out") == 0) && (i + 1 < argc))
+			out_path = argv[++i];
+		else
+		{
+			DisplayUsage();
+			return 1;
+		}
+	}
+
+	if ((settings.repetitions_ < 1) || (settings.operations_ < 100) || (settings.seed_ == 0))
+	{
+		DisplayUsage();
+		return 1;
+	}
+
+	std::vector<BenchResult> results;
+	RunBenchmarks(settings, results);
+
+	if (out_path == nullptr)
+	{
+		WriteJson(std::cout, settings, results);
+		return 0;
+	}
+
+	std::ofstream file(out_path);
+	if (!file)
+	{
+		printf("Can not write to %s.\n", out_path);
+		return 1;
+	}
+
+	WriteJson(file, settings, results);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Checkpoint of a simulation run
+
+#include <cstdio>		// std::fopen, std::rename
+#include <cstring>		// std::memcmp, std::memcpy, std::memset
+#include <string>
+
+#include "checkpoint.h"
+#include "simulation.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <io.h>			// _commit, _fileno
+#include <windows.h>
+#else
+#include <unistd.h>		// fsync, fileno
+#endif
+
+using namespace POKER;
+
+// file id and version of a checkpoint
+static const char CHECKPOINT_MAGIC[8] = { 'N', 'N', '9', '9', 'C', 'P', '0', '3' };
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           MakeCheckpoint
+
+Description:	Fill a checkpoint of a run.
+
+Arguments:      settings: Simulation settings.
+				result: Result of the games played so far.
+				limit: Running total limit of the engine.
+				effects_hash: Hash of the effect table of the engine.
+				num_threads: Number of threads of the run (resolved).
+				next_game: Index of the first game not played.
+				checkpoint: Receives the checkpoint.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void POKER::MakeCheckpoint(const SimSettings &settings, const SimResult &result, int limit, unsigned long long effects_hash,
+	int num_threads, int next_game, Checkpoint &checkpoint)
+{
+	// padding is cleared, so the same run always writes the same bytes
+	std::memset((void *)&checkpoint, 0, sizeof(checkpoint));
+
+	std::memcpy(checkpoint.magic_, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+	checkpoint.num_players_ = result.num_players_;
+	checkpoint.num_cards_per_player_ = settings.num_cards_per_player_;
+	checkpoint.limit_ = limit;
+	checkpoint.num_games_ = settings.num_games_;
+	checkpoint.num_threads_ = num_threads;
+	checkpoint.stop_rule_ = settings.stop_rule_;
+	checkpoint.check_games_ = settings.check_games_;
+	checkpoint.checkpoint_games_ = settings.checkpoint_games_;
+	checkpoint.confidence_ = settings.confidence_;
+	checkpoint.precision_ = settings.precision_;
+	checkpoint.is_lazy_shuffle_ = USE_LAZY_SHUFFLE ? 1 : 0;
+	checkpoint.seed_ = result.seed_;
+	checkpoint.effects_hash_ = effects_hash;
+	checkpoint.next_game_ = next_game;
+	checkpoint.stats_ = result.stats_;
+
+	for (int i = 0; i < result.num_players_; ++i)
+	{
+		checkpoint.ai_[i] = result.ai_[i];
+		checkpoint.win_player_[i] = result.win_player_[i];
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           SaveCheckpoint
+
+Description:	Write a checkpoint. It's written to path.tmp and flushed to the
+				disk, which then replaces the file at path, so the file is
+				always a complete checkpoint.
+
+Arguments:      path: Checkpoint file.
+				checkpoint: Checkpoint.
+
+Returns:        false if the file can't be written.
+*---------------------------------------------------------------------------*/
+bool POKER::SaveCheckpoint(const char *path, const Checkpoint &checkpoint)
+{
+	std::string temp_path = std::string(path) + ".tmp";
+
+	FILE *file = std::fopen(temp_path.c_str(), "wb");
+	if (file == nullptr)
+		return false;
+
+	bool is_ok = (std::fwrite(&checkpoint, sizeof(checkpoint), 1, file) == 1) && (std::fflush(file) == 0);
+#ifdef _WIN32
+	is_ok = is_ok && (_commit(_fileno(file)) == 0);
+#else
+	is_ok = is_ok && (fsync(fileno(file)) == 0);
+#endif
+	is_ok = (std::fclose(file) == 0) && is_ok;
+
+	if (!is_ok)
+	{
+		std::remove(temp_path.c_str());
+		return false;
+	}
+
+#ifdef _WIN32
+	return MoveFileExA(temp_path.c_str(), path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	return std::rename(temp_path.c_str(), path) == 0;
+#endif
+}
+
+/*--------------------------------------------------------------------------*
+Name:           LoadCheckpoint
+
+Description:	Read a checkpoint.
+
+Arguments:      path: Checkpoint file.
+				checkpoint: Receives the checkpoint.
+
+Returns:        false if the file is missing or not a checkpoint.
+*---------------------------------------------------------------------------*/
+bool POKER::LoadCheckpoint(const char *path, Checkpoint &checkpoint)
+{
+	FILE *file = std::fopen(path, "rb");
+	if (file == nullptr)
+		return false;
+
+	bool is_ok = (std::fread(&checkpoint, sizeof(checkpoint), 1, file) == 1) && (std::fgetc(file) == EOF);
+	std::fclose(file);
+
+	return is_ok && (std::memcmp(checkpoint.magic_, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) == 0) &&
+		(checkpoint.num_players_ >= 2) && (checkpoint.num_players_ <= MAX_PLAYERS) &&
+		(checkpoint.next_game_ >= 0) && (checkpoint.next_game_ <= checkpoint.num_games_);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetCheckpointSettings
+
+Description:	Set the settings of the run of a checkpoint. Files, decision
+				table and trace of the settings are kept.
+
+Arguments:      checkpoint: Checkpoint.
+				settings: Receives the settings.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void POKER::GetCheckpointSettings(const Checkpoint &checkpoint, SimSettings &settings)
+{
+	settings.num_players_ = checkpoint.num_players_;
+	settings.num_cards_per_player_ = checkpoint.num_cards_per_player_;
+	settings.num_games_ = checkpoint.num_games_;
+	settings.num_threads_ = checkpoint.num_threads_;
+	settings.stop_rule_ = checkpoint.stop_rule_;
+	settings.check_games_ = checkpoint.check_games_;
+	settings.checkpoint_games_ = checkpoint.checkpoint_games_;
+	settings.confidence_ = checkpoint.confidence_;
+	settings.precision_ = checkpoint.precision_;
+	settings.seed_ = checkpoint.seed_;
+	settings.resume_ = &checkpoint;
+}
\ No newline at end of file
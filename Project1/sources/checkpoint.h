@@ -0,0 +1,56 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Checkpoint of a simulation run
+// in counter-based mode a game only depends on (seed, game index), so a run is fully described by its settings,
+// the index of the next game and the stats accumulated so far
+// checkpoints are taken between chunks of games, and a resumed run plays the same chunks on the same
+// number of threads, so stats are merged in the same order and the result is bit for bit the same
+// a checkpoint is written to a temporary file which then replaces the previous checkpoint,
+// so a run killed at any time leaves either the old or the new checkpoint
+
+#pragma once
+
+#include "nintynine.h"
+
+namespace POKER
+{
+	struct SimResult;
+	struct SimSettings;
+
+	// checkpoint file: settings of the run and its result so far
+	struct Checkpoint
+	{
+		char magic_[8];						// file id and version
+		// settings of the run
+		int num_players_;					// number of players
+		int num_cards_per_player_;			// number of cards each player has
+		int limit_;							// running total limit
+		int num_games_;						// number of games to be played
+		int num_threads_;					// number of threads (resolved, merge order depends on it)
+		int stop_rule_;						// early stopping rules
+		int check_games_;					// number of games between checks of stop_rule_
+		int checkpoint_games_;				// number of games between checkpoints
+		double confidence_;					// confidence level of intervals
+		double precision_;					// target precision of STOP_PRECISION
+		int is_lazy_shuffle_;				// deck shuffled lazily (USE_LAZY_SHUFFLE), deals depend on it
+		int ai_[MAX_PLAYERS];				// AI of each player
+		unsigned long long seed_;			// random seed of the engine
+		unsigned long long effects_hash_;	// hash of the effect table played (see EffectTable::GetHash)
+		// result so far
+		int next_game_;						// index of the first game not played
+		int win_player_[MAX_PLAYERS];		// number of wins of each player
+		GameStats stats_;					// game stats
+	};
+
+	// fill a checkpoint of a run, next_game is the first game not played
+	void MakeCheckpoint(const SimSettings &settings, const SimResult &result, int limit, unsigned long long effects_hash,
+		int num_threads, int next_game, Checkpoint &checkpoint);
+	// write a checkpoint, replacing the file at path at once, returns false if it can't be written
+	bool SaveCheckpoint(const char *path, const Checkpoint &checkpoint);
+	// read a checkpoint, returns false if the file is missing or not a checkpoint
+	bool LoadCheckpoint(const char *path, Checkpoint &checkpoint);
+	// settings of the run of a checkpoint (files, table and trace of settings are kept)
+	void GetCheckpointSettings(const Checkpoint &checkpoint, SimSettings &settings);
+}
@@ -0,0 +1,234 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Precomputed decisions of dumb and smart AI
+
+#include <cstring>		// std::memcmp, std::memcpy
+#include <fstream>
+
+#include "decision.h"
+#include "effects.h"
+
+using namespace POKER;
+
+// file id and version of a table file
+static const char TABLE_MAGIC[8] = { 'N', 'N', '9', '9', 'D', 'T', '0', '1' };
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           DecisionTable
+
+Description:	Constructor. The table is empty until Generate() or Load().
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+DecisionTable::DecisionTable()
+	: entries_(nullptr)
+{
+	std::memset(&header_, 0, sizeof(header_));
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Generate
+
+Description:	Build the table. For every running total and value set of a hand:
+				dumb AI plays the highest value not exceeding the limit,
+				smart AI plays the highest normal (weight 0) value not exceeding the limit,
+				0 means no such card (dumb AI plays the first card, smart AI picks a special card).
+
+Arguments:      cards: NUM_CARDS cards in the order of a new deck (see CreateCards).
+				limit: Running total limit.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void DecisionTable::Generate(const Cards cards[], int limit)
+{
+	file_.Close();
+
+	std::memcpy(header_.magic_, TABLE_MAGIC, sizeof(TABLE_MAGIC));
+	header_.limit_ = limit;
+	header_.num_values_ = NUM_VALUES;
+	std::memset(header_.weights_, 0, sizeof(header_.weights_));
+	for (int i = 0; i < NUM_VALUES; ++i)
+		header_.weights_[i] = (unsigned char)cards[i].GetWeight();
+
+	storage_.assign((limit + 1) * NUM_SIGNATURES, 0);
+
+	for (int total = 0; total <= limit; ++total)
+	{
+		for (int signature = 0; signature < NUM_SIGNATURES; ++signature)
+		{
+			int dumb = 0;
+			int smart = 0;
+
+			for (int value = 1; value <= NUM_VALUES; ++value)
+			{
+				if (((signature & (1 << (value - 1))) == 0) || (total + value > limit))
+					continue;
+
+				dumb = value;
+				if (header_.weights_[value - 1] == SP_NULL_WEIGHT)
+					smart = value;
+			}
+
+			storage_[total * NUM_SIGNATURES + signature] = (unsigned char)(dumb | (smart << 4));
+		}
+	}
+
+	entries_ = &storage_[0];
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Write
+
+Description:	Write the table to a file (header followed by entries).
+
+Arguments:      path: Path of the file.
+
+Returns:        false if there's no table or the file can't be written.
+*---------------------------------------------------------------------------*/
+bool DecisionTable::Write(const char *path) const
+{
+	if (entries_ == nullptr)
+		return false;
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+		return false;
+
+	file.write((const char *)&header_, sizeof(header_));
+	file.write((const char *)entries_, (header_.limit_ + 1) * NUM_SIGNATURES);
+
+	return file.good();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Load
+
+Description:	Memory-map a table file. Entries are used in place, nothing is copied.
+
+Arguments:      path: Path of the file.
+
+Returns:        false if the file is missing, has a different id or version,
+				or its size does not match the header.
+*---------------------------------------------------------------------------*/
+bool DecisionTable::Load(const char *path)
+{
+	entries_ = nullptr;
+	storage_.clear();
+
+	if (!file_.Open(path))
+		return false;
+
+	const unsigned char *data = file_.GetData();
+	size_t size = file_.GetSize();
+
+	Header header;
+	if (size < sizeof(header))
+	{
+		file_.Close();
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(header));
+
+	if ((std::memcmp(header.magic_, TABLE_MAGIC, sizeof(TABLE_MAGIC)) != 0) || (header.num_values_ != NUM_VALUES) ||
+		(size != sizeof(header) + (size_t)(header.limit_ + 1) * NUM_SIGNATURES))
+	{
+		file_.Close();
+		return false;
+	}
+
+	header_ = header;
+	entries_ = data + sizeof(header);
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           IsCompatible
+
+Description:	Check if the table is built for the same weights and running total limit.
+
+Arguments:      cards: NUM_CARDS cards in the order of a new deck (see CreateCards).
+				limit: Running total limit.
+
+Returns:        true if the table can be used.
+*---------------------------------------------------------------------------*/
+bool DecisionTable::IsCompatible(const Cards cards[], int limit) const
+{
+	if ((entries_ == nullptr) || (header_.limit_ != (unsigned int)limit))
+		return false;
+
+	for (int i = 0; i < NUM_CARDS; ++i)
+	{
+		if (header_.weights_[cards[i].GetValue() - 1] != cards[i].GetWeight())
+			return false;
+	}
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Verify
+
+Description:	Compare the table with PlayerDumb and PlayerSmart of the default rules.
+				Every ordered hand of face values is played at every running total.
+
+Arguments:      None.
+
+Returns:        Number of (hand, running total, AI) that pick a different card.
+*---------------------------------------------------------------------------*/
+int DecisionTable::Verify(void) const
+{
+	Cards cards[NUM_CARDS];
+	NintyNine::CreateCards(cards);
+
+	if (!IsCompatible(cards, RUNNING_TOTAL_LIMIT))
+		return -1;
+
+	// card of each face value (suit does not matter)
+	Cards value_cards[NUM_VALUES + 1];
+	for (int i = 0; i < NUM_CARDS; ++i)
+		value_cards[cards[i].GetValue()] = cards[i];
+
+	// dumb/smart AI score their cards with the special cards of the default rules
+	CardEffects card_effects;
+	card_effects.SetSpecials(SP_10, SP_20, SP_99, SP_REVERSE, SP_SKIP, SP_PICK, RUNNING_TOTAL_LIMIT);
+	EffectTable effects(card_effects, RUNNING_TOTAL_LIMIT);
+
+	Player player;
+	player.effects_ = &effects;
+	int values[NUM_CARDS_PER_PLAYER];
+	for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
+		values[i] = 1;
+
+	int mismatches = 0;
+
+	for (;;)
+	{
+		for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
+			player.hands_[i] = value_cards[values[i]];
+
+		for (int total = 0; total <= RUNNING_TOTAL_LIMIT; ++total)
+		{
+			if (player.PlayerDumb(total) != PlayDumb(total, player.hands_.cards_, NUM_CARDS_PER_PLAYER))
+				++mismatches;
+			if (player.PlayerSmart(total) != PlaySmart(total, player.hands_.cards_, NUM_CARDS_PER_PLAYER))
+				++mismatches;
+		}
+
+		// next hand (count in base NUM_VALUES)
+		int i = 0;
+		while ((i < NUM_CARDS_PER_PLAYER) && (values[i] == NUM_VALUES))
+			values[i++] = 1;
+		if (i == NUM_CARDS_PER_PLAYER)
+			break;
+		++values[i];
+	}
+
+	return mismatches;
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Precomputed decisions of dumb and smart AI
+// both AI only care about the running total and which face values are on hand
+// (a face value always has the same weight, and the first card of the best value is played)
+// so the choice is looked up by (running total, value set of the hand) instead of comparing cards
+// the table is generated once, written to a binary file and memory-mapped when loaded
+// it depends on running total limit and card weights, not on number of players or cards per player
+
+#pragma once
+
+#include <vector>
+
+#include "mapfile.h"
+#include "nintynine.h"
+
+namespace POKER
+{
+	class DecisionTable
+	{
+	public:
+		// number of hand signatures (one bit per face value)
+		static const int NUM_SIGNATURES = 1 << NUM_VALUES;
+
+		// constructor
+		DecisionTable();
+
+		// build the table for a deck of cards (weights of face values) and running total limit
+		void Generate(const Cards cards[], int limit);
+		// write the table to a file, returns false on error
+		bool Write(const char *path) const;
+		// memory-map a table file, returns false if the file is missing or not a valid table
+		bool Load(const char *path);
+
+		// check if the table is built for the same weights and running total limit
+		bool IsCompatible(const Cards cards[], int limit) const;
+		// compare the table with dumb and smart AI of the default rules on every hand and running total
+		// returns number of mismatches
+		int Verify(void) const;
+
+		// (AI 2) index of the card picked by dumb AI
+		int PlayDumb(int total, const Cards hands[], int num_cards) const
+		{
+			int value = GetEntry(total, hands, num_cards) & 0x0F;
+
+			return FindValue(value, hands, num_cards);
+		}
+
+		// (AI 3) index of the card picked by smart AI
+		int PlaySmart(int total, const Cards hands[], int num_cards) const
+		{
+			int value = GetEntry(total, hands, num_cards) >> 4;
+
+			if (value != 0)
+				return FindValue(value, hands, num_cards);
+
+			// no normal card can be dealt, pick a special card (same order as PlayerSmart)
+			int weight = hands[0].GetWeight();
+			for (int i = 1; i < num_cards; ++i)
+			{
+				int w = hands[i].GetWeight();
+				if (((w == 2) && (weight == 0)) || ((w == 1) && (weight != 1)))
+					return i;
+			}
+
+			return 0;
+		}
+
+	private:
+		// file header
+		struct Header
+		{
+			char magic_[8];						// file id and version
+			unsigned int limit_;				// running total limit
+			unsigned int num_values_;			// number of face values
+			unsigned char weights_[16];			// weight of each face value (index 0 is face value 1)
+		};
+
+		Header header_;							// header of the table
+		const unsigned char *entries_;			// [total][signature]: low 4 bits dumb, high 4 bits smart
+		std::vector<unsigned char> storage_;	// entries of a generated table
+		MappedFile file_;						// entries of a loaded table
+
+		// table entry of a hand
+		unsigned char GetEntry(int total, const Cards hands[], int num_cards) const
+		{
+			int signature = 0;
+			for (int i = 0; i < num_cards; ++i)
+				signature |= 1 << (hands[i].GetValue() - 1);
+
+			return entries_[total * NUM_SIGNATURES + signature];
+		}
+
+		// index of the first card of a face value (0 if not found)
+		static int FindValue(int value, const Cards hands[], int num_cards)
+		{
+			for (int i = 0; i < num_cards; ++i)
+			{
+				if (hands[i].GetValue() == value)
+					return i;
+			}
+
+			return 0;
+		}
+
+		// not copyable, entries_ may point into its own storage
+		DecisionTable(const DecisionTable &);
+		DecisionTable &operator=(const DecisionTable &);
+	};
+}
@@ -6,58 +6,1095 @@
 // by tweaking the setting in nintynine.h, player can choose to play against AI
 // or let AI simulate and grab data
 
+#include <cstdio>
+#include <cstdlib>		// std::atoi, std::atof, std::strtoull
+#include <cstring>		// std::strcmp
+#include <fstream>
+#include <string>
+
+#include "batch.h"
+#include "checkpoint.h"
+#include "decision.h"
+#include "duplicate.h"
+#include "effects.h"
+#include "export.h"
+#include "gamelog.h"
 #include "nintynine.h"
+#include "server.h"
+#include "simulation.h"
+#include "solver.h"
+#include "strategy.h"
+#include "sweep.h"
+#include "tournament.h"
+#include "trace.h"
+#include "tuner.h"
 
 using namespace POKER;
 
 /*--------------------------------------------------------------------------*
-Name:           main
+Name:           DisplayUsage
 
-Description:    Main function.
+Description:    Display command line options.
 
 Arguments:      None.
 
-Returns:        0.
+Returns:        None.
 *---------------------------------------------------------------------------*/
-int main(void)
+static void DisplayUsage(void)
 {
-	// store stats from simulations
-	GameStats stats;
-	NintyNine game(DISPLAY_GAME);
+	printf("Usage: Project1 [options]\n");
+	printf("  --players N    number of players (default %d)\n", NUM_PLAYERS);
+	printf("  --cards N      number of cards per player (default %d)\n", NUM_CARDS_PER_PLAYER);
+	printf("  --batch        play %d games in lockstep on each thread (default rules only)\n", BATCH_LANES);
+	printf("  --table FILE   dumb/smart AI look up choices in a decision table file (created if missing)\n");
+	printf("  --make-table FILE    write the decision table to a file and exit\n");
+	printf("  --verify-table FILE  check a decision table file against dumb/smart AI and exit\n");
+	printf("  --solve N      solve a position sampled from each of N games, compare AI with the solver\n");
+	printf("  --log FILE     record every game into a binary game log\n");
+	printf("  --effects FILE play the games with the card effects of a file (see effects.h),\n");
+	printf("                 in every mode but --batch, --sweep and --tune, not with --table\n");
+	printf("  --checkpoint FILE  save the stats every --checkpoint-games games, so the run can be resumed\n");
+	printf("  --checkpoint-games N  games between checkpoints (default %d)\n", CHECKPOINT_GAMES);
+	printf("  --resume FILE  continue the run of a checkpoint (with its settings, give the same --effects),\n");
+	printf("                 keep saving checkpoints to FILE (not with --log or --export)\n");
+	printf("  --export FILE  write the result of every game (winner, rounds, turns, AI and elimination order of each seat)\n");
+	printf("                 in binary column blocks (see export.h), or as CSV if FILE ends in .csv\n");
+	printf("  --trace FILE   write the events of sampled games into a text trace (written by a background thread)\n");
+	printf("  --trace-every N  trace 1 in N games (default %d)\n", TRACE_DEFAULT_EVERY);
+	printf("  --trace-level N  events traced: 1 winners, 2 eliminations, 3 cards dealt and effects, 4 hands (default %d)\n",
+		TRACE_DEFAULT_LEVEL);
+	printf("  --replay FILE  replay the games of a game log (give the --effects the games were played with)\n");
+	printf("  --game N       with --replay, only replay game N and display it\n");
+	printf("  --min-picks N  with --replay, only replay games with at least N cards dealt\n");
+	printf("  --tournament N play every line-up of --ais in every seat rotation, N games per rotation\n");
+	printf("  --ais LIST     AI taking part in the tournament, letters r (random), d (dumb), s (smart), m (MCTS),\n");
+	printf("                 1~%d (loaded strategies) (default rds)\n", MAX_STRATEGIES);
+	printf("  --duplicate    replay every deal with the line-up rotated through every seat (--games is the game budget)\n");
+	printf("  --antithetic   also play every deal with the antithetic shuffle (with or without --duplicate)\n");
+	printf("  --paired       with --duplicate or --antithetic, show paired estimates of win rate differences\n");
+	printf("  --lineup LIST  line-up of --duplicate and --antithetic, r/d/s/m/1~%d for each seat, repeated to fill all seats\n", MAX_STRATEGIES);
+	printf("                 (AI of seats 1~ with --server)\n");
+	printf("  --server PORT  serve human-vs-AI games on 127.0.0.1:PORT, a line protocol (see server.h)\n");
+	printf("  --strategy FILE  load a strategy from a shared library (see strategy.h), the first one loaded is AI 1\n");
+	printf("  --sweep GRID   play every rule/parameter point of a grid file, write a CSV row per point\n");
+	printf("  --tune N       tune special card priorities and thresholds of the smart AI for N generations\n");
+	printf("  --population N candidates per generation of --tune (default %d)\n", TUNE_POPULATION);
+	printf("  --opponents LIST  opponents of --tune, r/d/s for each seat, repeated to fill all seats (default s)\n");
+	printf("  --out FILE     output file of --sweep (default sweep.csv) or convergence log of --tune (default tune.csv)\n");
+	printf("  --threads N    number of threads (default %d, 0: all hardware threads)\n", NUM_THREADS);
+	printf("  --seed N       random seed, printed with the results to reproduce a run (default %llu, 0: seed from current time)\n",
+		RANDOM_SEED);
+	printf("  --games N      number of games (default %d, upper limit with --stop; per candidate of --tune, default %d)\n",
+		NUM_GAMES, TUNE_GAMES);
+	printf("  --stop RULE    stop once precision is met, a player is better than all others, or either\n");
+	printf("                 (RULE: precision, better, any; checked every %d games)\n", STOP_CHECK_GAMES);
+	printf("  --confidence P confidence level of intervals (default %.2f)\n", STOP_CONFIDENCE);
+	printf("  --precision W  half-width of win rate intervals for --stop precision (default %.3f)\n", STOP_PRECISION_TARGET);
+	printf("Compiled configurations (players, cards):");
+#define NINTYNINE_DISPLAY(players, cards) printf(" (%d, %d)", players, cards);
+	NINTYNINE_CONFIGS(NINTYNINE_DISPLAY)
+#undef NINTYNINE_DISPLAY
+	printf("\n");
+}
 
-	// initialize
-	game.Initialize();
+/*--------------------------------------------------------------------------*
+Name:           DisplayResult
 
-	// play games
-	int win_player[NUM_PLAYERS] = { 0 };
-	{
-		for (int i = 0; i < NUM_GAMES; ++i)
-		{
-			int winner = game.Play(stats);
-			++stats.num_games_;
-			++win_player[winner];
-		}
-	}
+Description:    Display result of a simulation.
 
-	// display result
-	printf("\n\nNumber of games: %d\n\n", stats.num_games_);
+Arguments:      result: Simulation result.
 
-	printf("Average number of rounds: %.2f\n", (float)stats.num_rounds_ / (float)stats.num_games_);
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void DisplayResult(const SimResult &result)
+{
+	const GameStats &stats = result.stats_;
+
+	printf("\n\nNumber of games: %d\n", stats.num_games_);
+	printf("Random seed: %llu\n\n", result.seed_);
+
+	double z = GetZScore(result.confidence_);
+
+	if (result.stop_rule_ == STOP_PRECISION)
+		printf("Stopped early: intervals are within the target precision.\n\n");
+	else if (result.stop_rule_ == STOP_BETTER)
+		printf("Stopped early: player %d wins more often than all other players.\n\n", result.best_player_);
+
+	printf("Average number of rounds: %.2f (+/- %.2f at %.0f%%)\n", (double)stats.num_rounds_ / (double)stats.num_games_,
+		stats.rounds_.GetHalfWidth(z), 100.0 * result.confidence_);
 	printf("Highest number of rounds: %d\n", stats.highest_rounds_);
 	printf("Lowest number of rounds: %d\n", stats.lowest_rounds_);
 	printf("Times that exceed %d rounds: %d\n\n", NUM_ROUNDS_LIMIT, stats.exceed_limit_rounds_);
 
-	printf("Average number of turns: %.2f\n", (float)stats.num_turns_ / (float)stats.num_games_);
+	printf("Average number of turns: %.2f (+/- %.2f at %.0f%%)\n", (double)stats.num_turns_ / (double)stats.num_games_,
+		stats.turns_.GetHalfWidth(z), 100.0 * result.confidence_);
 	printf("Highest number of turns: %d\n", stats.highest_turns_);
 	printf("Lowest number of turns: %d\n", stats.lowest_turns_);
-	printf("Times that exceed %d turns: %d\n\n", NUM_TURNS_LIMIT, stats.exceed_limit_turns_);
+	printf("Times that exceed %d turns: %d\n\n", NUM_ROUNDS_LIMIT * result.num_players_, stats.exceed_limit_turns_);
+
+	for (int i = 0; i < result.num_players_; ++i)
+	{
+		double low, high;
+		GetWilsonInterval(result.win_player_[i], stats.num_games_, z, low, high);
+
+		printf("Player %d (%s) won %d times (%.2f%%, %.2f%% ~ %.2f%%).\n", i, DisplayAI(result.ai_[i]), result.win_player_[i],
+			100.0 * result.win_player_[i] / stats.num_games_, 100.0 * low, 100.0 * high);
+	}
+
+#if NINTYNINE_PROFILE
+	result.profile_.Display();
+#endif
+}
+
+/*--------------------------------------------------------------------------*
+Name:           DisplayReplayReport
+
+Description:    Display result of a replay.
+
+Arguments:      report: Replay report.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void DisplayReplayReport(const ReplayReport &report)
+{
+	printf("\n\nNumber of records: %d\n", report.num_records_);
+	printf("Records that do not match their game: %d\n", report.num_errors_);
+	if (report.is_truncated_)
+		printf("Log is truncated or broken after the last record.\n");
+
+	if (report.result_.stats_.num_games_ > 0)
+		DisplayResult(report.result_);
+	else
+		printf("No game matches the filter.\n");
+}
+
+/*--------------------------------------------------------------------------*
+Name:           DisplayTournament
+
+Description:    Display result of a tournament: win rate of each AI in each line-up,
+				win rate of each AI in each seat, and the matchup matrix.
+				Win rates are per seat, so a fair game gives every AI 1 / number of players.
+
+Arguments:      result: Tournament result.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void DisplayTournament(const TournamentResult &result)
+{
+	int num_players = result.num_players_;
+	int num_rotations = (int)result.results_.size();
+
+	printf("\n\nTournament: %d line-ups, %d seat rotations, %d games per rotation (%d players)\n", result.num_lineups_,
+		num_rotations, (num_rotations > 0) ? result.results_[0].stats_.num_games_ : 0, num_players);
+	printf("Random seed: %llu\n", result.seed_);
+	printf("%d jobs on %d threads, %d jobs stolen\n\n", result.num_jobs_, result.num_threads_, result.num_steals_);
+
+	// [ai][seat]: games played and won by AI in the seat
+	int seat_games[NUM_AI][MAX_PLAYERS] = {};
+	int seat_wins[NUM_AI][MAX_PLAYERS] = {};
+	// [ai][other ai]: games won by ai / other ai among games with both of them
+	int matchup_wins[NUM_AI][NUM_AI] = {};
+
+	printf("Win rate of each AI in each line-up (fair: %.1f%%)\n", 100.0 / num_players);
+
+	for (int first = 0; first < num_rotations; )
+	{
+		// seat rotations of a line-up are next to each other
+		int last = first;
+		int games = 0;
+		int lineup_games[NUM_AI] = {};
+		int lineup_wins[NUM_AI] = {};
+
+		for (; (last < num_rotations) && (result.lineup_[last] == result.lineup_[first]); ++last)
+		{
+			const SimResult &rotation = result.results_[last];
+			games += rotation.stats_.num_games_;
+
+			bool has_ai[NUM_AI] = {};
+			int ai_wins[NUM_AI] = {};
+
+			for (int i = 0; i < num_players; ++i)
+			{
+				int ai = rotation.ai_[i];
+				has_ai[ai] = true;
+				ai_wins[ai] += rotation.win_player_[i];
+				lineup_games[ai] += rotation.stats_.num_games_;
+				lineup_wins[ai] += rotation.win_player_[i];
+				seat_games[ai][i] += rotation.stats_.num_games_;
+				seat_wins[ai][i] += rotation.win_player_[i];
+			}
+
+			for (int a = AI_RANDOM; a < NUM_AI; ++a)
+			{
+				for (int b = AI_RANDOM; b < NUM_AI; ++b)
+				{
+					if ((a != b) && has_ai[a] && has_ai[b])
+						matchup_wins[a][b] += ai_wins[a];
+				}
+			}
+		}
+
+		for (int i = 0; i < num_players; ++i)
+			printf("%-7s", DisplayAI(result.results_[first].ai_[i]));
+		printf("  %8d games:", games);
+
+		for (int ai = AI_RANDOM; ai < NUM_AI; ++ai)
+		{
+			if (lineup_games[ai] > 0)
+				printf("  %s %5.1f%%", DisplayAI(ai), 100.0 * lineup_wins[ai] / lineup_games[ai]);
+		}
+		printf("\n");
+
+		first = last;
+	}
+
+	// per-seat breakdown
+
+	printf("\nWin rate of each AI in each seat\n       ");
+	for (int i = 0; i < num_players; ++i)
+		printf("  Seat %d", i);
+	printf("\n");
+
+	for (int ai = AI_RANDOM; ai < NUM_AI; ++ai)
+	{
+		if (seat_games[ai][0] == 0)
+			continue;
+
+		printf("%-7s", DisplayAI(ai));
+		for (int i = 0; i < num_players; ++i)
+			printf("  %5.1f%%", 100.0 * seat_wins[ai][i] / seat_games[ai][i]);
+		printf("\n");
+	}
+
+	// matchup matrix
+
+	printf("\nMatchups: share of games won by the row AI, among games with both AI won by one of them\n       ");
+	for (int b = AI_RANDOM; b < NUM_AI; ++b)
+	{
+		if (seat_games[b][0] > 0)
+			printf("  %-7s", DisplayAI(b));
+	}
+	printf("\n");
+
+	for (int a = AI_RANDOM; a < NUM_AI; ++a)
+	{
+		if (seat_games[a][0] == 0)
+			continue;
+
+		printf("%-7s", DisplayAI(a));
+		for (int b = AI_RANDOM; b < NUM_AI; ++b)
+		{
+			if (seat_games[b][0] == 0)
+				continue;
+
+			int games = matchup_wins[a][b] + matchup_wins[b][a];
+			if ((a == b) || (games == 0))
+				printf("  %-7s", "-");
+			else
+				printf("  %5.1f%% ", 100.0 * matchup_wins[a][b] / games);
+		}
+		printf("\n");
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           DisplaySolverReport
+
+Description:    Display how often each AI deals a winning card.
+
+Arguments:      report: Solver report.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void DisplaySolverReport(const SolverReport &report)
+{
+	int num_positions = 0;
+	for (int i = 0; i < NUM_AI; ++i)
+		num_positions += report.ai_[i].num_positions_;
+
+	printf("\n\nNumber of positions: %d (%d players)\n", num_positions, report.num_players_);
+	printf("Random seed: %llu\n", report.seed_);
+	printf("Searched %lld positions in %.2f seconds (%.0f sampled positions per second)\n",
+		report.num_nodes_, report.seconds_, (report.seconds_ > 0.0) ? num_positions / report.seconds_ : 0.0);
+	printf("(unknown: not resolved within %d turns or %d searched positions)\n\n", SOLVER_DEPTH, SOLVER_NODES);
+
+	for (int i = AI_RANDOM; i < NUM_AI; ++i)
+	{
+		const SolverStats &stats = report.ai_[i];
+		if (stats.num_positions_ == 0)
+			continue;
+
+		printf("%s: %d positions\n", DisplayAI(i), stats.num_positions_);
+		printf("  can win: %d, dealt a winning card: %d (%.1f%%)\n", stats.num_win_, stats.num_match_win_,
+			(stats.num_win_ > 0) ? 100.0f * stats.num_match_win_ / stats.num_win_ : 0.0f);
+		printf("  lost whatever dealt: %d, unknown: %d\n", stats.num_lose_, stats.num_unknown_);
+		printf("  dealt a card with the best outcome: %d (%.1f%%)\n", stats.num_match_best_,
+			100.0f * stats.num_match_best_ / stats.num_positions_);
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           DisplayDuplicate
+
+Description:    Display win rates of duplicate play, with the interval of as many
+				independent games and the effective sample size gain
+				(the games independent play needs for the same interval, per game played).
+
+Arguments:      result: Result of duplicate play.
+				is_paired: Show paired estimates of win rate differences.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void DisplayDuplicate(const DuplicateResult &result, bool is_paired)
+{
+	const GameStats &stats = result.stats_;
+	int num_players = result.num_players_;
+
+	printf("\n\nDuplicate: %lld deals, %d games per deal, %d games (%d players) on %d threads\n",
+		result.share_[0].count_, result.games_per_deal_, stats.num_games_, num_players, result.num_threads_);
+	printf("Random seed: %llu\n", result.seed_);
+	printf("Average: %.2f rounds, %.2f turns per game\n", stats.rounds_.mean_, stats.turns_.mean_);
+	printf("Intervals at %.0f%% confidence, players are players of the line-up (each seat in turn)\n\n",
+		100.0 * result.confidence_);
+
+	printf("Player  AI      win rate            independent games    ESS gain\n");
+	for (int i = 0; i < num_players; ++i)
+	{
+		double duplicate, independent;
+		result.GetRateHalfWidth(i, duplicate, independent);
+
+		printf("%6d  %-6s  %6.2f%% +/- %5.2f%%  +/- %5.2f%%", i, DisplayAI(result.ai_[i]),
+			100.0 * result.share_[i].mean_, 100.0 * duplicate, 100.0 * independent);
+		if (duplicate > 0.0)
+			printf("          %8.2f\n", (independent * independent) / (duplicate * duplicate));
+		else
+			printf("          %8s\n", "-");
+	}
+
+	if (!is_paired)
+		return;
+
+	printf("\nPaired differences (row player minus column player)\n");
+	printf("Pair    difference          independent games    ESS gain\n");
+	for (int a = 0; a < num_players; ++a)
+	{
+		for (int b = a + 1; b < num_players; ++b)
+		{
+			double paired, independent;
+			result.GetDiffHalfWidth(a, b, paired, independent);
+
+			printf("%d - %d   %+6.2f%% +/- %5.2f%%  +/- %5.2f%%", a, b, 100.0 * result.diff_[a][b].mean_,
+				100.0 * paired, 100.0 * independent);
+			if (paired > 0.0)
+				printf("          %8.2f\n", (independent * independent) / (paired * paired));
+			else
+				printf("          %8s\n", "-");
+		}
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           DisplayTuneResult
+
+Description:    Display the tuned genome against the default weights.
+
+Arguments:      result: Result of the tuner.
+				num_players: Number of players.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void DisplayTuneResult(const TuneResult &result, int num_players)
+{
+	static const char *names[AB_NUMBER] = { "+/-10", "+/-20", "99", "Reverse", "Skip", "Pick" };
+	SmartTuning default_tuning;
+
+	printf("\n\nTuner: %lld candidates, %lld games in %.2f seconds (%.0f candidates per minute) on %d threads\n",
+		result.num_candidates_, result.num_games_, result.seconds_,
+		(result.seconds_ > 0.0) ? 60.0 * result.num_candidates_ / result.seconds_ : 0.0, result.num_threads_);
+	printf("Random seed: %llu\n\n", result.seed_);
+
+	printf("Generation  best    mean    elite\n");
+	for (size_t i = 0; i < result.log_.size(); ++i)
+	{
+		const TuneGeneration &row = result.log_[i];
+		printf("%10d  %5.1f%%  %5.1f%%  %5.1f%%\n", (int)i, 100.0 * row.best_, 100.0 * row.mean_, 100.0 * row.elite_);
+	}
+
+	printf("\nAbility   priority (default)  threshold (default, -1: never early)\n");
+	for (int i = 0; i < AB_NUMBER; ++i)
+	{
+		printf("%-8s  %8.2f (%7.2f)  %9d (%d)\n", names[i], result.best_.priority_[i], default_tuning.priority_[i],
+			result.best_.threshold_[i], default_tuning.threshold_[i]);
+	}
+
+	printf("\nWin rate on check games (fair: %.1f%%): tuned %.2f%%, default %.2f%%\n", 100.0 / num_players,
+		100.0 * result.best_rate_, 100.0 * result.default_rate_);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           LoadTable
+
+Description:    Memory-map a decision table file, generate and write it first if it's missing.
+
+Arguments:      table: Decision table to be loaded.
+				path: Path of the table file.
+				is_create: Write a new table even if the file exists.
+
+Returns:        false if the file can't be written or loaded.
+*---------------------------------------------------------------------------*/
+static bool LoadTable(DecisionTable &table, const char *path, bool is_create)
+{
+	if (!is_create && table.Load(path))
+		return true;
+
+	Cards cards[NUM_CARDS];
+	NintyNine::CreateCards(cards);
+
+	table.Generate(cards, RUNNING_TOTAL_LIMIT);
+	if (!table.Write(path))
+	{
+		printf("Can not write decision table to %s.\n", path);
+		return false;
+	}
+
+	if (!table.Load(path))
+	{
+		printf("Can not load decision table from %s.\n", path);
+		return false;
+	}
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           main
+
+Description:    Main function.
+
+Arguments:      argc: Number of arguments.
+				argv: Arguments (see DisplayUsage).
+
+Returns:        0 on success, 1 on bad arguments.
+*---------------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+	SimSettings settings;
+	bool use_batch = false;
+	const char *table_path = nullptr;
+	bool is_make_table = false;
+	bool is_verify_table = false;
+	bool use_solver = false;
+	const char *log_path = nullptr;
+	const char *export_path = nullptr;
+	const char *effects_path = nullptr;
+	const char *checkpoint_path = nullptr;
+	const char *resume_path = nullptr;
+	const char *trace_path = nullptr;
+	int trace_every = TRACE_DEFAULT_EVERY;
+	int trace_level = TRACE_DEFAULT_LEVEL;
+	bool use_tournament = false;
+	const char *sweep_path = nullptr;
+	const char *out_path = nullptr;
+	TournamentSettings tournament;
+	bool use_tuner = false;
+	TuneSettings tune;
+	bool use_duplicate = false;
+	int server_port = 0;
+	bool is_paired = false;
+	DuplicateSettings duplicate;
+	duplicate.is_rotated_ = false;
+	const char *replay_path = nullptr;
+	ReplaySettings replay;
+
+	// load strategies first, so --ais and --lineup can name them wherever they are
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--strategy") == 0)
+		{
+			int ai;
+			std::string error;
+
+			if (!LoadStrategy(argv[++i], ai, error))
+			{
+				printf("Can not load strategy %s: %s.\n", argv[i], error.c_str());
+				return 1;
+			}
+
+			printf("Strategy %s loaded as AI %d (%s).\n", DisplayAI(ai), ai - AI_EXTERNAL + 1, argv[i]);
+		}
+	}
+
+	// read command line
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if ((std::strcmp(argv[i], "--players") == 0) && (i + 1 < argc))
+			settings.num_players_ = std::atoi(argv[++i]);
+		else if ((std::strcmp(argv[i], "--cards") == 0) && (i + 1 < argc))
+			settings.num_cards_per_player_ = std::atoi(argv[++i]);
+		else if (std::strcmp(argv[i], "--batch") == 0)
+			use_batch = true;
+		else if ((std::strcmp(argv[i], "--table") == 0) && (i + 1 < argc))
+			table_path = argv[++i];
+		else if ((std::strcmp(argv[i], "--make-table") == 0) && (i + 1 < argc))
+		{
+			table_path = argv[++i];
+			is_make_table = true;
+		}
+		else if ((std::strcmp(argv[i], "--solve") == 0) && (i + 1 < argc))
+		{
+			settings.num_games_ = std::atoi(argv[++i]);
+			use_solver = true;
+		}
+		else if ((std::strcmp(argv[i], "--log") == 0) && (i + 1 < argc))
+			log_path = argv[++i];
+		else if ((std::strcmp(argv[i], "--effects") == 0) && (i + 1 < argc))
+			effects_path = argv[++i];
+		else if ((std::strcmp(argv[i], "--checkpoint") == 0) && (i + 1 < argc))
+			checkpoint_path = argv[++i];
+		else if ((std::strcmp(argv[i], "--checkpoint-games") == 0) && (i + 1 < argc))
+			settings.checkpoint_games_ = std::atoi(argv[++i]);
+		else if ((std::strcmp(argv[i], "--resume") == 0) && (i + 1 < argc))
+			resume_path = argv[++i];
+		else if ((std::strcmp(argv[i], "--export") == 0) && (i + 1 < argc))
+			export_path = argv[++i];
+		else if ((std::strcmp(argv[i], "--trace") == 0) && (i + 1 < argc))
+			trace_path = argv[++i];
+		else if ((std::strcmp(argv[i], "--trace-every") == 0) && (i + 1 < argc))
+			trace_every = std::atoi(argv[++i]);
+		else if ((std::strcmp(argv[i], "--trace-level") == 0) && (i + 1 < argc))
+			trace_level = std::atoi(argv[++i]);
+		else if ((std::strcmp(argv[i], "--replay") == 0) && (i + 1 < argc))
+			replay_path = argv[++i];
+		else if ((std::strcmp(argv[i], "--game") == 0) && (i + 1 < argc))
+		{
+			replay.game_ = std::atoi(argv[++i]);
+			replay.is_display_ = true;
+		}
+		else if ((std::strcmp(argv[i], "--min-picks") == 0) && (i + 1 < argc))
+			replay.min_picks_ = std::atoi(argv[++i]);
+		else if ((std::strcmp(argv[i], "--tournament") == 0) && (i + 1 < argc))
+		{
+			settings.num_games_ = std::atoi(argv[++i]);
+			use_tournament = true;
+		}
+		else if ((std::strcmp(argv[i], "--ais") == 0) && (i + 1 < argc))
+		{
+			tournament.ai_mask_ = 0;
+			for (const char *c = argv[++i]; *c != 0; ++c)
+			{
+				int ai = ParseAI(*c);
+				if (ai < 0)
+				{
+					DisplayUsage();
+					return 1;
+				}
+
+				tournament.ai_mask_ |= 1 << ai;
+			}
+		}
+		else if ((std::strcmp(argv[i], "--server") == 0) && (i + 1 < argc))
+			server_port = std::atoi(argv[++i]);
+		else if ((std::strcmp(argv[i], "--strategy") == 0) && (i + 1 < argc))
+			++i;	// loaded before the other options
+		else if ((std::strcmp(argv[i], "--sweep") == 0) && (i + 1 < argc))
+			sweep_path = argv[++i];
+		else if ((std::strcmp(argv[i], "--out") == 0) && (i + 1 < argc))
+			out_path = argv[++i];
+		else if (std::strcmp(argv[i], "--duplicate") == 0)
+		{
+			duplicate.is_rotated_ = true;
+			use_duplicate = true;
+		}
+		else if (std::strcmp(argv[i], "--antithetic") == 0)
+		{
+			duplicate.is_antithetic_ = true;
+			use_duplicate = true;
+		}
+		else if (std::strcmp(argv[i], "--paired") == 0)
+			is_paired = true;
+		else if ((std::strcmp(argv[i], "--lineup") == 0) && (i + 1 < argc))
+		{
+			const char *list = argv[++i];
+			size_t length = std::strlen(list);
+			for (int j = 0; j < MAX_PLAYERS; ++j)
+			{
+				duplicate.ai_[j] = (length > 0) ? ParseAI(list[j % length]) : -1;
+				if (duplicate.ai_[j] < 0)
+				{
+					DisplayUsage();
+					return 1;
+				}
+			}
+			duplicate.has_lineup_ = true;
+		}
+		else if ((std::strcmp(argv[i], "--tune") == 0) && (i + 1 < argc))
+		{
+			tune.generations_ = std::atoi(argv[++i]);
+			use_tuner = true;
+		}
+		else if ((std::strcmp(argv[i], "--population") == 0) && (i + 1 < argc))
+			tune.population_ = std::atoi(argv[++i]);
+		else if ((std::strcmp(argv[i], "--opponents") == 0) && (i + 1 < argc))
+		{
+			const char *list = argv[++i];
+			size_t length = std::strlen(list);
+			if ((length == 0) || (std::strspn(list, "rds") != length))
+			{
+				DisplayUsage();
+				return 1;
+			}
+
+			for (int j = 0; j < MAX_PLAYERS; ++j)
+			{
+				char ai = list[j % length];
+				tune.rules_.ai_[j] = (ai == 'r') ? AI_RANDOM : ((ai == 'd') ? AI_DUMB : AI_SMART);
+			}
+		}
+		else if ((std::strcmp(argv[i], "--threads") == 0) && (i + 1 < argc))
+			settings.num_threads_ = std::atoi(argv[++i]);
+		else if ((std::strcmp(argv[i], "--seed") == 0) && (i + 1 < argc))
+			settings.seed_ = std::strtoull(argv[++i], nullptr, 10);
+		else if ((std::strcmp(argv[i], "--games") == 0) && (i + 1 < argc))
+			settings.num_games_ = tune.num_games_ = std::atoi(argv[++i]);
+		else if ((std::strcmp(argv[i], "--stop") == 0) && (i + 1 < argc))
+		{
+			++i;
+			if (std::strcmp(argv[i], "precision") == 0)
+				settings.stop_rule_ = STOP_PRECISION;
+			else if (std::strcmp(argv[i], "better") == 0)
+				settings.stop_rule_ = STOP_BETTER;
+			else if (std::strcmp(argv[i], "any") == 0)
+				settings.stop_rule_ = STOP_PRECISION | STOP_BETTER;
+			else
+			{
+				DisplayUsage();
+				return 1;
+			}
+		}
+		else if ((std::strcmp(argv[i], "--confidence") == 0) && (i + 1 < argc))
+			settings.confidence_ = std::atof(argv[++i]);
+		else if ((std::strcmp(argv[i], "--precision") == 0) && (i + 1 < argc))
+			settings.precision_ = std::atof(argv[++i]);
+		else if ((std::strcmp(argv[i], "--verify-table") == 0) && (i + 1 < argc))
+		{
+			table_path = argv[++i];
+			is_verify_table = true;
+		}
+		else
+		{
+			DisplayUsage();
+			return 1;
+		}
+	}
+
+	// card effects of a variant of the rules
+	EffectTable effects;
+
+	if (effects_path != nullptr)
+	{
+		if (use_batch)
+		{
+			printf("Batch engine only plays the special cards of the default rules.\n");
+			return 1;
+		}
+
+		if ((sweep_path != nullptr) || use_tuner)
+		{
+			printf("Sweep engine plays the special cards of its grid, not an effect file.\n");
+			return 1;
+		}
+
+		if (table_path != nullptr)
+		{
+			printf("Decision table only holds the choices of the special cards of the default rules.\n");
+			return 1;
+		}
+
+		CardEffects card_effects;
+		int error_line = 0;
+
+		if (!ReadEffects(effects_path, card_effects, error_line))
+		{
+			if (error_line == 0)
+				printf("Can not read effect file %s.\n", effects_path);
+			else
+				printf("%s(%d): bad face value, effect or flag.\n", effects_path, error_line);
+			return 1;
+		}
+
+		effects.Compile(card_effects, RUNNING_TOTAL_LIMIT);
+		settings.effects_ = &effects;
+	}
+
+	// serve human-vs-AI games
+	if (server_port > 0)
+	{
+		ServerSettings server;
+		server.port_ = server_port;
+		server.num_players_ = settings.num_players_;
+		server.num_cards_per_player_ = settings.num_cards_per_player_;
+		server.seed_ = settings.seed_;
+		server.effects_ = settings.effects_;
+		if (duplicate.has_lineup_)
+		{
+			for (int i = 0; i < MAX_PLAYERS; ++i)
+				server.ai_[i] = duplicate.ai_[i];
+		}
+
+		printf("Serving games on 127.0.0.1:%d\n", server_port);
+		fflush(stdout);
+
+		std::string error;
+		RunServer(server, error);
+		printf("Server stopped: %s.\n", error.c_str());
+
+		return 1;
+	}
+
+	// replay a game log
+	if (replay_path != nullptr)
+	{
+		ReplayReport report;
+		replay.effects_ = settings.effects_;
+
+		if (!RunReplay(replay_path, replay, report))
+		{
+			printf("%s is not a game log, no engine is compiled for its rules,\n", replay_path);
+			printf("or its games were played with other card effects (give the same --effects).\n");
+			return 1;
+		}
+
+		DisplayReplayReport(report);
+
+		return (report.num_errors_ == 0) ? 0 : 1;
+	}
+
+	// decision table of dumb/smart AI
+	DecisionTable table;
+
+	if (is_verify_table)
+	{
+		if (!table.Load(table_path))
+		{
+			printf("%s is not a decision table.\n", table_path);
+			return 1;
+		}
+
+		int mismatches = table.Verify();
+		if (mismatches < 0)
+			printf("Decision table %s is built for other rules.\n", table_path);
+		else
+			printf("Decision table %s: %d mismatches.\n", table_path, mismatches);
+
+		return (mismatches == 0) ? 0 : 1;
+	}
+
+	if (table_path != nullptr)
+	{
+		if (!LoadTable(table, table_path, is_make_table))
+			return 1;
 
-	PlayerList playerlist = game.GetPlayerList();
-	for (int i = 0; i < NUM_PLAYERS; ++i)
-		printf("Player %d (%s) won %d times.\n", i, DisplayAI(playerlist[i]->AI_), win_player[i]);
+		if (is_make_table)
+			return 0;
 
-	// free
-	game.Free();
+		settings.table_ = &table;
+	}
+
+	// compare AI with the perfect-information solver
+	if (use_solver)
+	{
+		SolverReport report;
+
+		if (!RunSolver(settings, report))
+		{
+			printf("No solver for %d players with %d cards, the line-up has a human player,\n",
+				settings.num_players_, settings.num_cards_per_player_);
+			printf("or the decision table is built for other rules.\n");
+			return 1;
+		}
+
+		DisplaySolverReport(report);
+
+		return 0;
+	}
+
+	// play every point of a rule/parameter grid
+	if (sweep_path != nullptr)
+	{
+		std::vector<RuleSet> points;
+		int num_invalid = 0;
+		int error_line = 0;
+
+		if (!ReadSweepGrid(sweep_path, points, num_invalid, error_line))
+		{
+			if (error_line == 0)
+				printf("Can not read grid file %s.\n", sweep_path);
+			else
+				printf("%s(%d): unknown key or bad value.\n", sweep_path, error_line);
+			return 1;
+		}
+
+		if (out_path == nullptr)
+			out_path = "sweep.csv";
+
+		std::ofstream out(out_path);
+		if (!out)
+		{
+			printf("Can not write sweep result to %s.\n", out_path);
+			return 1;
+		}
+
+		unsigned long long seed = RunSweep(points, settings.num_threads_, settings.seed_, out);
+
+		printf("%d points written to %s (%d points can not be played), random seed: %llu\n", (int)points.size(), out_path,
+			num_invalid, seed);
+
+		return 0;
+	}
+
+	// play every deal more than once
+	if (use_duplicate)
+	{
+		DuplicateResult result;
+		duplicate.sim_ = settings;
+
+		if (!RunDuplicate(duplicate, result))
+		{
+			printf("No engine is compiled for %d players with %d cards, the line-up has a human player,\n",
+				settings.num_players_, settings.num_cards_per_player_);
+			printf("or the decision table is built for other rules.\n");
+			return 1;
+		}
+
+		DisplayDuplicate(result, is_paired);
+
+		return 0;
+	}
+
+	// tune the smart AI on the sweep engine
+	if (use_tuner)
+	{
+		if (out_path == nullptr)
+			out_path = "tune.csv";
+
+		std::ofstream out(out_path);
+		if (!out)
+		{
+			printf("Can not write convergence log to %s.\n", out_path);
+			return 1;
+		}
+
+		tune.rules_.num_players_ = settings.num_players_;
+		tune.rules_.num_cards_per_player_ = settings.num_cards_per_player_;
+		tune.num_threads_ = settings.num_threads_;
+		tune.seed_ = settings.seed_;
+
+		TuneResult result;
+		if (!RunTuner(tune, result, &out))
+		{
+			printf("Can not tune with %d players, %d cards, %d candidates and %d games per candidate.\n",
+				settings.num_players_, settings.num_cards_per_player_, tune.population_, tune.num_games_);
+			return 1;
+		}
+
+		DisplayTuneResult(result, settings.num_players_);
+		printf("Convergence log written to %s\n", out_path);
+
+		return 0;
+	}
+
+	// play every line-up in every seat rotation
+	if (use_tournament)
+	{
+		TournamentResult result;
+		tournament.sim_ = settings;
+
+		if (!RunTournament(tournament, result))
+		{
+			printf("No engine is compiled for %d players with %d cards, no AI is picked,\n",
+				settings.num_players_, settings.num_cards_per_player_);
+			printf("or the decision table is built for other rules.\n");
+			return 1;
+		}
+
+		DisplayTournament(result);
+
+		return 0;
+	}
+
+	// continue the run of a checkpoint with its settings
+	Checkpoint checkpoint;
+
+	if (resume_path != nullptr)
+	{
+		if (log_path != nullptr)
+		{
+			printf("A resumed run can not be recorded into a game log.\n");
+			return 1;
+		}
+
+		if (export_path != nullptr)
+		{
+			printf("A resumed run can not be exported, the games before the checkpoint are not recorded.\n");
+			return 1;
+		}
+
+		if (!LoadCheckpoint(resume_path, checkpoint))
+		{
+			printf("%s is not a checkpoint.\n", resume_path);
+			return 1;
+		}
+
+		GetCheckpointSettings(checkpoint, settings);
+		if (checkpoint_path == nullptr)
+			checkpoint_path = resume_path;
+
+		printf("Resuming from game %d of %d.\n", checkpoint.next_game_, checkpoint.num_games_);
+	}
+
+	// save checkpoints
+	if (checkpoint_path != nullptr)
+	{
+		if (!USE_COUNTER_RNG || use_batch)
+		{
+			printf("Checkpoints need counter-based mode (USE_COUNTER_RNG) and can not be taken by the batch engine.\n");
+			return 1;
+		}
+
+		settings.checkpoint_ = checkpoint_path;
+	}
+
+	// record every game
+	GameLogFile log;
+
+	if (log_path != nullptr)
+	{
+		if (!USE_COUNTER_RNG || use_batch)
+		{
+			printf("Game logs need counter-based mode (USE_COUNTER_RNG) and can not be recorded by the batch engine.\n");
+			return 1;
+		}
+
+		if (!log.Open(log_path))
+		{
+			printf("Can not write game log to %s.\n", log_path);
+			return 1;
+		}
+
+		settings.log_ = &log;
+	}
+
+	// trace sampled games
+	TraceSink trace;
+
+	if (trace_path != nullptr)
+	{
+		if (use_batch)
+		{
+			printf("Games played by the batch engine can not be traced.\n");
+			return 1;
+		}
+
+		if (!trace.Open(trace_path, trace_level, trace_every))
+		{
+			printf("Can not write trace to %s.\n", trace_path);
+			return 1;
+		}
+
+		settings.trace_ = &trace;
+	}
+
+	// export the result of every game
+	ExportFile exporter;
+
+	if (export_path != nullptr)
+	{
+		if (use_batch)
+		{
+			printf("Games played by the batch engine can not be exported.\n");
+			return 1;
+		}
+
+		size_t length = std::strlen(export_path);
+		bool is_csv = (length >= 4) && (std::strcmp(export_path + length - 4, ".csv") == 0);
+
+		if (!exporter.Open(export_path, is_csv))
+		{
+			printf("Can not write results to %s.\n", export_path);
+			return 1;
+		}
+
+		settings.export_ = &exporter;
+	}
+
+	// store stats from simulations
+	SimResult result;
+
+	// play games on batch engines
+	if (use_batch)
+	{
+		if ((settings.num_players_ != NUM_PLAYERS) || (settings.num_cards_per_player_ != NUM_CARDS_PER_PLAYER))
+		{
+			printf("Batch engine only plays %d players with %d cards.\n", NUM_PLAYERS, NUM_CARDS_PER_PLAYER);
+			return 1;
+		}
+
+		NintyNine game(false, settings.seed_);
+		game.Initialize();
+
+		if (!RunBatchSimulation(game, settings, result))
+		{
+			printf("Batch engine can not play with human, MCTS or external player.\n");
+			return 1;
+		}
+
+		printf("Batch engine kernels: %s\n", GetBatchSimdName(GetBatchSimd()));
+
+		DisplayResult(result);
+
+		return 0;
+	}
+
+	// play games (split across NUM_THREADS threads) on the engine of this configuration
+	if (!RunSimulation(settings, result))
+	{
+		if (checkpoint_path != nullptr)
+		{
+			printf("No engine is compiled for %d players with %d cards, the checkpoint is from another AI line-up,\n",
+				settings.num_players_, settings.num_cards_per_player_);
+			printf("effect file (give the same --effects) or build, %s can not be written,\n", checkpoint_path);
+			printf("or the decision table is built for other rules.\n");
+			return 1;
+		}
+
+		printf("No engine is compiled for %d players with %d cards, or the decision table is built for other rules.\n",
+			settings.num_players_, settings.num_cards_per_player_);
+		DisplayUsage();
+		return 1;
+	}
+
+	// write the rows left in the export
+	if (export_path != nullptr)
+	{
+		if (!exporter.Close())
+		{
+			printf("Can not write results to %s.\n", export_path);
+			return 1;
+		}
+
+		printf("Results exported to %s\n", export_path);
+	}
+
+	// write the events left in the trace
+	if (trace_path != nullptr)
+	{
+		trace.Close();
+		printf("Trace written to %s\n", trace_path);
+	}
+
+	// display result
+	DisplayResult(result);
 
 	return 0;
 }
\ No newline at end of file
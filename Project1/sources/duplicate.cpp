@@ -0,0 +1,274 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Duplicate play (variance reduction)
+
+#include <cmath>		// std::sqrt
+#include <vector>
+
+#include "duplicate.h"
+#include "workpool.h"
+
+using namespace POKER;
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           PlayDeals
+
+Description:	Play deals [first_deal, last_deal). Deal i is played on random
+				stream i by every engine (one per seat rotation), with the normal
+				and, if asked, the antithetic shuffle. The games of a deal are
+				one sample of the share of wins of each player.
+
+Arguments:      engines: Engine of each seat rotation (rotation r: seat s is player (s + r) % players).
+				is_antithetic: Also play the antithetic shuffle.
+				first_deal: Index of the first deal.
+				last_deal: Index after the last deal.
+				result: Result of this job.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+static void PlayDeals(std::vector<NintyNineT<RULES> > &engines, bool is_antithetic, int first_deal, int last_deal,
+	DuplicateResult &result)
+{
+	const int num_players = RULES::NUM_PLAYERS;
+	int num_rotations = (int)engines.size();
+	int num_shuffles = is_antithetic ? 2 : 1;
+
+	for (int i = first_deal; i < last_deal; ++i)
+	{
+		int wins[MAX_PLAYERS] = {};
+
+		for (int shuffle = 0; shuffle < num_shuffles; ++shuffle)
+		{
+			for (int r = 0; r < num_rotations; ++r)
+			{
+				NintyNineT<RULES> &game = engines[r];
+
+				game.SetAntithetic(shuffle == 1);
+				game.SeedStream(i);
+
+				int winner = (game.Play(result.stats_) + r) % num_players;
+				++result.stats_.num_games_;
+				++result.win_player_[winner];
+				++wins[winner];
+			}
+		}
+
+		double games = num_shuffles * num_rotations;
+		for (int a = 0; a < num_players; ++a)
+		{
+			result.share_[a].Add(wins[a] / games);
+
+			for (int b = a + 1; b < num_players; ++b)
+				result.diff_[a][b].Add((wins[a] - wins[b]) / games);
+		}
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PlayDuplicate
+
+Description:	Play duplicate deals on the engine of the rules. The games of
+				settings are turned into deals (games / games per deal), split
+				into jobs of DUPLICATE_JOB_DEALS deals; results of jobs are merged
+				in job order, so the result does not depend on the number of threads.
+
+Arguments:      settings: Duplicate settings.
+				result: Result of all deals.
+
+Returns:        false if the decision table is built for other rules,
+				or the line-up has a human player.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+static bool PlayDuplicate(const DuplicateSettings &settings, DuplicateResult &result)
+{
+	typedef NintyNineT<RULES> Engine;
+	const int num_players = RULES::NUM_PLAYERS;
+
+	// line-up and seed of all games (resolves seed 0 the same way as the engine)
+	Engine main(false, settings.sim_.seed_);
+	if (settings.has_lineup_)
+		main.Initialize(settings.ai_);
+	else
+		main.Initialize();
+
+	if (!main.SetDecisionTable(settings.sim_.table_))
+		return false;
+
+	result = DuplicateResult();
+	result.num_players_ = num_players;
+	result.seed_ = main.GetSeed();
+	result.confidence_ = settings.sim_.confidence_;
+
+	for (int i = 0; i < num_players; ++i)
+	{
+		result.ai_[i] = main.GetPlayer(i).AI_;
+		if (result.ai_[i] == AI_PLAYER)
+			return false;
+	}
+
+	int num_rotations = settings.is_rotated_ ? num_players : 1;
+	result.games_per_deal_ = num_rotations * (settings.is_antithetic_ ? 2 : 1);
+
+	int num_deals = settings.sim_.num_games_ / result.games_per_deal_;
+	if (num_deals < 1)
+		num_deals = 1;
+
+	int num_jobs = (num_deals + DUPLICATE_JOB_DEALS - 1) / DUPLICATE_JOB_DEALS;
+	std::vector<DuplicateResult> jobs(num_jobs);
+	unsigned long long seed = result.seed_;
+
+	WorkPool pool(GetNumThreads(settings.sim_.num_threads_, num_jobs));
+
+	pool.Run(num_jobs, [&](int job, int)
+	{
+		std::vector<Engine> engines;
+		engines.reserve(num_rotations);
+
+		for (int r = 0; r < num_rotations; ++r)
+		{
+			int ai_list[MAX_PLAYERS];
+			for (int s = 0; s < num_players; ++s)
+				ai_list[s] = result.ai_[(s + r) % num_players];
+
+			engines.push_back(Engine(false, seed));
+			engines[r].Initialize(ai_list);
+			// the table fits the rules, the main engine took it
+			engines[r].SetDecisionTable(settings.sim_.table_);
+			engines[r].SetEffects(settings.sim_.effects_);
+		}
+
+		int first_deal = job * DUPLICATE_JOB_DEALS;
+		int last_deal = first_deal + DUPLICATE_JOB_DEALS;
+		if (last_deal > num_deals)
+			last_deal = num_deals;
+
+		PlayDeals(engines, settings.is_antithetic_, first_deal, last_deal, jobs[job]);
+	});
+
+	result.num_threads_ = pool.GetNumThreads();
+
+	for (int i = 0; i < num_jobs; ++i)
+		result.Merge(jobs[i]);
+
+	return true;
+}
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           DuplicateResult
+
+Description:	Constructor.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+DuplicateResult::DuplicateResult()
+	: num_players_(0), games_per_deal_(0), num_threads_(0), seed_(0), confidence_(STOP_CONFIDENCE)
+{
+	for (int i = 0; i < MAX_PLAYERS; ++i)
+	{
+		ai_[i] = AI_SMART;
+		win_player_[i] = 0;
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Merge
+
+Description:	Merge result of another job.
+
+Arguments:      other: Result of another job.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void DuplicateResult::Merge(const DuplicateResult &other)
+{
+	stats_.Merge(other.stats_);
+
+	for (int a = 0; a < MAX_PLAYERS; ++a)
+	{
+		win_player_[a] += other.win_player_[a];
+		share_[a].Merge(other.share_[a]);
+
+		for (int b = a + 1; b < MAX_PLAYERS; ++b)
+			diff_[a][b].Merge(other.diff_[a][b]);
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetRateHalfWidth
+
+Description:	Half-width of the win rate interval of a player, from the spread
+				of its share over deals, and (binomial) for as many independent games.
+
+Arguments:      player: Player of the line-up.
+				duplicate: Half-width of the duplicate estimate.
+				independent: Half-width of the independent-game estimate.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void DuplicateResult::GetRateHalfWidth(int player, double &duplicate, double &independent) const
+{
+	double z = GetZScore(confidence_);
+	double p = share_[player].mean_;
+
+	duplicate = share_[player].GetHalfWidth(z);
+	independent = (stats_.num_games_ > 0) ? z * std::sqrt(p * (1.0 - p) / stats_.num_games_) : 0.0;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetDiffHalfWidth
+
+Description:	Half-width of the interval of the win rate difference of two
+				players, from the spread of the paired differences over deals,
+				and for as many independent games (a game has one winner, so
+				the variance of the difference is (pa + pb - (pa - pb)^2) / games).
+
+Arguments:      a: Player of the line-up.
+				b: Player of the line-up (a < b).
+				paired: Half-width of the paired estimate.
+				independent: Half-width of the independent-game estimate.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void DuplicateResult::GetDiffHalfWidth(int a, int b, double &paired, double &independent) const
+{
+	double z = GetZScore(confidence_);
+	double pa = share_[a].mean_;
+	double pb = share_[b].mean_;
+	double variance = pa + pb - (pa - pb) * (pa - pb);
+
+	paired = diff_[a][b].GetHalfWidth(z);
+	independent = (stats_.num_games_ > 0) ? z * std::sqrt(variance / stats_.num_games_) : 0.0;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           RunDuplicate
+
+Description:	Play duplicate deals on the engine compiled for the number of
+				players and number of cards per player in settings.
+
+Arguments:      settings: Duplicate settings.
+				result: Result of all deals.
+
+Returns:        false if no engine is compiled for this configuration, the decision table
+				is built for other rules, or the line-up has a human player.
+*---------------------------------------------------------------------------*/
+bool POKER::RunDuplicate(const DuplicateSettings &settings, DuplicateResult &result)
+{
+#define NINTYNINE_DUPLICATE(players, cards)												\
+	if ((settings.sim_.num_players_ == players) && (settings.sim_.num_cards_per_player_ == cards))	\
+		return PlayDuplicate<Rules<players, cards> >(settings, result);
+
+	NINTYNINE_CONFIGS(NINTYNINE_DUPLICATE)
+#undef NINTYNINE_DUPLICATE
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Duplicate play (variance reduction)
+// luck of the deal dominates a single game, so every deal is played more than once:
+// - seat rotation: the deal is replayed with the line-up rotated through every seat, so each player
+//   of the line-up gets every hand (the deck order is the same while no random AI draws)
+// - antithetic deals: the deal is also played with the antithetic shuffle (see NintyNine::SetAntithetic)
+// the games of a deal are one sample: the share of them each player wins, and (paired estimator)
+// the difference of the shares of two players; their spread over deals gives the intervals
+// the effective sample size gain compares them with the binomial intervals of as many independent games
+
+#pragma once
+
+#include "nintynine.h"
+#include "simulation.h"
+
+namespace POKER
+{
+	// number of deals of a duplicate job
+	static const int DUPLICATE_JOB_DEALS = 1000;
+
+	// settings of duplicate play
+	struct DuplicateSettings
+	{
+		SimSettings sim_;				// rules, number of games (deals are as many as fit), threads and decision table
+		bool is_rotated_;				// replay every deal in every seat rotation
+		bool is_antithetic_;			// play every deal also with the antithetic shuffle
+		bool has_lineup_;				// ai_ is the line-up (false: picked by the settings in nintynine.h)
+		int ai_[MAX_PLAYERS];			// line-up
+
+		// constructor
+		DuplicateSettings() : is_rotated_(true), is_antithetic_(false), has_lineup_(false) {}
+	};
+
+	// result of duplicate play, players are the players of the line-up (not seats)
+	struct DuplicateResult
+	{
+		GameStats stats_;							// stats of all games
+		int num_players_;							// number of players
+		int ai_[MAX_PLAYERS];						// line-up
+		int games_per_deal_;						// games played with each deal
+		int num_threads_;							// number of threads
+		unsigned long long seed_;					// random seed
+		double confidence_;							// confidence level of intervals
+		int win_player_[MAX_PLAYERS];				// number of wins of each player
+		RunningStat share_[MAX_PLAYERS];			// share of the games of a deal won by each player
+		RunningStat diff_[MAX_PLAYERS][MAX_PLAYERS];	// [a][b] (a < b): share of a minus share of b
+
+		// constructor
+		DuplicateResult();
+
+		// merge result of another job
+		void Merge(const DuplicateResult &other);
+
+		// win rate interval of a player: half-width of the duplicate and of the independent-game estimate
+		void GetRateHalfWidth(int player, double &duplicate, double &independent) const;
+		// win rate difference interval of two players (a < b): half-width of the paired and of the independent-game estimate
+		void GetDiffHalfWidth(int a, int b, double &paired, double &independent) const;
+	};
+
+	// play duplicate deals on the engine compiled for the number of players and cards in settings
+	// returns false if there's no such engine (see NINTYNINE_CONFIGS), the decision table is built for other rules
+	// or the line-up has a human player
+	bool RunDuplicate(const DuplicateSettings &settings, DuplicateResult &result);
+}
@@ -0,0 +1,293 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Card effects
+
+#include <cstdlib>		// std::strtol
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "effects.h"
+
+using namespace POKER;
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           ReadNumber
+
+Description:	Read a number (may be negative) from the words of a line.
+
+Arguments:      words: Words of the line.
+				number: Receives the number.
+
+Returns:        false if the next word is missing or not a number.
+*---------------------------------------------------------------------------*/
+static bool ReadNumber(std::istringstream &words, int &number)
+{
+	std::string word;
+	if (!(words >> word))
+		return false;
+
+	char *end;
+	long value = std::strtol(word.c_str(), &end, 10);
+	if ((*end != 0) || (value < -EFFECT_MAX_AMOUNT) || (value > EFFECT_MAX_AMOUNT))
+		return false;
+
+	number = (int)value;
+
+	return true;
+}
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           CardEffects
+
+Description:	Constructor, every face value adds its face value.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+CardEffects::CardEffects()
+{
+	for (int i = 0; i <= NUM_VALUES; ++i)
+	{
+		effects_[i].kind_ = EK_FACE;
+		effects_[i].amount_ = 0;
+		effects_[i].threshold_ = 0;
+		effects_[i].flags_ = 0;
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           SetSpecials
+
+Description:	Set the effects of the special cards of the default game:
+				+/-10 and +/-20 turn down within 9 and 19 of the limit,
+				"99" sets the running total to the limit, reverse flips the
+				player order, skip and pick are flagged only.
+				The first special card of a face value wins.
+
+Arguments:      sp_10 ~ sp_pick: Face value of each special card (outside
+				1 ~ NUM_VALUES: not in the game).
+				limit: Running total limit.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void CardEffects::SetSpecials(int sp_10, int sp_20, int sp_99, int sp_reverse, int sp_skip, int sp_pick, int limit)
+{
+	const int values[] = { sp_10, sp_20, sp_99, sp_reverse, sp_skip, sp_pick };
+	const CardEffect specials[] =
+	{
+		{ EK_TURN, 10, limit - 9, 0 },
+		{ EK_TURN, 20, limit - 19, 0 },
+		{ EK_SET, limit, 0, 0 },
+		{ EK_ADD, 0, 0, EF_REVERSE },
+		{ EK_ADD, 0, 0, EF_SKIP },
+		{ EK_ADD, 0, 0, EF_PICK },
+	};
+
+	// set the last special card first, so the first one of a face value wins
+	for (int i = (int)(sizeof(values) / sizeof(values[0])) - 1; i >= 0; --i)
+	{
+		if ((values[i] >= 1) && (values[i] <= NUM_VALUES))
+			effects_[values[i]] = specials[i];
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Compile
+
+Description:	Compile effects into the entries of every running total
+				0 ~ limit and face value 0 ~ NUM_VALUES, and the weight smart
+				AI gives each face value.
+
+Arguments:      effects: Effect of each face value.
+				limit: Running total limit.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void EffectTable::Compile(const CardEffects &effects, int limit)
+{
+	static_assert(SP_10_WEIGHT == SP_20_WEIGHT, "turn cards of any amount share one weight");
+
+	limit_ = limit;
+	entries_.resize((limit + 1) * (NUM_VALUES + 1));
+
+	for (int value = 0; value <= NUM_VALUES; ++value)
+	{
+		const CardEffect &effect = effects.effects_[value];
+		int weight = SP_NULL_WEIGHT;
+
+		if (effect.kind_ == EK_TURN)
+			weight = SP_10_WEIGHT;
+		else if (effect.kind_ == EK_SET)
+			weight = SP_99_WEIGHT;
+		else if (effect.flags_ & EF_REVERSE)
+			weight = SP_REVERSE_WEIGHT;
+		else if (effect.flags_ & EF_SKIP)
+			weight = SP_SKIP_WEIGHT;
+		else if (effect.flags_ & EF_PICK)
+			weight = SP_PICK_WEIGHT;
+
+		weights_[value] = (unsigned char)weight;
+	}
+
+	for (int total = 0; total <= limit; ++total)
+	{
+		for (int value = 0; value <= NUM_VALUES; ++value)
+		{
+			const CardEffect &effect = effects.effects_[value];
+			int new_total;
+
+			switch (effect.kind_)
+			{
+			case EK_ADD:
+				new_total = total + effect.amount_;
+				break;
+
+			case EK_TURN:
+				new_total = (total > effect.threshold_) ? total - effect.amount_ : total + effect.amount_;
+				break;
+
+			case EK_SET:
+				new_total = effect.amount_;
+				break;
+
+			default:
+				new_total = total + value;
+				break;
+			}
+
+			if (new_total < 0)
+				new_total = 0;
+
+			EffectEntry &entry = entries_[total * (NUM_VALUES + 1) + value];
+			entry.total_ = (short)new_total;
+			entry.flags_ = (unsigned char)effect.flags_;
+			entry.kind_ = (unsigned char)effect.kind_;
+		}
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetHash
+
+Description:	Hash the compiled entries with 64-bit FNV-1a, field by field,
+				so the hash does not depend on the padding or byte order of
+				an entry. Two tables with the same entries play the same game.
+
+Arguments:      None.
+
+Returns:        Hash of the table.
+*---------------------------------------------------------------------------*/
+unsigned long long EffectTable::GetHash(void) const
+{
+	unsigned long long hash = 14695981039346656037ULL;
+
+	for (size_t i = 0; i < entries_.size(); ++i)
+	{
+		unsigned short total = (unsigned short)entries_[i].total_;
+		const unsigned char bytes[] = { (unsigned char)total, (unsigned char)(total >> 8), entries_[i].flags_, entries_[i].kind_ };
+
+		for (int j = 0; j < 4; ++j)
+		{
+			hash ^= bytes[j];
+			hash *= 1099511628211ULL;
+		}
+	}
+
+	return hash;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           ReadEffects
+
+Description:	Read an effect file (see effects.h). Face values not listed
+				add their face value.
+
+Arguments:      path: Path of the effect file.
+				effects: Receives the effects.
+				error_line: Line number of a bad line (0 if the file can't be read).
+
+Returns:        false if the file can't be read or has a bad line.
+*---------------------------------------------------------------------------*/
+bool POKER::ReadEffects(const char *path, CardEffects &effects, int &error_line)
+{
+	effects = CardEffects();
+	error_line = 0;
+
+	std::ifstream file(path);
+	if (!file)
+		return false;
+
+	std::string line;
+
+	for (int line_num = 1; std::getline(file, line); ++line_num)
+	{
+		line = line.substr(0, line.find('#'));
+
+		std::istringstream words(line);
+		int value;
+		if (!ReadNumber(words, value))
+		{
+			// blank line
+			if (line.find_first_not_of(" \t\r") == std::string::npos)
+				continue;
+
+			error_line = line_num;
+			return false;
+		}
+
+		CardEffect effect = { EK_ADD, 0, 0, 0 };
+		std::string word;
+		bool is_ok = (value >= 1) && (value <= NUM_VALUES) && (words >> word);
+
+		// effect on the running total, then flags
+		if (is_ok && (word == "add"))
+		{
+			is_ok = ReadNumber(words, effect.amount_);
+			word.clear();
+		}
+		else if (is_ok && (word == "turn"))
+		{
+			effect.kind_ = EK_TURN;
+			is_ok = ReadNumber(words, effect.amount_) && ReadNumber(words, effect.threshold_);
+			word.clear();
+		}
+		else if (is_ok && (word == "set"))
+		{
+			effect.kind_ = EK_SET;
+			is_ok = ReadNumber(words, effect.amount_);
+			word.clear();
+		}
+
+		while (is_ok && (!word.empty() || (words >> word)))
+		{
+			if (word == "reverse")
+				effect.flags_ |= EF_REVERSE;
+			else if (word == "skip")
+				effect.flags_ |= EF_SKIP;
+			else if (word == "pick")
+				effect.flags_ |= EF_PICK;
+			else
+				is_ok = false;
+
+			word.clear();
+		}
+
+		if (!is_ok)
+		{
+			error_line = line_num;
+			return false;
+		}
+
+		effects.effects_[value] = effect;
+	}
+
+	return true;
+}
\ No newline at end of file
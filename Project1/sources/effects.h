@@ -0,0 +1,120 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Card effects
+// what each face value does to the running total and the player order is set per value, from the special
+// cards of the rules or from an effect file read at runtime, and compiled into a table indexed by
+// [running total][face value], so the engines look up the new total and flags of a card without branching
+// on its kind, and a variant of the rules plays at the same speed as the default game
+// effect file: one line per face value changed, "#" starts a comment, values not listed add their face value
+//   <value> add <n>                  add n instead of the face value (n may be negative)
+//   <value> turn <n> <threshold>     subtract n if the running total is above threshold, otherwise add n
+//   <value> set <n>                  set the running total to n
+//   followed by any of: reverse (reverse player order), skip, pick
+//   a line with flags only keeps the running total, e.g. "4 reverse"
+// the running total never goes below 0
+
+#pragma once
+
+#include <vector>
+
+#include "nintynine.h"
+
+namespace POKER
+{
+	// largest amount or threshold of an effect file
+	static const int EFFECT_MAX_AMOUNT = 1000;
+	// highest running total limit a table is compiled for, a total after a card (at most the limit plus
+	// EFFECT_MAX_AMOUNT, or plus 20 for the special cards of the default game) fits in EffectEntry::total_
+	static const int EFFECT_MAX_LIMIT = 30000;
+
+	static_assert(EFFECT_MAX_LIMIT + EFFECT_MAX_AMOUNT <= 32767, "running totals must fit in EffectEntry::total_");
+
+	// effect of a card on the running total
+	enum EFFECT_KIND
+	{
+		EK_FACE,		// add the face value
+		EK_ADD,			// add amount
+		EK_TURN,		// subtract amount above threshold, otherwise add amount
+		EK_SET,			// set to amount
+	};
+
+	// flags of a card
+	enum EFFECT_FLAG
+	{
+		EF_REVERSE	= 1,	// reverse player order
+		EF_SKIP		= 2,	// skip card (no effect on the order)
+		EF_PICK		= 4,	// pick card (no effect on the order)
+	};
+
+	// effect of a face value
+	struct CardEffect
+	{
+		int kind_;			// EFFECT_KIND
+		int amount_;		// amount added or set
+		int threshold_;		// highest running total adding amount (EK_TURN)
+		int flags_;			// EFFECT_FLAG
+	};
+
+	// effects of every face value
+	struct CardEffects
+	{
+		CardEffect effects_[NUM_VALUES + 1];	// effect of each face value (0 is unused)
+
+		// constructor, every value adds its face value
+		CardEffects();
+
+		// effects of the special cards of the default game, with turn points within 9 and 19 of the limit
+		// and "99" setting the running total to the limit, a value outside 1 ~ NUM_VALUES removes a special card
+		// a face value with more than one special card gets the first one (order of SPECIAL)
+		void SetSpecials(int sp_10, int sp_20, int sp_99, int sp_reverse, int sp_skip, int sp_pick, int limit);
+	};
+
+	// result of dealing a card on a running total
+	struct EffectEntry
+	{
+		short total_;			// running total after the card (above the limit: the player loses)
+		unsigned char flags_;	// EFFECT_FLAG
+		unsigned char kind_;	// EFFECT_KIND of the card
+
+		// the card moves the running total other than by its face value (total: running total before the card)
+		// a card with flags only adds 0 and has no effect on the total
+		bool HasTotalEffect(int total) const
+		{
+			return (kind_ == EK_TURN) || (kind_ == EK_SET) || ((kind_ == EK_ADD) && (total_ != total));
+		}
+	};
+
+	// effects compiled for every running total 0 ~ limit
+	class EffectTable
+	{
+	public:
+		// constructor, empty table
+		EffectTable() : limit_(-1) {}
+		// constructor, compile effects
+		EffectTable(const CardEffects &effects, int limit) : limit_(-1) { Compile(effects, limit); }
+
+		// compile effects for running totals 0 ~ limit (1 ~ EFFECT_MAX_LIMIT)
+		void Compile(const CardEffects &effects, int limit);
+
+		// result of dealing a card of face value on a running total (0 ~ limit)
+		const EffectEntry &Get(int total, int value) const { return entries_[total * (NUM_VALUES + 1) + value]; }
+		// weight smart AI gives a card of face value: the weight of the special card of the default game
+		// with the same effect (turn, set, then flags), SP_NULL_WEIGHT for a normal card adding an amount
+		int GetWeight(int value) const { return weights_[value]; }
+		// running total limit the table is compiled for (-1: empty)
+		int GetLimit(void) const { return limit_; }
+		// hash of the compiled entries (64-bit FNV-1a), tables playing the same game have the same hash
+		unsigned long long GetHash(void) const;
+
+	private:
+		int limit_;								// running total limit
+		std::vector<EffectEntry> entries_;		// entry of each [running total][face value]
+		unsigned char weights_[NUM_VALUES + 1];	// weight of each face value
+	};
+
+	// read an effect file (values not listed add their face value)
+	// returns false if the file can't be read (error_line is 0) or has a bad line
+	bool ReadEffects(const char *path, CardEffects &effects, int &error_line);
+}
@@ -0,0 +1,309 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Per-game results export
+
+#include <cstring>		// std::memcpy
+
+#include "export.h"
+
+using namespace POKER;
+
+// file id and version of an export file
+static const char EXPORT_MAGIC[8] = { 'N', 'N', '9', '9', 'E', 'X', '0', '1' };
+// id of a block
+static const char EXPORT_BLOCK_MAGIC[4] = { 'N', 'N', 'X', 'B' };
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           ExportFile
+
+Description:	Constructor.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+ExportFile::ExportFile()
+	: file_(nullptr), is_csv_(false), is_error_(false), num_players_(0), seed_(0), is_running_(false)
+{
+}
+
+/*--------------------------------------------------------------------------*
+Name:           ~ExportFile
+
+Description:	Destructor, closes the file.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+ExportFile::~ExportFile()
+{
+	Close();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Open
+
+Description:	Create the export file and start the writer thread.
+
+Arguments:      path: Export file.
+				is_csv: Write CSV lines instead of binary blocks.
+
+Returns:        false if the file can't be written.
+*---------------------------------------------------------------------------*/
+bool ExportFile::Open(const char *path, bool is_csv)
+{
+	Close();
+
+	file_ = std::fopen(path, is_csv ? "w" : "wb");
+	if (file_ == nullptr)
+		return false;
+
+	is_csv_ = is_csv;
+	is_error_ = false;
+
+	is_running_ = true;
+	writer_ = std::thread(&ExportFile::RunWriter, this);
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           WriteHeader
+
+Description:	Write the header of the file (CSV: the line of column names).
+				Call it once, before any block is submitted.
+
+Arguments:      num_players: Number of players.
+				num_cards_per_player: Number of cards each player has.
+				limit: Running total limit.
+				seed: Random seed of the engine.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void ExportFile::WriteHeader(int num_players, int num_cards_per_player, int limit, unsigned long long seed)
+{
+	num_players_ = num_players;
+	seed_ = seed;
+
+	if (is_csv_)
+	{
+		std::fprintf(file_, "seed,game,rounds,turns,winner");
+		for (int i = 0; i < num_players; ++i)
+			std::fprintf(file_, ",ai%d", i);
+		for (int i = 0; i < num_players; ++i)
+			std::fprintf(file_, ",out%d", i);
+		std::fprintf(file_, "\n");
+		return;
+	}
+
+	unsigned int values[4] = { (unsigned int)num_players, (unsigned int)num_cards_per_player, (unsigned int)limit,
+		(unsigned int)EXPORT_BLOCK_ROWS };
+
+	if ((std::fwrite(EXPORT_MAGIC, sizeof(EXPORT_MAGIC), 1, file_) != 1) || (std::fwrite(values, sizeof(values), 1, file_) != 1) ||
+		(std::fwrite(&seed, sizeof(seed), 1, file_) != 1))
+		is_error_ = true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Close
+
+Description:	Write the blocks left in the queue, stop the writer and close
+				the file. Writers must be flushed before.
+
+Arguments:      None.
+
+Returns:        false if a write failed.
+*---------------------------------------------------------------------------*/
+bool ExportFile::Close(void)
+{
+	if (writer_.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			is_running_ = false;
+		}
+		queue_ready_.notify_one();
+		writer_.join();
+	}
+
+	if (file_ != nullptr)
+	{
+		if (std::fclose(file_) != 0)
+			is_error_ = true;
+		file_ = nullptr;
+	}
+
+	for (size_t i = 0; i < blocks_.size(); ++i)
+		delete blocks_[i];
+	blocks_.clear();
+	free_.clear();
+
+	return !is_error_;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Acquire
+
+Description:	Get an empty block. Blocks are reused once written, a new one
+				is only allocated when every block is being filled or queued,
+				and threads wait while EXPORT_QUEUE_BLOCKS blocks are queued.
+
+Arguments:      None.
+
+Returns:        Empty block.
+*---------------------------------------------------------------------------*/
+ExportBlock *ExportFile::Acquire(void)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (queue_.size() >= (size_t)EXPORT_QUEUE_BLOCKS)
+		queue_room_.wait(lock);
+
+	ExportBlock *block;
+	if (free_.empty())
+	{
+		block = new ExportBlock;
+		blocks_.push_back(block);
+	}
+	else
+	{
+		block = free_.back();
+		free_.pop_back();
+	}
+
+	block->num_rows_ = 0;
+
+	return block;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Submit
+
+Description:	Queue a filled block for the writer.
+
+Arguments:      block: Block from Acquire.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void ExportFile::Submit(ExportBlock *block)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		queue_.push_back(block);
+	}
+	queue_ready_.notify_one();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Flush
+
+Description:	Hand the rows added so far to the writer.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void ExportWriter::Flush(void)
+{
+	if (block_ == nullptr)
+		return;
+
+	file_->Submit(block_);
+	block_ = nullptr;
+}
+
+// private functions
+
+/*--------------------------------------------------------------------------*
+Name:           RunWriter
+
+Description:	Writer thread. Write the queued blocks in order until the file
+				is closed and the queue is empty.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void ExportFile::RunWriter(void)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	for (;;)
+	{
+		while (queue_.empty() && is_running_)
+			queue_ready_.wait(lock);
+
+		if (queue_.empty())
+			break;
+
+		ExportBlock *block = queue_.front();
+		queue_.pop_front();
+
+		// write without holding the lock, threads keep filling their blocks
+		lock.unlock();
+		WriteBlock(*block);
+		lock.lock();
+
+		free_.push_back(block);
+		queue_room_.notify_all();
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           WriteBlock
+
+Description:	Write a block as binary columns (padded to 8 bytes) or as CSV
+				lines.
+
+Arguments:      block: Block of rows.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void ExportFile::WriteBlock(const ExportBlock &block)
+{
+	int num_rows = block.num_rows_;
+
+	if (is_csv_)
+	{
+		for (int row = 0; row < num_rows; ++row)
+		{
+			std::fprintf(file_, "%llu,%u,%u,%u,%d", seed_, block.game_[row], block.rounds_[row], block.turns_[row], block.winner_[row]);
+			for (int i = 0; i < num_players_; ++i)
+				std::fprintf(file_, ",%d", block.ai_[i][row]);
+			for (int i = 0; i < num_players_; ++i)
+				std::fprintf(file_, ",%d", block.out_[i][row]);
+			if (std::fprintf(file_, "\n") < 0)
+				is_error_ = true;
+		}
+		return;
+	}
+
+	unsigned int header[2];
+	std::memcpy(&header[0], EXPORT_BLOCK_MAGIC, sizeof(EXPORT_BLOCK_MAGIC));
+	header[1] = (unsigned int)num_rows;
+
+	size_t size = sizeof(header);
+	bool is_ok = (std::fwrite(header, sizeof(header), 1, file_) == 1);
+
+	// 32-bit columns first, they stay aligned
+	is_ok = is_ok && (std::fwrite(block.game_, sizeof(unsigned int), num_rows, file_) == (size_t)num_rows);
+	is_ok = is_ok && (std::fwrite(block.rounds_, sizeof(unsigned int), num_rows, file_) == (size_t)num_rows);
+	is_ok = is_ok && (std::fwrite(block.turns_, sizeof(unsigned int), num_rows, file_) == (size_t)num_rows);
+	is_ok = is_ok && (std::fwrite(block.winner_, 1, num_rows, file_) == (size_t)num_rows);
+	for (int i = 0; i < num_players_; ++i)
+		is_ok = is_ok && (std::fwrite(block.ai_[i], 1, num_rows, file_) == (size_t)num_rows);
+	for (int i = 0; i < num_players_; ++i)
+		is_ok = is_ok && (std::fwrite(block.out_[i], 1, num_rows, file_) == (size_t)num_rows);
+	size += (size_t)num_rows * (3 * sizeof(unsigned int) + 1 + 2 * num_players_);
+
+	static const char padding[8] = { 0 };
+	size_t num_padding = (8 - (size & 7)) & 7;
+	is_ok = is_ok && (std::fwrite(padding, 1, num_padding, file_) == num_padding);
+
+	if (!is_ok)
+		is_error_ = true;
+}
\ No newline at end of file
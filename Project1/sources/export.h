@@ -0,0 +1,130 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Per-game results export
+// one row per game: game index, rounds, turns, winner, AI of each seat and order in which each seat is defeated
+// binary file (little-endian):
+//   header: magic "NN99EX01", uint32 num_players, num_cards_per_player, limit, block_rows, uint64 seed (32 bytes)
+//   blocks of at most block_rows rows: uint32 magic "NNXB", uint32 num_rows, then whole columns one after another:
+//     uint32 game[num_rows], uint32 rounds[num_rows], uint32 turns[num_rows], uint8 winner[num_rows],
+//     uint8 ai[num_players][num_rows] (column of seat 0 first), uint8 out[num_players][num_rows] (0: winner, 1: first out)
+//   each block is padded with zeros to a multiple of 8 bytes
+// column offsets follow from num_rows, so a scan of one column seeks over the others and reads only its bytes
+// rows of a block are games of one thread in order, blocks of different threads are interleaved
+// the CSV file has the same columns (and the seed) in text, one line per game after a line of column names
+// each thread fills its own block, full blocks go to a writer thread through a queue of at most EXPORT_QUEUE_BLOCKS,
+// blocks are reused once written, so memory does not grow with the number of games
+
+#pragma once
+
+#include <condition_variable>	// std::condition_variable
+#include <cstdio>				// FILE
+#include <deque>
+#include <mutex>				// std::mutex
+#include <thread>				// std::thread
+#include <vector>
+
+#include "nintynine.h"
+
+namespace POKER
+{
+	// number of rows of a block
+	static const int EXPORT_BLOCK_ROWS = 65536;
+	// number of full blocks waiting for the writer before threads wait
+	static const int EXPORT_QUEUE_BLOCKS = 4;
+
+	// columns of a block of rows
+	struct ExportBlock
+	{
+		int num_rows_;										// number of rows
+		unsigned int game_[EXPORT_BLOCK_ROWS];				// game index
+		unsigned int rounds_[EXPORT_BLOCK_ROWS];			// number of rounds
+		unsigned int turns_[EXPORT_BLOCK_ROWS];				// number of turns
+		unsigned char winner_[EXPORT_BLOCK_ROWS];			// winner
+		unsigned char ai_[MAX_PLAYERS][EXPORT_BLOCK_ROWS];	// AI of each seat
+		unsigned char out_[MAX_PLAYERS][EXPORT_BLOCK_ROWS];	// order in which each seat is defeated (0: winner)
+	};
+
+	// export file and its writer thread
+	class ExportFile
+	{
+	public:
+		// constructor
+		ExportFile();
+		// destructor, closes the file
+		~ExportFile();
+
+		// create the file (CSV or binary) and start the writer, returns false if it can't be written
+		bool Open(const char *path, bool is_csv);
+		// write the header (rules and seed of the engine), before any block
+		void WriteHeader(int num_players, int num_cards_per_player, int limit, unsigned long long seed);
+		// write the blocks left, stop the writer and close the file, returns false on a write error
+		bool Close(void);
+
+		// get an empty block, waits while the queue is full
+		ExportBlock *Acquire(void);
+		// queue a filled block for the writer
+		void Submit(ExportBlock *block);
+
+	private:
+		FILE *file_;								// export file
+		bool is_csv_;								// CSV instead of binary
+		bool is_error_;								// a write failed
+		int num_players_;							// number of columns of seats
+		unsigned long long seed_;					// random seed (column of the CSV file)
+		std::vector<ExportBlock *> blocks_;			// every block allocated
+		std::vector<ExportBlock *> free_;			// blocks ready to be filled
+		std::deque<ExportBlock *> queue_;			// filled blocks waiting for the writer
+		std::mutex mutex_;							// guards free_, queue_ and is_running_
+		std::condition_variable queue_ready_;		// a block is queued or the file is closed
+		std::condition_variable queue_room_;		// a queued block is written
+		bool is_running_;							// the writer waits for more blocks
+		std::thread writer_;						// writer thread
+
+		// writer thread, writes the queued blocks until the file is closed
+		void RunWriter(void);
+		// write a block as binary columns or CSV lines
+		void WriteBlock(const ExportBlock &block);
+
+		// not copyable, it owns the file and the writer
+		ExportFile(const ExportFile &);
+		ExportFile &operator=(const ExportFile &);
+	};
+
+	// rows of the games played by one thread
+	class ExportWriter
+	{
+	public:
+		// constructor
+		explicit ExportWriter(ExportFile *file) : file_(file), block_(nullptr) {}
+
+		// add the row of a game just played on an engine
+		template <typename ENGINE>
+		void AddGame(int game_index, int winner, const ENGINE &game)
+		{
+			if (block_ == nullptr)
+				block_ = file_->Acquire();
+
+			int row = block_->num_rows_++;
+			block_->game_[row] = (unsigned int)game_index;
+			block_->rounds_[row] = (unsigned int)game.GetNumRounds();
+			block_->turns_[row] = (unsigned int)game.GetNumTurns();
+			block_->winner_[row] = (unsigned char)winner;
+			for (int i = 0; i < ENGINE::NUM_PLAYERS; ++i)
+			{
+				block_->ai_[i][row] = (unsigned char)game.GetPlayer(i).AI_;
+				block_->out_[i][row] = (unsigned char)game.GetOutRank(i);
+			}
+
+			if (block_->num_rows_ == EXPORT_BLOCK_ROWS)
+				Flush();
+		}
+		// hand the rows added so far to the writer
+		void Flush(void);
+
+	private:
+		ExportFile *file_;			// export file
+		ExportBlock *block_;		// block being filled (null: none yet)
+	};
+}
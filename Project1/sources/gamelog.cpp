@@ -0,0 +1,500 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Binary game log
+
+#include <cstring>		// std::memcmp, std::memcpy, std::memset
+
+#include "effects.h"
+#include "gamelog.h"
+
+using namespace POKER;
+
+// file id and version of a log file
+static const char LOG_MAGIC[8] = { 'N', 'N', '9', '9', 'G', 'L', '0', '4' };
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           ReplayGames
+
+Description:	Replay logged games matching the settings on an engine.
+
+Arguments:      reader: Opened log of games of this engine.
+				settings: Replay settings.
+				report: Result of the replay.
+
+Returns:        false if the games were played with other effects.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+static bool ReplayGames(GameLogReader &reader, const ReplaySettings &settings, ReplayReport &report)
+{
+	typedef NintyNineT<RULES> Engine;
+
+	Engine game(settings.is_display_, reader.GetSeed());
+	if (!game.SetEffects(settings.effects_) || (game.GetEffects()->GetHash() != reader.GetEffectsHash()))
+		return false;
+
+	SimResult &result = report.result_;
+
+	result.num_players_ = Engine::NUM_PLAYERS;
+	result.seed_ = reader.GetSeed();
+
+	GameRecord record;
+	bool is_first = true;
+
+	while (reader.Next(record))
+	{
+		++report.num_records_;
+
+		// filter on the record, games are only replayed if they match
+		if (((settings.game_ >= 0) && (record.game_ != settings.game_)) || (record.num_picks_ < settings.min_picks_))
+			continue;
+
+		if (is_first)
+		{
+			game.Initialize(record.ai_);
+			for (int i = 0; i < Engine::NUM_PLAYERS; ++i)
+				result.ai_[i] = record.ai_[i];
+			is_first = false;
+		}
+
+		// stats of a record are only kept if it replays to the end
+		GameStats stats;
+		int winner = game.Replay(record, stats);
+		if (winner < 0)
+		{
+			++report.num_errors_;
+			continue;
+		}
+
+		++stats.num_games_;
+		result.stats_.Merge(stats);
+		++result.win_player_[winner];
+	}
+
+	report.is_truncated_ = !reader.IsEnd();
+
+	return true;
+}
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           GameLogWriter
+
+Description:	Constructor.
+
+Arguments:      num_players: Number of players.
+				num_cards_per_player: Number of cards each player has.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+GameLogWriter::GameLogWriter(int num_players, int num_cards_per_player)
+	: num_players_(num_players), bits_(GetPickBits(num_cards_per_player)), game_(0), last_game_(-1), has_ai_(false)
+{
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Start
+
+Description:	Remove all records and start a range of games. Game indices are
+				stored as the distance from the previous game, so the range of
+				the next writer written to the file must start where this one ends.
+				AI of the first game are written in full.
+
+Arguments:      first_game: Index of the first game of the range.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void GameLogWriter::Start(int first_game)
+{
+	data_.clear();
+	last_game_ = first_game - 1;
+	has_ai_ = false;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           BeginGame
+
+Description:	Start recording a game.
+
+Arguments:      game: Index of the game (its random stream).
+				ai_list: AI of each player.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void GameLogWriter::BeginGame(int game, const int ai_list[])
+{
+	game_ = game;
+	for (int i = 0; i < num_players_; ++i)
+		ai_[i] = ai_list[i];
+
+	picks_.clear();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           EndGame
+
+Description:	Finish the game, encode its record.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void GameLogWriter::EndGame(void)
+{
+	// game index and AI, only the changes from the last game
+
+	bool is_ai_changed = !has_ai_;
+	for (int i = 0; (i < num_players_) && !is_ai_changed; ++i)
+		is_ai_changed = (ai_[i] != last_ai_[i]);
+
+	WriteVarint(((unsigned int)(game_ - last_game_ - 1) << 1) | (is_ai_changed ? 1 : 0));
+
+	if (is_ai_changed)
+	{
+		for (int i = 0; i < num_players_; i += 2)
+		{
+			unsigned char packed = 0;
+			for (int j = i; (j < i + 2) && (j < num_players_); ++j)
+				packed |= (unsigned char)(ai_[j] << ((j - i) * 4));
+			data_.push_back(packed);
+		}
+
+		for (int i = 0; i < num_players_; ++i)
+			last_ai_[i] = ai_[i];
+		has_ai_ = true;
+	}
+
+	last_game_ = game_;
+
+	// picks, packed from the lowest bit
+
+	int num_picks = (int)picks_.size();
+	WriteVarint(num_picks);
+
+	size_t start = data_.size();
+	data_.resize(start + (num_picks * bits_ + 7) / 8, 0);
+
+	unsigned char *out = &data_[0] + start;
+	for (int i = 0; i < num_picks; ++i)
+	{
+		int bit = i * bits_;
+		unsigned int data = picks_[i] << (bit & 7);
+
+		out[bit >> 3] |= (unsigned char)data;
+		if ((bit & 7) + bits_ > 8)
+			out[(bit >> 3) + 1] |= (unsigned char)(data >> 8);
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Open
+
+Description:	Create a log file.
+
+Arguments:      path: Path of the file.
+
+Returns:        false if the file can't be written.
+*---------------------------------------------------------------------------*/
+bool GameLogFile::Open(const char *path)
+{
+	file_.open(path, std::ios::binary | std::ios::trunc);
+
+	return file_.good();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           WriteHeader
+
+Description:	Write the header of the log (rules, effects and seed of the engine).
+
+Arguments:      num_players: Number of players.
+				num_cards_per_player: Number of cards each player has.
+				limit: Running total limit.
+				effects_hash: Hash of the effect table of the engine.
+				seed: Random seed of the engine.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void GameLogFile::WriteHeader(int num_players, int num_cards_per_player, int limit, unsigned long long effects_hash,
+	unsigned long long seed)
+{
+	GameLogHeader header;
+
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic_, LOG_MAGIC, sizeof(LOG_MAGIC));
+	header.num_players_ = num_players;
+	header.num_cards_per_player_ = num_cards_per_player;
+	header.limit_ = limit;
+	header.num_values_ = NUM_VALUES;
+	header.is_lazy_shuffle_ = USE_LAZY_SHUFFLE;
+	header.seed_ = seed;
+	header.effects_hash_ = effects_hash;
+
+	file_.write((const char *)&header, sizeof(header));
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Write
+
+Description:	Append records of a writer.
+
+Arguments:      writer: Recorded games.
+
+Returns:        false if the file can't be written.
+*---------------------------------------------------------------------------*/
+bool GameLogFile::Write(const GameLogWriter &writer)
+{
+	const std::vector<unsigned char> &data = writer.GetData();
+	if (!data.empty())
+		file_.write((const char *)&data[0], data.size());
+
+	return file_.good();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GameLogReader
+
+Description:	Constructor. The reader is empty until Open().
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+GameLogReader::GameLogReader()
+	: position_(0), last_game_(-1), bits_(0)
+{
+	std::memset(&header_, 0, sizeof(header_));
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Open
+
+Description:	Memory-map a log file.
+
+Arguments:      path: Path of the file.
+
+Returns:        false if the file is missing, has a different id or version,
+				or was written for other face values or another shuffle.
+*---------------------------------------------------------------------------*/
+bool GameLogReader::Open(const char *path)
+{
+	if (!file_.Open(path))
+		return false;
+
+	if ((file_.GetSize() < sizeof(header_)) ||
+		(std::memcmp(file_.GetData(), LOG_MAGIC, sizeof(LOG_MAGIC)) != 0))
+	{
+		file_.Close();
+		return false;
+	}
+
+	std::memcpy(&header_, file_.GetData(), sizeof(header_));
+
+	if ((header_.num_values_ != NUM_VALUES) || (header_.is_lazy_shuffle_ != (unsigned int)USE_LAZY_SHUFFLE) ||
+		(header_.num_players_ > MAX_PLAYERS) ||
+		(header_.num_cards_per_player_ < 1))
+	{
+		file_.Close();
+		return false;
+	}
+
+	bits_ = GetPickBits(header_.num_cards_per_player_);
+	Rewind();
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Rewind
+
+Description:	Go back to the first record.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void GameLogReader::Rewind(void)
+{
+	position_ = sizeof(header_);
+	last_game_ = -1;
+	for (int i = 0; i < MAX_PLAYERS; ++i)
+		ai_[i] = AI_SMART;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Next
+
+Description:	Read the next record. Picks are not decoded or copied,
+				the record points into the mapped file.
+
+Arguments:      record: The record read.
+
+Returns:        false at the end of the log or on a broken record.
+*---------------------------------------------------------------------------*/
+bool GameLogReader::Next(GameRecord &record)
+{
+	size_t start = position_;
+
+	// game index and AI
+
+	unsigned int code;
+	if (!ReadVarint(code))
+	{
+		position_ = start;
+		return false;
+	}
+
+	if (code & 1)
+	{
+		int num_players = header_.num_players_;
+		int num_bytes = (num_players + 1) / 2;
+		if (position_ + num_bytes > file_.GetSize())
+		{
+			position_ = start;
+			return false;
+		}
+
+		const unsigned char *data = file_.GetData() + position_;
+		for (int i = 0; i < num_players; ++i)
+			ai_[i] = (data[i / 2] >> ((i % 2) * 4)) & 0x0F;
+
+		position_ += num_bytes;
+	}
+
+	// picks
+
+	unsigned int num_picks;
+	if (!ReadVarint(num_picks))
+	{
+		position_ = start;
+		return false;
+	}
+
+	size_t num_bytes = ((size_t)num_picks * bits_ + 7) / 8;
+	if (position_ + num_bytes > file_.GetSize())
+	{
+		position_ = start;
+		return false;
+	}
+
+	last_game_ += (int)(code >> 1) + 1;
+
+	record.game_ = last_game_;
+	for (int i = 0; i < MAX_PLAYERS; ++i)
+		record.ai_[i] = ai_[i];
+	record.num_picks_ = (int)num_picks;
+	record.bits_ = bits_;
+	record.picks_ = file_.GetData() + position_;
+
+	position_ += num_bytes;
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetPickBits
+
+Description:	Bits needed to store a card slot.
+
+Arguments:      num_cards_per_player: Number of cards each player has.
+
+Returns:        Number of bits (1 ~ 8).
+*---------------------------------------------------------------------------*/
+int POKER::GetPickBits(int num_cards_per_player)
+{
+	int bits = 1;
+	while ((1 << bits) < num_cards_per_player)
+		++bits;
+
+	return bits;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           RunReplay
+
+Description:	Replay logged games matching the settings on the engine
+				compiled for the rules of the log.
+
+Arguments:      path: Path of the log file.
+				settings: Replay settings.
+				report: Result of the replay.
+
+Returns:        false if the log can't be read, no engine is compiled for its rules,
+				or the games were played with other effects than settings.
+*---------------------------------------------------------------------------*/
+bool POKER::RunReplay(const char *path, const ReplaySettings &settings, ReplayReport &report)
+{
+	GameLogReader reader;
+	if (!reader.Open(path) || (reader.GetLimit() != RUNNING_TOTAL_LIMIT))
+		return false;
+
+	report.result_.confidence_ = STOP_CONFIDENCE;
+
+#define NINTYNINE_REPLAY(players, cards)															\
+	if ((reader.GetNumPlayers() == players) && (reader.GetNumCardsPerPlayer() == cards))		\
+	{																							\
+		return ReplayGames<Rules<players, cards> >(reader, settings, report);					\
+	}
+
+	NINTYNINE_CONFIGS(NINTYNINE_REPLAY)
+#undef NINTYNINE_REPLAY
+
+	return false;
+}
+
+// private functions
+
+/*--------------------------------------------------------------------------*
+Name:           WriteVarint
+
+Description:	Write a variable-length integer, 7 bits per byte from the lowest bits,
+				the highest bit of a byte is set if more bytes follow.
+
+Arguments:      value: Value to be written.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void GameLogWriter::WriteVarint(unsigned int value)
+{
+	while (value >= 0x80)
+	{
+		data_.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+
+	data_.push_back((unsigned char)value);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           ReadVarint
+
+Description:	Read a variable-length integer (see WriteVarint).
+
+Arguments:      value: Value read.
+
+Returns:        false past the end of the file.
+*---------------------------------------------------------------------------*/
+bool GameLogReader::ReadVarint(unsigned int &value)
+{
+	const unsigned char *data = file_.GetData();
+	size_t size = file_.GetSize();
+
+	value = 0;
+	for (int shift = 0; shift < 35; shift += 7)
+	{
+		if (position_ >= size)
+			return false;
+
+		unsigned char byte = data[position_++];
+		value |= (unsigned int)(byte & 0x7F) << shift;
+
+		if ((byte & 0x80) == 0)
+			return true;
+	}
+
+	return false;
+}
\ No newline at end of file
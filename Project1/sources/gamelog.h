@@ -0,0 +1,179 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Binary game log
+// in counter-based mode a game is fully defined by (seed, game index, AI of each seat, card picked each turn),
+// deck order and running totals are re-derived by replaying the picks on the engine
+// a log is a header followed by one record per game:
+//   varint (game index delta << 1 | AI changed), [AI of each seat, 4 bits each], varint number of picks,
+//   picks packed with just enough bits for a card slot (3 bits for 5 cards)
+// the game index delta is 0 for consecutive games, AI are only written when they change
+// so a game of the default rules takes about 80 bytes
+// logs are read through a memory mapping, records point into the file and are never copied
+
+#pragma once
+
+#include <fstream>
+#include <vector>
+
+#include "mapfile.h"
+#include "nintynine.h"
+#include "simulation.h"
+
+namespace POKER
+{
+	// number of games kept in memory by each thread before they are written to the log
+	static const int LOG_CHUNK_GAMES = 100000;
+
+	// header of a log file
+	struct GameLogHeader
+	{
+		char magic_[8];						// file id and version
+		unsigned int num_players_;			// number of players
+		unsigned int num_cards_per_player_;	// number of cards each player has
+		unsigned int limit_;				// running total limit
+		unsigned int num_values_;			// number of face values
+		unsigned int is_lazy_shuffle_;		// deck shuffled lazily (USE_LAZY_SHUFFLE), deals depend on it
+		unsigned long long seed_;			// random seed of the engine
+		unsigned long long effects_hash_;	// hash of the effect table played (see EffectTable::GetHash)
+	};
+
+	// a game read from a log, picks point into the mapped file
+	struct GameRecord
+	{
+		int game_;							// game index (random stream of the game)
+		int ai_[MAX_PLAYERS];				// AI of each seat
+		int num_picks_;						// number of cards dealt
+		int bits_;							// bits of each pick
+		const unsigned char *picks_;		// packed picks
+
+		// card slot picked by the n-th card dealt
+		int GetPick(int n) const
+		{
+			int bit = n * bits_;
+			unsigned int data = picks_[bit >> 3];
+			if ((bit & 7) + bits_ > 8)
+				data |= picks_[(bit >> 3) + 1] << 8;
+
+			return (data >> (bit & 7)) & ((1 << bits_) - 1);
+		}
+	};
+
+	// records games in memory (one writer per thread), records are moved to a GameLogFile in game order
+	class GameLogWriter
+	{
+	public:
+		// constructor
+		GameLogWriter(int num_players, int num_cards_per_player);
+
+		// remove all records, start a range of games from first_game (AI of the first game are written in full)
+		// records of consecutive ranges can be written to a file one after another
+		void Start(int first_game);
+		// start recording a game
+		void BeginGame(int game, const int ai_list[]);
+		// record the card slot picked by a player
+		void AddPick(int index) { picks_.push_back((unsigned char)index); }
+		// finish the game, encode its record
+		void EndGame(void);
+
+		// encoded records
+		const std::vector<unsigned char> &GetData(void) const { return data_; }
+
+	private:
+		int num_players_;						// number of players
+		int bits_;								// bits of each pick
+		int game_;								// index of the game being recorded
+		int last_game_;							// index of the last game recorded
+		int ai_[MAX_PLAYERS];					// AI of the game being recorded
+		int last_ai_[MAX_PLAYERS];				// AI of the last game recorded
+		bool has_ai_;							// last_ai_ is set
+		std::vector<unsigned char> picks_;		// picks of the game being recorded
+		std::vector<unsigned char> data_;		// encoded records
+
+		// write a variable-length integer (7 bits per byte)
+		void WriteVarint(unsigned int value);
+	};
+
+	// log file being written
+	class GameLogFile
+	{
+	public:
+		// create the file, returns false if it can't be written
+		bool Open(const char *path);
+		// write the header (rules, effects and seed of the engine)
+		void WriteHeader(int num_players, int num_cards_per_player, int limit, unsigned long long effects_hash,
+			unsigned long long seed);
+		// append records of a writer, returns false on error
+		bool Write(const GameLogWriter &writer);
+
+	private:
+		std::ofstream file_;					// the log file
+	};
+
+	// memory-mapped log file
+	class GameLogReader
+	{
+	public:
+		// constructor
+		GameLogReader();
+
+		// map a log file, returns false if it's missing or not a game log
+		bool Open(const char *path);
+		// go back to the first record
+		void Rewind(void);
+		// read the next record, returns false at the end of the log or on a broken record
+		bool Next(GameRecord &record);
+		// every record is read and the log is not truncated
+		bool IsEnd(void) const { return position_ == file_.GetSize(); }
+
+		// rules and seed of the logged games
+		int GetNumPlayers(void) const { return header_.num_players_; }
+		int GetNumCardsPerPlayer(void) const { return header_.num_cards_per_player_; }
+		int GetLimit(void) const { return header_.limit_; }
+		unsigned long long GetSeed(void) const { return header_.seed_; }
+		unsigned long long GetEffectsHash(void) const { return header_.effects_hash_; }
+
+	private:
+		GameLogHeader header_;					// header of the log
+		MappedFile file_;						// content of the log
+		size_t position_;						// offset of the next record
+		int last_game_;							// index of the last game read
+		int ai_[MAX_PLAYERS];					// AI of the last game read
+		int bits_;								// bits of each pick
+
+		// read a variable-length integer, returns false past the end of the file
+		bool ReadVarint(unsigned int &value);
+	};
+
+	// settings of a replay
+	struct ReplaySettings
+	{
+		int game_;						// only replay this game (-1: all games)
+		int min_picks_;					// only replay games with at least this many cards dealt
+		bool is_display_;				// display game info (same as DISPLAY_GAME)
+		const EffectTable *effects_;	// card effects the games were played with (null: special cards of the rules)
+
+		// constructor
+		ReplaySettings() : game_(-1), min_picks_(0), is_display_(false), effects_(nullptr) {}
+	};
+
+	// result of a replay
+	struct ReplayReport
+	{
+		SimResult result_;				// stats of replayed games
+		int num_records_;				// number of records in the log
+		int num_errors_;				// number of records that can't be replayed on their engine
+		bool is_truncated_;				// log ends in the middle of a record
+
+		// constructor
+		ReplayReport() : num_records_(0), num_errors_(0), is_truncated_(false) {}
+	};
+
+	// bits needed to store a card slot
+	int GetPickBits(int num_cards_per_player);
+
+	// replay logged games matching the settings on the engine of the logged rules
+	// returns false if the log can't be read or no engine is compiled for its rules
+	bool RunReplay(const char *path, const ReplaySettings &settings, ReplayReport &report);
+}
@@ -0,0 +1,148 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Read-only memory-mapped file
+
+#include "mapfile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace POKER;
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           MappedFile
+
+Description:	Constructor.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+MappedFile::MappedFile()
+	: data_(nullptr), size_(0)
+#ifdef _WIN32
+	, file_(INVALID_HANDLE_VALUE), mapping_(nullptr)
+#endif
+{
+}
+
+/*--------------------------------------------------------------------------*
+Name:           ~MappedFile
+
+Description:	Destructor.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Open
+
+Description:	Map the whole file into memory (read-only).
+
+Arguments:      path: Path of the file.
+
+Returns:        false if the file can't be opened, mapped or is empty.
+*---------------------------------------------------------------------------*/
+bool MappedFile::Open(const char *path)
+{
+	Close();
+
+#ifdef _WIN32
+	file_ = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file_ == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file_, &size) || (size.QuadPart == 0))
+	{
+		Close();
+		return false;
+	}
+
+	mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_ == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	data_ = (const unsigned char *)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+	if (data_ == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	size_ = (size_t)size.QuadPart;
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || (st.st_size == 0))
+	{
+		close(fd);
+		return false;
+	}
+
+	void *data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	// the mapping keeps the file alive, the descriptor is not needed anymore
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	data_ = (const unsigned char *)data;
+	size_ = (size_t)st.st_size;
+#endif
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Close
+
+Description:	Unmap the file.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void MappedFile::Close(void)
+{
+#ifdef _WIN32
+	if (data_ != nullptr)
+		UnmapViewOfFile(data_);
+	if (mapping_ != nullptr)
+		CloseHandle(mapping_);
+	if (file_ != INVALID_HANDLE_VALUE)
+		CloseHandle(file_);
+
+	mapping_ = nullptr;
+	file_ = INVALID_HANDLE_VALUE;
+#else
+	if (data_ != nullptr)
+		munmap((void *)data_, size_);
+#endif
+
+	data_ = nullptr;
+	size_ = 0;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Read-only memory-mapped file
+// the file stays mapped until Close() or destruction, so pointers into GetData() are valid until then
+
+#pragma once
+
+#include <cstddef>
+
+namespace POKER
+{
+	class MappedFile
+	{
+	public:
+		// constructor
+		MappedFile();
+		// destructor
+		~MappedFile();
+
+		// map the whole file into memory, returns false if it can't be opened or is empty
+		bool Open(const char *path);
+		// unmap the file
+		void Close(void);
+
+		// mapped content of the file (null if not open)
+		const unsigned char *GetData(void) const { return data_; }
+		// size of the file in bytes
+		size_t GetSize(void) const { return size_; }
+
+	private:
+		const unsigned char *data_;		// mapped content
+		size_t size_;					// size of the file
+#ifdef _WIN32
+		void *file_;					// file handle
+		void *mapping_;					// file mapping handle
+#endif
+
+		// not copyable, it owns the mapping
+		MappedFile(const MappedFile &);
+		MappedFile &operator=(const MappedFile &);
+	};
+}
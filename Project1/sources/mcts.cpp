@@ -0,0 +1,405 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Information set Monte Carlo tree search AI (AI 4)
+
+#include <chrono>		// std::chrono::steady_clock
+#include <cmath>		// std::sqrt, std::log
+
+#include "mcts.h"
+
+using namespace POKER;
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           MctsT
+
+Description:	Constructor. Trees are allocated on the first search.
+
+Arguments:      player_num: Seat of the MCTS player.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+MctsT<RULES>::MctsT(int player_num)
+	: player_num_(player_num), trees_(MCTS_THREADS), pool_(MCTS_THREADS), game_(0), last_played_(0), is_searched_(false)
+{
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Play
+
+Description:	Search the position of game, where the MCTS player is to move.
+				The trees keep what they found since the last move of this game,
+				each tree runs its share of the playouts (or runs until the time
+				budget is spent), and the face value visited most over all trees is dealt.
+
+Arguments:      game: Engine holding the position (not modified).
+
+Returns:        Index of the card to deal.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int MctsT<RULES>::Play(const Engine &game)
+{
+	const HandT<NUM_CARDS_PER_PLAYER> &hands = game.GetPlayer(player_num_).hands_;
+
+	if (!is_searched_ || (game.GetNumStarted() != game_) || (game.GetNumPlayed() < last_played_))
+		Reset(game);
+
+	pool_.Run(MCTS_THREADS, [&](int job, int)
+	{
+		Tree &tree = trees_[job];
+
+		if (tree.arena_[0].empty())
+		{
+			tree.arena_[0].resize(MCTS_NODES);
+			tree.arena_[1].resize(MCTS_NODES);
+		}
+
+		Advance(tree, game);
+		Search(tree, game, (MCTS_PLAYOUTS + MCTS_THREADS - 1 - job) / MCTS_THREADS);
+	});
+
+	// sum root visits of each face value
+
+	int visits[NUM_VALUES + 1] = {};
+
+	for (int i = 0; i < MCTS_THREADS; ++i)
+	{
+		const Tree &tree = trees_[i];
+		const std::vector<Node> &arena = tree.arena_[tree.active_];
+
+		for (int child = arena[tree.root_].child_; child >= 0; child = arena[child].sibling_)
+			visits[arena[child].value_] += arena[child].visits_;
+	}
+
+	int choice = 0;
+	for (int i = 1; i < NUM_CARDS_PER_PLAYER; ++i)
+	{
+		if (visits[hands[i].GetValue()] > visits[hands[choice].GetValue()])
+			choice = i;
+	}
+
+	last_played_ = game.GetNumPlayed();
+	is_searched_ = true;
+
+	return choice;
+}
+
+// private functions
+
+/*--------------------------------------------------------------------------*
+Name:           Reset
+
+Description:	Start a new game: clear the trees and reseed their generators.
+				In counter-based mode, game i is searched the same way whichever
+				engine (thread) plays it.
+
+Arguments:      game: Engine playing the game.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void MctsT<RULES>::Reset(const Engine &game)
+{
+	for (int i = 0; i < MCTS_THREADS; ++i)
+	{
+		trees_[i].root_ = -1;
+		trees_[i].rng_.Seed(game.GetSeed() + 1 + player_num_ * MCTS_THREADS + i, game.GetStream());
+	}
+
+	game_ = game.GetNumStarted();
+	is_searched_ = false;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Advance
+
+Description:	Follow the cards dealt since the last move down the tree. If every
+				one of them is there, its subtree is copied into the other arena and
+				becomes the root, otherwise (or without a last move) the tree restarts
+				from an empty root.
+
+Arguments:      tree: Tree of a thread.
+				game: Engine holding the position.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void MctsT<RULES>::Advance(Tree &tree, const Engine &game)
+{
+	int num_played = game.GetNumPlayed();
+	int node = tree.root_;
+
+	if (!is_searched_ || (num_played - last_played_ > Engine::PLAY_HISTORY))
+		node = -1;
+
+	const std::vector<Node> &arena = tree.arena_[tree.active_];
+
+	for (int i = last_played_; (i < num_played) && (node >= 0); ++i)
+	{
+		int child = arena[node].child_;
+		while ((child >= 0) && ((arena[child].value_ != game.GetPlayedValue(i)) || (arena[child].mover_ != game.GetPlayedBy(i))))
+			child = arena[child].sibling_;
+
+		node = child;
+	}
+
+	tree.active_ ^= 1;
+	tree.num_nodes_ = 0;
+
+	if (node >= 0)
+		tree.root_ = CopyNode(tree, node);
+	else
+		tree.root_ = NewNode(tree, 0, player_num_);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           CopyNode
+
+Description:	Copy a node of the inactive arena and all nodes below it into the
+				active arena. A subtree always fits, both arenas are the same size.
+
+Arguments:      tree: Tree of a thread.
+				node: Node of the inactive arena.
+
+Returns:        The copy.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int MctsT<RULES>::CopyNode(Tree &tree, int node)
+{
+	const std::vector<Node> &from = tree.arena_[tree.active_ ^ 1];
+	std::vector<Node> &to = tree.arena_[tree.active_];
+
+	int copy = NewNode(tree, from[node].value_, from[node].mover_);
+	to[copy].visits_ = from[node].visits_;
+	to[copy].avail_ = from[node].avail_;
+	to[copy].reward_ = from[node].reward_;
+
+	int last = -1;
+	for (int child = from[node].child_; child >= 0; child = from[child].sibling_)
+	{
+		int child_copy = CopyNode(tree, child);
+
+		if (last < 0)
+			to[copy].child_ = child_copy;
+		else
+			to[last].sibling_ = child_copy;
+
+		last = child_copy;
+	}
+
+	return copy;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           NewNode
+
+Description:	Take the next node of the active arena.
+
+Arguments:      tree: Tree of a thread.
+				value: Face value of the card.
+				mover: Player who deals it.
+
+Returns:        The node, or -1 if the arena is full.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int MctsT<RULES>::NewNode(Tree &tree, int value, int mover)
+{
+	if (tree.num_nodes_ >= MCTS_NODES)
+		return -1;
+
+	Node &node = tree.arena_[tree.active_][tree.num_nodes_];
+	node.child_ = -1;
+	node.sibling_ = -1;
+	node.visits_ = 0;
+	node.avail_ = 0;
+	node.reward_ = 0.0f;
+	node.value_ = (unsigned char)value;
+	node.mover_ = (unsigned char)mover;
+
+	return tree.num_nodes_++;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Search
+
+Description:	Run playouts on a tree. With a time budget (MCTS_TIME_MS), playouts
+				run until it is spent (the clock is read every 16 playouts).
+
+Arguments:      tree: Tree of a thread.
+				game: Engine holding the position.
+				num_playouts: Number of playouts (without a time budget).
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void MctsT<RULES>::Search(Tree &tree, const Engine &game, int num_playouts)
+{
+	// one copy of the engine per search, each playout restores the position into it
+	Engine state = game;
+	GameState root;
+	state.Snapshot(root, player_num_);
+
+	if (MCTS_TIME_MS <= 0)
+	{
+		for (int i = 0; i < num_playouts; ++i)
+			Playout(tree, state, root);
+
+		return;
+	}
+
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(MCTS_TIME_MS);
+
+	do
+	{
+		for (int i = 0; i < 16; ++i)
+			Playout(tree, state, root);
+	} while (std::chrono::steady_clock::now() < end);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Playout
+
+Description:	One playout on a determinized copy of the root position.
+				In the tree, the mover deals the face value with the best UCB score
+				among the ones in its hands, until a value not tried yet is found;
+				that one is added to the tree. Then cards are picked by the smart AI
+				(MCTS_ROLLOUT_RANDOM% at random) until a player is defeated.
+				Every node on the path scores 1 for its mover if it's not that player.
+
+Arguments:      tree: Tree of a thread.
+				state: Private engine of the search.
+				root: State of the position searched.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void MctsT<RULES>::Playout(Tree &tree, Engine &state, const GameState &root)
+{
+	state.Restore(root);
+	state.Determinize(player_num_, tree.rng_);
+
+	std::vector<Node> &arena = tree.arena_[tree.active_];
+	int path[MCTS_ROLLOUT_TURNS + 1];
+	int path_length = 0;
+	int node = tree.root_;
+	int mover = player_num_;
+	int players_left = state.GetPlayersLeft();
+	int loser = -1;
+
+	path[path_length++] = node;
+
+	for (int turn = 0; turn < MCTS_ROLLOUT_TURNS; ++turn)
+	{
+		const HandT<NUM_CARDS_PER_PLAYER> &hands = state.GetPlayer(mover).hands_;
+		int index = 0;
+
+		if (node >= 0)
+		{
+			// face values in the hands, the ones with a child are tried
+
+			unsigned int values = 0;
+			for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
+				values |= 1u << hands[i].GetValue();
+
+			unsigned int tried = 0;
+			int best = -1;
+			float best_score = 0.0f;
+
+			for (int child = arena[node].child_; child >= 0; child = arena[child].sibling_)
+			{
+				Node &option = arena[child];
+				if ((values & (1u << option.value_)) == 0)
+					continue;
+
+				tried |= 1u << option.value_;
+				++option.avail_;
+
+				float score = option.reward_ / option.visits_
+					+ MCTS_EXPLORATION * std::sqrt(std::log((float)option.avail_) / option.visits_);
+				if ((best < 0) || (score > best_score))
+				{
+					best = child;
+					best_score = score;
+				}
+			}
+
+			unsigned int untried = values & ~tried;
+			int value;
+
+			if (untried != 0)
+			{
+				// expand a random untried value
+
+				int options[NUM_CARDS_PER_PLAYER];
+				int num_options = 0;
+				for (value = 0; untried != 0; ++value, untried >>= 1)
+				{
+					if (untried & 1)
+						options[num_options++] = value;
+				}
+
+				value = options[tree.rng_.Range(num_options)];
+
+				int child = NewNode(tree, value, mover);
+				if (child >= 0)
+				{
+					arena[child].sibling_ = arena[node].child_;
+					arena[node].child_ = child;
+					arena[child].avail_ = 1;
+					path[path_length++] = child;
+				}
+
+				node = -1;
+			}
+			else
+			{
+				value = arena[best].value_;
+				node = best;
+				path[path_length++] = node;
+			}
+
+			while (hands[index].GetValue() != value)
+				++index;
+		}
+		else if (tree.rng_.Range(100) < MCTS_ROLLOUT_RANDOM)
+			index = tree.rng_.Range(NUM_CARDS_PER_PLAYER);
+		else
+			index = state.GetPlayer(mover).PlayerSmart(state.GetRunningTotal());
+
+		bool is_end = state.PlayCard(mover, index);
+
+		if (is_end || (state.GetPlayersLeft() < players_left))
+		{
+			loser = mover;
+			break;
+		}
+
+		do
+		{
+			mover = state.NextPlayer(mover);
+		} while (state.GetPlayer(mover).is_defeat_);
+	}
+
+	// back up the scores
+
+	for (int i = 0; i < path_length; ++i)
+	{
+		Node &visited = arena[path[i]];
+
+		++visited.visits_;
+		if (loser < 0)
+			visited.reward_ += 0.5f;
+		else if (visited.mover_ != loser)
+			visited.reward_ += 1.0f;
+	}
+}
+
+// pre-instantiated searches
+
+#define NINTYNINE_INSTANTIATE(players, cards) template class POKER::MctsT<Rules<players, cards> >;
+NINTYNINE_CONFIGS(NINTYNINE_INSTANTIATE)
+#undef NINTYNINE_INSTANTIATE
\ No newline at end of file
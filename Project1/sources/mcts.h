@@ -0,0 +1,101 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Information set Monte Carlo tree search AI (AI 4)
+// the player only knows its own hands, so every playout restores a snapshot of the position
+// into a private engine (see GameStateT) and determinizes it:
+// hands of other players and the rest of the deck are redealt at random from the cards it can't see
+// one tree is shared by all determinizations (single observer ISMCTS), a move is a face value,
+// and children are scored by UCB over the playouts where their card could be dealt
+// a playout ends at the first player defeated, that player scores 0 and every other player scores 1
+// nodes live in two preallocated arenas: after a move, the subtree of the cards dealt since
+// is copied into the other arena and becomes the root of the next search
+// trees of MCTS_THREADS threads are searched on their own and their root visits summed (root parallelism)
+
+#pragma once
+
+#include <vector>
+
+#include "nintynine.h"
+#include "workpool.h"
+
+namespace POKER
+{
+	// playouts per move (split across threads), used if MCTS_TIME_MS is 0
+	static const int MCTS_PLAYOUTS			= 1000;
+	// time budget per move in milliseconds (0: use MCTS_PLAYOUTS, so games are repeatable)
+	static const int MCTS_TIME_MS			= 0;
+	// number of trees searched at the same time
+	static const int MCTS_THREADS			= 1;
+	// UCB exploration constant
+	static const float MCTS_EXPLORATION		= 0.7f;
+	// max number of nodes of each arena (24 bytes each)
+	static const int MCTS_NODES				= 1 << 16;
+	// percentage of random cards dealt in playouts (other cards are picked by the smart AI)
+	static const int MCTS_ROLLOUT_RANDOM	= 10;
+	// max number of turns of a playout (a playout nobody loses scores 0.5 for every player)
+	static const int MCTS_ROLLOUT_TURNS		= 200;
+
+	template <typename RULES>
+	class MctsT
+	{
+	public:
+		NINTYNINE_RULE_PARAMETERS(RULES)
+
+		typedef NintyNineT<RULES> Engine;
+		typedef GameStateT<RULES> GameState;
+
+		// constructor (player_num: seat of the MCTS player)
+		MctsT(int player_num);
+
+		// search the position of game (player_num is to move), returns the index of the card to deal
+		int Play(const Engine &game);
+
+	private:
+		// tree node, a card dealt by mover_ (the root has no card)
+		struct Node
+		{
+			int child_;				// first child (-1: none)
+			int sibling_;			// next child of the parent (-1: none)
+			int visits_;			// number of playouts through this node
+			int avail_;				// number of playouts where this card could be dealt
+			float reward_;			// total score of mover_
+			unsigned char value_;	// face value of the card
+			unsigned char mover_;	// player who deals it
+		};
+
+		// tree of a thread, padded so trees of different threads never share a cache line
+		struct Tree
+		{
+			std::vector<Node> arena_[2];	// node arenas (allocated on the first search)
+			int active_;					// arena holding the tree
+			int num_nodes_;					// nodes used in the active arena
+			int root_;						// root node (-1: no tree)
+			Random rng_;					// draws determinizations and playout choices
+			char padding_[CACHE_LINE_SIZE];
+
+			Tree() : active_(0), num_nodes_(0), root_(-1) {}
+		};
+
+		int player_num_;					// seat of the MCTS player
+		std::vector<Tree> trees_;			// tree of each thread
+		WorkPool pool_;						// runs the trees
+		unsigned int game_;					// game searched last (count of games started by the engine)
+		int last_played_;					// cards dealt in that game before the last move
+		bool is_searched_;					// there's a last move to reuse the trees from
+
+		// start a new game: reseed and clear the trees
+		void Reset(const Engine &game);
+		// move the root of a tree to the cards dealt since the last search, clear it if they're not in it
+		void Advance(Tree &tree, const Engine &game);
+		// copy a subtree into the other arena, returns the new node
+		int CopyNode(Tree &tree, int node);
+		// allocate a node of the active arena, returns -1 if full
+		int NewNode(Tree &tree, int value, int mover);
+		// run playouts on a tree (num_playouts, or until the time budget is spent)
+		void Search(Tree &tree, const Engine &game, int num_playouts);
+		// one determinized playout from the root state on a private engine
+		void Playout(Tree &tree, Engine &state, const GameState &root);
+	};
+}
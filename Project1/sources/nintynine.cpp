@@ -2,14 +2,54 @@
 // Updated: 11/16/2014
 // All content © 2014 DigiPen(USA) Corporation, all rights reserved.
 
-#include <algorithm>	// std::random_shuffle
+#include <algorithm>	// std::swap, std::copy
+#include <cmath>		// std::sqrt
 #include <ctime>        // std::time
-#include <cstdlib>		// std::rand
 
+#include "decision.h"
+#include "effects.h"
+#include "gamelog.h"
+#include "mcts.h"
 #include "nintynine.h"
+#include "strategy.h"
+#include "trace.h"
 
 using namespace POKER;
 
+// the default rules must be one of the compiled configurations
+#define NINTYNINE_IS_DEFAULT_CONFIG(players, cards) || ((players == NUM_PLAYERS) && (cards == NUM_CARDS_PER_PLAYER))
+static_assert(false NINTYNINE_CONFIGS(NINTYNINE_IS_DEFAULT_CONFIG),
+	"(NUM_PLAYERS, NUM_CARDS_PER_PLAYER) must be listed in NINTYNINE_CONFIGS");
+#undef NINTYNINE_IS_DEFAULT_CONFIG
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           GetRulesEffects
+
+Description:	Effects of the special cards of a rule set, compiled once.
+
+Arguments:      None.
+
+Returns:        Compiled effects.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+static const EffectTable *GetRulesEffects(void)
+{
+	struct RulesEffects : public CardEffects
+	{
+		RulesEffects()
+		{
+			SetSpecials(RULES::SP_10, RULES::SP_20, RULES::SP_99, RULES::SP_REVERSE, RULES::SP_SKIP, RULES::SP_PICK,
+				RULES::RUNNING_TOTAL_LIMIT);
+		}
+	};
+
+	static const EffectTable table(RulesEffects(), RULES::RUNNING_TOTAL_LIMIT);
+
+	return &table;
+}
+
 // public functions
 
 /*--------------------------------------------------------------------------*
@@ -17,14 +57,28 @@ Name:           NintyNine
 
 Description:	Constructor.
 
-Arguments:      is_display: Should the game info be displayed.
+Arguments:      is_display: Should the game info be displayed (traced to the console).
+				seed: Random seed (0 means seed from current time).
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-NintyNine::NintyNine(bool is_display)
-	: deck_index_(0), total_(0), players_left_(NUM_PLAYERS), is_order_increase_(true), is_display_(is_display)
+template <typename RULES>
+NintyNineT<RULES>::NintyNineT(bool is_display, unsigned long long seed)
+	: deck_index_(0), total_(0), players_left_(NUM_PLAYERS), active_mask_((1u << NUM_PLAYERS) - 1), is_order_increase_(true),
+	is_antithetic_(false), seed_(seed), stream_(0), num_played_(0), num_started_(0), num_rounds_(0), num_turns_(0), log_(nullptr),
+	trace_(is_display ? GetConsoleTrace() : nullptr), trace_level_(TRACE_OFF), trace_game_(0),
+	replay_(nullptr), replay_pick_(0), is_replay_error_(false)
 {
-	std::srand(unsigned(std::time(0)));
+	if (seed_ == 0)
+		seed_ = (unsigned long long)std::time(0);
+
+	rng_.Seed(seed_);
+
+	std::fill(strategy_, strategy_ + NUM_PLAYERS, nullptr);
+	effects_ = GetRulesEffects<RULES>();
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+		players_[i].effects_ = effects_;
+	std::fill(out_rank_, out_rank_ + NUM_PLAYERS, 0);
 }
 
 /*--------------------------------------------------------------------------*
@@ -36,7 +90,8 @@ Arguments:      None.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-NintyNine::~NintyNine()
+template <typename RULES>
+NintyNineT<RULES>::~NintyNineT()
 {
 }
 
@@ -49,31 +104,46 @@ Arguments:      None.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-void NintyNine::Initialize(void)
+template <typename RULES>
+void NintyNineT<RULES>::Initialize(void)
 {
 	InitPlayers();
 	CreateDeck();
 }
 
+/*--------------------------------------------------------------------------*
+Name:           Initialize
+
+Description:	Initialize the game with a given AI for each player.
+				Used by simulation threads to share the line-up of the main engine.
+
+Arguments:      ai_list: AI of each player.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void NintyNineT<RULES>::Initialize(const int ai_list[])
+{
+	InitPlayers(ai_list);
+	CreateDeck();
+}
+
 /*--------------------------------------------------------------------------*
 Name:           Play
 
-Description:	Only play a single game, returns the winner
+Description:	Only play a single game, returns the winner.
+				Defeated players are left out of the turn order, so turns
+				and rounds only count cards dealt.
 
 Arguments:      stats: record game stats.
 
 Returns:        Winner id.
 *---------------------------------------------------------------------------*/
-int NintyNine::Play(GameStats &stats)
+template <typename RULES>
+int NintyNineT<RULES>::Play(GameStats &stats)
 {
 	// initialize a game
-	deck_index_ = 0;
-	total_ = 0;
-	players_left_ = NUM_PLAYERS;
-	is_order_increase_ = true;
-
-	Shuffle();
-	DealCards();
+	StartGame();
 
 	int num_rounds = 0;
 	int num_turns = 0;
@@ -87,10 +157,11 @@ int NintyNine::Play(GameStats &stats)
 	{
 		++num_turns;
 
-		if (((player_num == 0) && (is_order_increase_)) || ((player_num == (NUM_PLAYERS - 1)) && (!is_order_increase_)))
+		// a round starts when the first player of the active-seat ring plays
+		if (player_num == FirstActiveSeat(active_mask_, is_order_increase_))
 		{
-			if (is_display_)
-				printf("\n(Round %d) TOTAL: %d\n", num_rounds, GetRunningTotal());
+			if (trace_level_ >= TRACE_PLAY)
+				Trace(TE_ROUND, player_num, 0, num_rounds);
 
 			++num_rounds;
 		}
@@ -104,53 +175,371 @@ int NintyNine::Play(GameStats &stats)
 
 	// update stats
 
-	stats.num_rounds_ += num_rounds - 1;
-	if (stats.highest_rounds_ < num_rounds)
-		stats.highest_rounds_ = num_rounds;
-	if ((stats.lowest_rounds_ == 0) || (stats.lowest_rounds_ > num_rounds))
-		stats.lowest_rounds_ = num_rounds;
-	if (NUM_ROUNDS_LIMIT < num_rounds)
-		++stats.exceed_limit_rounds_;
-
-	stats.num_turns_ += num_turns - 1;
-	if (stats.highest_turns_ < num_turns)
-		stats.highest_turns_ = num_turns;
-	if ((stats.lowest_turns_ == 0) || (stats.lowest_turns_ > num_turns))
-		stats.lowest_turns_ = num_turns;
-	if (NUM_TURNS_LIMIT < num_turns)
-		++stats.exceed_limit_turns_;
+	stats.Record(num_rounds, num_turns, NUM_TURNS_LIMIT);
+	num_rounds_ = num_rounds;
+	num_turns_ = num_turns;
 
 	// get winner
 
 	int winner = 0;
 	for (int i = 0; i < NUM_PLAYERS; ++i)
 	{
-		if (!players_[i]->is_defeat_)
+		if (!players_[i].is_defeat_)
 		{
 			winner = i;
 			break;
 		}
 	}
 
-	if (is_display_)
-		printf("\nPlayer %d (%s) Wins!\n", winner, DisplayAI(players_[winner]->AI_));
+	if (trace_level_ >= TRACE_RESULT)
+		Trace(TE_WIN, winner, 0, num_rounds);
 
 	return winner;
 }
 
 /*--------------------------------------------------------------------------*
-Name:           Free
+Name:           StartGame
 
-Description:	Free memory.
+Description:	Start a game: reset running total and player order, shuffle and deal.
+				Player 0 plays first.
 
 Arguments:      None.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-void NintyNine::Free(void)
+template <typename RULES>
+void NintyNineT<RULES>::StartGame(void)
+{
+	deck_index_ = 0;
+	total_ = 0;
+	players_left_ = NUM_PLAYERS;
+	is_order_increase_ = true;
+	num_played_ = 0;
+	++num_started_;
+
+	// sample the game for the trace (by game index in counter-based mode)
+	trace_game_ = USE_COUNTER_RNG ? stream_ : num_started_ - 1;
+	trace_level_ = (trace_ != nullptr) ? trace_->GetLevel(trace_game_) : (int)TRACE_OFF;
+
+	Shuffle();
+	DealCards();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           SeedStream
+
+Description:	Restart the random stream of the engine.
+				The deck is restored to its initial order, so the games played
+				afterward only depend on (seed, stream).
+				In counter-based mode, stream is the index of the game.
+
+Arguments:      stream: Stream number.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void NintyNineT<RULES>::SeedStream(unsigned long long stream)
+{
+	rng_.Seed(seed_, stream);
+	stream_ = stream;
+
+	std::copy(cards_, cards_ + NUM_CARDS, deck_);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           SetDecisionTable
+
+Description:	Let dumb and smart AI look up their choices in a precomputed table.
+				Players are created by Initialize, so call this after it.
+
+Arguments:      table: Decision table (null to scan hands every turn).
+
+Returns:        false if the table is built for another running total limit
+				or other weights, or effects other than the special cards
+				of RULES are set, the table only holds the choices of those
+				(players are left unchanged).
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+bool NintyNineT<RULES>::SetDecisionTable(const DecisionTable *table)
+{
+	if ((table != nullptr) && (!table->IsCompatible(cards_, RUNNING_TOTAL_LIMIT) || (effects_ != GetRulesEffects<RULES>())))
+		return false;
+
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+		players_[i].table_ = table;
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           SetEffects
+
+Description:	Play cards with the effects of a compiled table, e.g. a variant
+				of the rules read from an effect file. The table is shared,
+				it must outlive the engine and its copies. Dumb and smart AI
+				score their cards with it, and drop their decision table for
+				effects other than the special cards of RULES.
+
+Arguments:      effects: Compiled effects (null: special cards of RULES).
+
+Returns:        false if the table is compiled for another running total
+				limit (effects are left unchanged).
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+bool NintyNineT<RULES>::SetEffects(const EffectTable *effects)
+{
+	if (effects == nullptr)
+		effects = GetRulesEffects<RULES>();
+
+	if (effects->GetLimit() != RUNNING_TOTAL_LIMIT)
+		return false;
+
+	effects_ = effects;
+
+	// dumb/smart AI score their cards with the effects, a decision table only holds the special cards of RULES
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+	{
+		players_[i].effects_ = effects;
+		if (effects != GetRulesEffects<RULES>())
+			players_[i].table_ = nullptr;
+	}
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           SetGameLog
+
+Description:	Record the card slot picked every turn into a game log.
+				The caller begins and ends each game on the log (see PlayGames).
+
+Arguments:      log: Game log (null to stop recording).
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void NintyNineT<RULES>::SetGameLog(GameLogWriter *log)
+{
+	log_ = log;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Snapshot
+
+Description:	Save the state of the game. Costs the same at any point of a game
+				(hands and one deck are copied), nothing is allocated.
+
+Arguments:      state: Saved state.
+				player_num: Player to move.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void NintyNineT<RULES>::Snapshot(GameState &state, int player_num) const
+{
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+		state.hands_[i] = players_[i].hands_;
+
+	std::copy(deck_, deck_ + NUM_CARDS, state.deck_);
+	state.rng_ = rng_;
+	state.deck_index_ = deck_index_;
+	state.total_ = total_;
+	state.player_num_ = player_num;
+	state.players_left_ = players_left_;
+	state.num_played_ = num_played_;
+	state.defeat_mask_ = ((1u << NUM_PLAYERS) - 1) & ~active_mask_;
+	state.is_order_increase_ = is_order_increase_;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Restore
+
+Description:	Restore a saved state. The AI line-up, decision table, game log
+				and display setting of the engine are kept.
+
+Arguments:      state: Saved state.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void NintyNineT<RULES>::Restore(const GameState &state)
+{
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+	{
+		players_[i].hands_ = state.hands_[i];
+		players_[i].is_defeat_ = ((state.defeat_mask_ >> i) & 1) != 0;
+	}
+
+	std::copy(state.deck_, state.deck_ + NUM_CARDS, deck_);
+	rng_ = state.rng_;
+	deck_index_ = state.deck_index_;
+	total_ = state.total_;
+	players_left_ = state.players_left_;
+	active_mask_ = ((1u << NUM_PLAYERS) - 1) & ~state.defeat_mask_;
+	num_played_ = state.num_played_;
+	is_order_increase_ = state.is_order_increase_;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Step
+
+Description:	Play one turn on a saved state, as PlayerTurn does in Play
+				(a defeated player skips its turn), then move to the next player.
+				The engine is left at the new state.
+
+Arguments:      state: Saved state, advanced by one turn.
+				index: Card slot dealt by the player to move (-1: its AI picks).
+
+Returns:        true: only one player left. Game end condition.
+				false: more than one players left.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+bool NintyNineT<RULES>::Step(GameState &state, int index)
+{
+	Restore(state);
+
+	int player_num = state.player_num_;
+	bool is_end;
+
+	if ((index >= 0) && !players_[player_num].is_defeat_)
+		is_end = PlayCard(player_num, index);
+	else
+		is_end = PlayerTurn(player_num);
+
+	Snapshot(state, NextPlayer(player_num));
+
+	return is_end;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PlayStrategy
+
+Description:	Ask the registered strategy of a player which card to deal.
+				The engine is not changed.
+
+Arguments:      player_num: Index of the player.
+				random: Random number of the turn.
+
+Returns:        Index of the card in the player's hands (0 if the strategy
+				picks a card out of range).
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int NintyNineT<RULES>::PlayStrategy(int player_num, unsigned long long random) const
+{
+	int values[NUM_CARDS_PER_PLAYER];
+	int weights[NUM_CARDS_PER_PLAYER];
+	int totals[NUM_CARDS_PER_PLAYER];
+	for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
+	{
+		values[i] = players_[player_num].hands_[i].GetValue();
+		weights[i] = effects_->GetWeight(values[i]);
+		totals[i] = effects_->Get(total_, values[i]).total_;
+	}
+
+	StrategyTurn turn;
+	turn.player_num_ = player_num;
+	turn.num_players_ = NUM_PLAYERS;
+	turn.players_left_ = players_left_;
+	turn.is_order_increase_ = is_order_increase_ ? 1 : 0;
+	turn.total_ = total_;
+	turn.limit_ = RUNNING_TOTAL_LIMIT;
+	turn.num_cards_ = NUM_CARDS_PER_PLAYER;
+	turn.values_ = values;
+	turn.random_ = random;
+	turn.weights_ = weights;
+	turn.totals_ = totals;
+
+	int index = strategy_[player_num]->pick_(&turn);
+
+	return ((index >= 0) && (index < NUM_CARDS_PER_PLAYER)) ? index : 0;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Determinize
+
+Description:	Redeal the cards a player can't see: the hands of all other players
+				(defeated ones too) and the cards left in the deck are shuffled
+				together and dealt back into the same places. The engine is reseeded,
+				so decks shuffled later are unknown too. Used on a copy of the engine
+				by MCTS playouts, so the copy stops displaying and recording.
+
+Arguments:      player_num: Index of the player who sees its own hands.
+				rng: Random number generator of the search.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void NintyNineT<RULES>::Determinize(int player_num, Random &rng)
+{
+	Cards unseen[NUM_CARDS];
+	int num_unseen = 0;
+
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+	{
+		if (i == player_num)
+			continue;
+
+		for (int j = 0; j < NUM_CARDS_PER_PLAYER; ++j)
+			unseen[num_unseen++] = players_[i].hands_[j];
+	}
+
+	for (int i = deck_index_; i < NUM_CARDS; ++i)
+		unseen[num_unseen++] = deck_[i];
+
+	for (int i = num_unseen - 1; i > 0; --i)
+		std::swap(unseen[i], unseen[rng.Range(i + 1)]);
+
+	num_unseen = 0;
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+	{
+		if (i == player_num)
+			continue;
+
+		for (int j = 0; j < NUM_CARDS_PER_PLAYER; ++j)
+			players_[i].hands_[j] = unseen[num_unseen++];
+	}
+
+	for (int i = deck_index_; i < NUM_CARDS; ++i)
+		deck_[i] = unseen[num_unseen++];
+
+	rng_.Seed(rng.Next());
+
+	trace_ = nullptr;
+	trace_level_ = TRACE_OFF;
+	log_ = nullptr;
+	replay_ = nullptr;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Replay
+
+Description:	Replay a logged game: players get the AI of the record, the deck
+				is shuffled from the random stream of the game index, and each
+				turn deals the recorded card instead of asking the player.
+				Random AI still draws its pick, so later shuffles see the same stream.
+
+Arguments:      record: Logged game.
+				stats: record game stats.
+
+Returns:        Winner id, -1 if the record does not match the game.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int NintyNineT<RULES>::Replay(const GameRecord &record, GameStats &stats)
 {
-	FreePlayers();
-	FreeDeck();
+	InitPlayers(record.ai_);
+	SeedStream(record.game_);
+
+	replay_ = &record;
+	replay_pick_ = 0;
+	is_replay_error_ = false;
+
+	int winner = Play(stats);
+
+	if (replay_pick_ != record.num_picks_)
+		is_replay_error_ = true;
+	replay_ = nullptr;
+
+	return is_replay_error_ ? -1 : winner;
 }
 
 /*--------------------------------------------------------------------------*
@@ -162,9 +551,10 @@ Arguments:      None.
 
 Returns:        A deck of cards (vectors of card face values).
 *---------------------------------------------------------------------------*/
-CardList NintyNine::GetDeck(void)
+template <typename RULES>
+CardList NintyNineT<RULES>::GetDeck(void)
 {
-	return deck_;
+	return CardList(deck_, deck_ + NUM_CARDS);
 }
 
 /*--------------------------------------------------------------------------*
@@ -176,23 +566,70 @@ Arguments:      None.
 
 Returns:        Running total of current game.
 *---------------------------------------------------------------------------*/
-int NintyNine::GetRunningTotal(void)
+template <typename RULES>
+int NintyNineT<RULES>::GetRunningTotal(void) const
 {
 	return total_;
 }
 
 /*--------------------------------------------------------------------------*
-Name:           GetPlayerList
+Name:           IsOrderIncrease
+
+Description:	Get player order.
+
+Arguments:      None.
+
+Returns:        true if the order is increasing.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+bool NintyNineT<RULES>::IsOrderIncrease(void) const
+{
+	return is_order_increase_;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetPlayersLeft
 
-Description:	Get player list.
+Description:	Get number of players not defeated.
 
 Arguments:      None.
 
-Returns:        List of players.
+Returns:        Number of players left of current game.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int NintyNineT<RULES>::GetPlayersLeft(void) const
+{
+	return players_left_;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetPlayer
+
+Description:	Get a player.
+
+Arguments:      player_num: Index of the player.
+
+Returns:        The player.
 *---------------------------------------------------------------------------*/
-PlayerList NintyNine::GetPlayerList(void)
+template <typename RULES>
+const PlayerT<RULES> &NintyNineT<RULES>::GetPlayer(int player_num) const
 {
-	return players_;
+	return players_[player_num];
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetSeed
+
+Description:	Get random seed.
+
+Arguments:      None.
+
+Returns:        Random seed of the engine.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+unsigned long long NintyNineT<RULES>::GetSeed(void) const
+{
+	return seed_;
 }
 
 /*--------------------------------------------------------------------------*
@@ -204,10 +641,11 @@ Arguments:      None.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-void NintyNine::DisplayDeck(void)
+template <typename RULES>
+void NintyNineT<RULES>::DisplayDeck(void)
 {
 	for (int i = 0; i < (NUM_VALUES * SU_NUMBER); ++i)
-		printf("%c, ", POKER::DisplayCard(deck_[i]->value_));
+		printf("%c, ", POKER::DisplayCard(deck_[i].GetValue()));
 
 	printf("\n");
 }
@@ -221,13 +659,14 @@ Arguments:      None.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-void NintyNine::DisplayHands(void)
+template <typename RULES>
+void NintyNineT<RULES>::DisplayHands(void)
 {
 	for (int i = 0; i < NUM_PLAYERS; ++i)
 	{
-		printf("Player %d (%s): ", i, DisplayAI(players_[i]->AI_));
+		printf("Player %d (%s): ", i, DisplayAI(players_[i].AI_));
 		for (int j = 0; j < NUM_CARDS_PER_PLAYER; ++j)
-			printf("%c ", POKER::DisplayCard(players_[i]->hands_[j]->value_));
+			printf("%c ", POKER::DisplayCard(players_[i].hands_[j].GetValue()));
 
 		printf("\n");
 	}
@@ -236,73 +675,74 @@ void NintyNine::DisplayHands(void)
 // private functions
 
 /*--------------------------------------------------------------------------*
-Name:           CreateDeck
+Name:           CreateCards
 
-Description:	Create a deck of 52 cards
+Description:	Create 52 cards in their initial order (the order of a new deck).
 
-Arguments:      None.
+Arguments:      cards: Array of NUM_CARDS cards to be filled.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-void NintyNine::CreateDeck(void)
+template <typename RULES>
+void NintyNineT<RULES>::CreateCards(Cards cards[])
 {
-	// create 52 cards and put them into card list and deck list
+	// create 52 cards
 
 	for (int i = 0; i < SU_NUMBER; ++i)
 	{
 		for (int j = 0; j < NUM_VALUES; ++j)
 		{
-			Cards *card = new Cards(j + 1, (SUIT)i, 1);
+			int value = j + 1;
+			int weight = SP_NULL_WEIGHT;
 
 			// assign weights for special ability cards
 
-			switch (card->value_)
+			switch (value)
 			{
 			case SP_10:
-				card->weight_ = SP_10_WEIGHT;
+				weight = SP_10_WEIGHT;
 				break;
 			case SP_20:
-				card->weight_ = SP_20_WEIGHT;
+				weight = SP_20_WEIGHT;
 				break;
 			case SP_99:
-				card->weight_ = SP_99_WEIGHT;
+				weight = SP_99_WEIGHT;
 				break;
 			case SP_REVERSE:
-				card->weight_ = SP_REVERSE_WEIGHT;
+				weight = SP_REVERSE_WEIGHT;
 				break;
 			case SP_SKIP:
-				card->weight_ = SP_SKIP_WEIGHT;
+				weight = SP_SKIP_WEIGHT;
 				break;
 			case SP_PICK:
-				card->weight_ = SP_PICK_WEIGHT;
+				weight = SP_PICK_WEIGHT;
 				break;
 			default:
-				card->weight_ = SP_NULL_WEIGHT;
+				weight = SP_NULL_WEIGHT;
 				break;
 			}
 
-			cards_.emplace_back(card);
-			deck_.emplace_back(card);
+			cards[i * NUM_VALUES + j] = Cards(value, (SUIT)i, weight);
 		}
 	}
 }
 
 /*--------------------------------------------------------------------------*
-Name:           FreeDeck
+Name:           CreateDeck
 
-Description:	Free deck lists.
+Description:	Create a deck of 52 cards
 
 Arguments:      None.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-void NintyNine::FreeDeck(void)
+template <typename RULES>
+void NintyNineT<RULES>::CreateDeck(void)
 {
-	for (int i = 0; i < (NUM_VALUES * SU_NUMBER); ++i)
-		delete cards_[i];
+	// create 52 cards and put them into card list and deck list
 
-	deck_.clear();
-	cards_.clear();
+	CreateCards(cards_);
+	std::copy(cards_, cards_ + NUM_CARDS, deck_);
 }
 
 /*--------------------------------------------------------------------------*
@@ -314,7 +754,8 @@ Arguments:      None.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-void NintyNine::InitPlayers(void)
+template <typename RULES>
+void NintyNineT<RULES>::InitPlayers(void)
 {
 	if (!USE_PLAYER_AI_LIST)
 	{
@@ -322,60 +763,218 @@ void NintyNine::InitPlayers(void)
 
 		// get random order for human player
 		if (AI_CHANCE_PLAYER)
-			human_ai = std::rand() % NUM_PLAYERS;
+			human_ai = rng_.Range(NUM_PLAYERS);
 
 		for (int i = 0; i < NUM_PLAYERS; ++i)
 		{
 			// create human player
 			if (AI_CHANCE_PLAYER && (human_ai == i))
 			{
-				Player *player = new Player(0);
-				players_.emplace_back(player);
+				players_[i] = Player(AI_PLAYER);
 			}
 			else
 			{
 				// let pc to pick which AI for each player
-				int cpu_ai = std::rand() % 100;
+				int cpu_ai = rng_.Range(100);
 				if (cpu_ai < AI_CHANCE_RANDOM)
 					cpu_ai = 1;
 				else if (cpu_ai < (AI_CHANCE_RANDOM + AI_CHANCE_DUMB))
 					cpu_ai = 2;
-				else
+				else if (cpu_ai < (AI_CHANCE_RANDOM + AI_CHANCE_DUMB + AI_CHANCE_SMART))
 					cpu_ai = 3;
+				else
+					cpu_ai = 4;
 
-				Player *player = new Player(cpu_ai);
-				players_.emplace_back(player);
+				players_[i] = Player(cpu_ai);
 			}
 		}
+
+		InitStrategies();
 	}
 	else
 	{
 		// use preset PLAYER_AI list to assign AI to each player
+		// (the list is repeated if this engine has more players than the list)
+		int ai_list[NUM_PLAYERS];
 		for (int i = 0; i < NUM_PLAYERS; ++i)
-		{
-			Player *player = new Player(PLAYER_AI[i]);
-			players_.emplace_back(player);
-		}
+			ai_list[i] = PLAYER_AI[i % (sizeof(PLAYER_AI) / sizeof(PLAYER_AI[0]))];
+
+		InitPlayers(ai_list);
 	}
 }
 
 /*--------------------------------------------------------------------------*
-Name:           FreePlayers
+Name:           InitPlayers
 
-Description:	free player memory.
+Description:	Initialize players from a given AI list.
+
+Arguments:      ai_list: AI of each player.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void NintyNineT<RULES>::InitPlayers(const int ai_list[])
+{
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+		players_[i] = Player(ai_list[i]);
+
+	InitStrategies();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           InitStrategies
+
+Description:	Set up the players whose cards are picked by the engine, once
+				per line-up: look up the registered strategy of each player,
+				hand each player the effect table, and create a search for
+				each MCTS player (it allocates its tree on the first move,
+				copies of the engine share the searches).
 
 Arguments:      None.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-void NintyNine::FreePlayers(void)
+template <typename RULES>
+void NintyNineT<RULES>::InitStrategies(void)
 {
 	for (int i = 0; i < NUM_PLAYERS; ++i)
 	{
-		delete players_[i];
+		players_[i].effects_ = effects_;
+		mcts_[i].reset();
+		strategy_[i] = GetStrategy(players_[i].AI_);
+
+		if (players_[i].AI_ == AI_MCTS)
+			mcts_[i] = std::make_shared<MctsT<RULES> >(i);
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Pick
+
+Description:	Card pick of a player. Built-in AI are a switch on the AI, so
+				their picks are inlined; only loaded strategies are called
+				through the function pointer of their plugin.
+
+Arguments:      player_num: Index of the player.
+
+Returns:        Index of the card in the player's hands.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int NintyNineT<RULES>::Pick(int player_num)
+{
+	switch (players_[player_num].AI_)
+	{
+	case AI_PLAYER:
+		return PickHuman(player_num);
+
+	case AI_RANDOM:
+		return PickRandom(player_num);
+
+	case AI_DUMB:
+		return PickDumb(player_num);
+
+	case AI_SMART:
+		return PickSmart(player_num);
+
+	case AI_MCTS:
+		return PickMcts(player_num);
+
+	default:
+		// a strategy that is not loaded plays as the smart player
+		return (strategy_[player_num] != nullptr) ? PickExternal(player_num) : PickSmart(player_num);
 	}
 }
 
+/*--------------------------------------------------------------------------*
+Name:           PickHuman
+
+Description:	(AI 0) Card pick of a human player.
+
+Arguments:      player_num: Index of the player.
+
+Returns:        Index of the card in the player's hands.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int NintyNineT<RULES>::PickHuman(int player_num)
+{
+	return players_[player_num].PlayHuman(total_);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PickRandom
+
+Description:	(AI 1) Card pick of a random player, drawn from the game stream.
+
+Arguments:      player_num: Index of the player.
+
+Returns:        Index of the card in the player's hands.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int NintyNineT<RULES>::PickRandom(int player_num)
+{
+	return players_[player_num].PlayRandom(rng_);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PickDumb
+
+Description:	(AI 2) Card pick of a dumb player (decision table or scan of hands).
+
+Arguments:      player_num: Index of the player.
+
+Returns:        Index of the card in the player's hands.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int NintyNineT<RULES>::PickDumb(int player_num)
+{
+	return players_[player_num].PlayerDumb(total_);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PickSmart
+
+Description:	(AI 3) Card pick of a smart player (decision table or scan of hands).
+
+Arguments:      player_num: Index of the player.
+
+Returns:        Index of the card in the player's hands.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int NintyNineT<RULES>::PickSmart(int player_num)
+{
+	return players_[player_num].PlayerSmart(total_);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PickMcts
+
+Description:	(AI 4) Card pick of an MCTS player, searched on the whole game.
+
+Arguments:      player_num: Index of the player.
+
+Returns:        Index of the card in the player's hands.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int NintyNineT<RULES>::PickMcts(int player_num)
+{
+	return mcts_[player_num]->Play(*this);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PickExternal
+
+Description:	(AI 5~) Card pick of a loaded strategy. Draws the random
+				number of the turn from the game stream.
+
+Arguments:      player_num: Index of the player.
+
+Returns:        Index of the card in the player's hands.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int NintyNineT<RULES>::PickExternal(int player_num)
+{
+	return PlayStrategy(player_num, rng_.Next());
+}
 
 /*--------------------------------------------------------------------------*
 Name:           Shuffle
@@ -386,11 +985,25 @@ Arguments:      None.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-void NintyNine::Shuffle(void)
+template <typename RULES>
+void NintyNineT<RULES>::Shuffle(void)
 {
-	std::random_shuffle(deck_.begin(), deck_.end());
+	PROFILE_COUNT(profile_, PC_SHUFFLE);
+	PROFILE_START(start);
+
+	// Fisher-Yates shuffle (lazy shuffle: done one step per card drawn, see DrawShuffled)
+	if (!USE_LAZY_SHUFFLE)
+	{
+		for (int i = NUM_CARDS - 1; i > 0; --i)
+		{
+			int k = rng_.Range(i + 1);
+			std::swap(deck_[i], deck_[is_antithetic_ ? i - k : k]);
+		}
+	}
 
 	deck_index_ = 0;
+
+	PROFILE_STOP(profile_, PT_SHUFFLE, start);
 }
 
 /*--------------------------------------------------------------------------*
@@ -402,12 +1015,22 @@ Arguments:      None.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-void NintyNine::DealCards(void)
+template <typename RULES>
+void NintyNineT<RULES>::DealCards(void)
 {
+	// random numbers of the lazy shuffle steps of the deal, generated in one go
+	uint32_t steps[NUM_PLAYERS * NUM_CARDS_PER_PLAYER];
+
+	if (USE_LAZY_SHUFFLE)
+		rng_.Fill(steps, NUM_PLAYERS * NUM_CARDS_PER_PLAYER);
+
+	active_mask_ = (1u << NUM_PLAYERS) - 1;
+
 	for (int i = 0; i < NUM_PLAYERS; ++i)
 	{
 		// reset player status
-		players_[i]->is_defeat_ = false;
+		players_[i].is_defeat_ = false;
+		out_rank_[i] = 0;
 
 		for (int j = 0; j < NUM_CARDS_PER_PLAYER; ++j)
 		{
@@ -416,7 +1039,12 @@ void NintyNine::DealCards(void)
 			if (deck_index_ >= NUM_CARDS)
 				Shuffle();
 
-			players_[i]->hands_.emplace_back(deck_[deck_index_++]);
+			players_[i].hands_[j] = USE_LAZY_SHUFFLE ?
+				DrawShuffled(deck_, deck_index_, rng_, steps[i * NUM_CARDS_PER_PLAYER + j], is_antithetic_) :
+				deck_[deck_index_++];
+
+			if (trace_level_ >= TRACE_DEAL)
+				Trace(TE_DEAL, i, players_[i].hands_[j].GetValue());
 		}
 	}
 }
@@ -431,9 +1059,12 @@ Arguments:      player_num: index of the player.
 Returns:        true: only one player left. Game end condition.
 				false: more than one players left.
 *---------------------------------------------------------------------------*/
-bool NintyNine::PlayerTurn(int player_num)
+template <typename RULES>
+bool NintyNineT<RULES>::PlayerTurn(int player_num)
 {
-	if (!players_[player_num]->is_defeat_)
+	PROFILE_COUNT(profile_, PC_TURN);
+
+	if (!players_[player_num].is_defeat_)
 	{
 		// this player deals a card, add running total
 		// then check if there's a need to open the next deck to the pool
@@ -441,22 +1072,82 @@ bool NintyNine::PlayerTurn(int player_num)
 		// then check if running total exceeds the limit
 		// if so, the player loses
 
-		int index = players_[player_num]->Play(total_);
+		PROFILE_START(start);
+		int index;
+		if (replay_ == nullptr)
+		{
+			index = Pick(player_num);
+		}
+		else
+		{
+			index = ReplayPick(player_num);
+
+			// a broken record ends the game
+			if (is_replay_error_)
+				return true;
+		}
+		PROFILE_STOP(profile_, PT_DECISION + players_[player_num].AI_, start);
+
+		if (log_ != nullptr)
+			log_->AddPick(index);
+
+		return PlayCard(player_num, index);
+	}
+
+	PROFILE_COUNT(profile_, PC_DEFEATED_TURN);
+
+	if (players_left_ <= 1)
+		return true;
+
+	return false;
+}
 
-		if (is_display_)
-			printf("Player %d (%s) deals %c\n", player_num, DisplayAI(players_[player_num]->AI_), POKER::DisplayCard(players_[player_num]->hands_[index]->value_));
+/*--------------------------------------------------------------------------*
+Name:           PlayCard
 
-		AddRunningTotal(players_[player_num]->hands_[index]->value_);
+Description:	A player deals a given card (used by PlayerTurn and by the solver).
 
-		if (deck_index_ >= NUM_CARDS)
-			Shuffle();
+Arguments:      player_num: index of the player.
+				index: index of the card in the player's hands.
 
-		players_[player_num]->hands_[index] = deck_[deck_index_++];
+Returns:        true: only one player left. Game end condition.
+				false: more than one players left.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+bool NintyNineT<RULES>::PlayCard(int player_num, int index)
+{
+	int value = players_[player_num].hands_[index].GetValue();
 
-		// detect if the player loses
-		CheckRunningTotal(player_num);
+	int total = total_;
+
+	history_[num_played_++ & (PLAY_HISTORY - 1)] = (unsigned char)((player_num << 4) | value);
+	AddRunningTotal(value);
+
+	if (trace_level_ >= TRACE_PLAY)
+	{
+		Trace(TE_PLAY, player_num, value);
+
+		// effects are traced from the effect table, so an effect file is traced as played
+		const EffectEntry &entry = effects_->Get(total, value);
+		if (entry.HasTotalEffect(total))
+			Trace(TE_EFFECT, player_num, entry.kind_, total_ - total);
+		if (entry.flags_ != 0)
+			Trace(TE_ORDER, player_num, entry.flags_);
 	}
 
+	if (deck_index_ >= NUM_CARDS)
+	{
+		PROFILE_COUNT(profile_, PC_RESHUFFLE);
+		Shuffle();
+	}
+
+	players_[player_num].hands_[index] = USE_LAZY_SHUFFLE ?
+		DrawShuffled(deck_, deck_index_, rng_, rng_.Next32(), is_antithetic_) :
+		deck_[deck_index_++];
+
+	// detect if the player loses
+	CheckRunningTotal(player_num);
+
 	if (players_left_ <= 1)
 		return true;
 
@@ -464,50 +1155,79 @@ bool NintyNine::PlayerTurn(int player_num)
 }
 
 /*--------------------------------------------------------------------------*
-Name:           AddRunningTotal
+Name:           ReplayPick
 
-Description:	Add card number to running total, also deals special cards
+Description:	Card slot picked by a player from the replayed game.
 
-Arguments:      value: Card face value.
+Arguments:      player_num: index of the player.
 
-Returns:        None.
+Returns:        Index of the card in the player's hands.
 *---------------------------------------------------------------------------*/
-void NintyNine::AddRunningTotal(int value)
+template <typename RULES>
+int NintyNineT<RULES>::ReplayPick(int player_num)
 {
-	switch (value)
+	if (replay_pick_ >= replay_->num_picks_)
 	{
-	case SP_10:
-		if (total_ > 90)
-			total_ -= 10;
-		else
-			total_ += 10;
-		break;
+		is_replay_error_ = true;
+		return 0;
+	}
 
-	case SP_20:
-		if (total_ > 80)
-			total_ -= 20;
-		else
-			total_ += 20;
-		break;
+	int index = replay_->GetPick(replay_pick_++);
 
-	case SP_99:
-		total_ = 99;
-		break;
+	// random AI draws from the stream as in the logged game, and must have drawn the same card
+	if ((players_[player_num].AI_ == AI_RANDOM) && (players_[player_num].PlayRandom(rng_) != index))
+		is_replay_error_ = true;
 
-	case SP_REVERSE:
-		is_order_increase_ = !is_order_increase_;
-		break;
+	// a loaded strategy draws the random number of its turn, the strategy itself may not be loaded
+	if (players_[player_num].AI_ >= AI_EXTERNAL)
+		rng_.Next();
 
-	case SP_SKIP:
-		break;
+	if (index >= NUM_CARDS_PER_PLAYER)
+	{
+		is_replay_error_ = true;
+		return 0;
+	}
 
-	case SP_PICK:
-		break;
+	return index;
+}
 
-	default:
-		total_ += value;
-		break;
+/*--------------------------------------------------------------------------*
+Name:           AddRunningTotal
+
+Description:	Add card number to running total, also deals special cards.
+				The new total and the player order come from the effect table,
+				so every card costs one lookup whatever its effect.
+
+Arguments:      value: Card face value.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void NintyNineT<RULES>::AddRunningTotal(int value)
+{
+	const EffectEntry &entry = effects_->Get(total_, value);
+
+#if NINTYNINE_PROFILE
+	// effects are counted by their kind and flags in the table, so an effect file is counted as played
+	if (entry.HasTotalEffect(total_))
+	{
+		if (entry.kind_ == EK_ADD)
+			PROFILE_COUNT(profile_, PC_EFFECT_ADD);
+		else if (entry.kind_ == EK_TURN)
+			PROFILE_COUNT(profile_, PC_EFFECT_TURN);
+		else
+			PROFILE_COUNT(profile_, PC_EFFECT_SET);
 	}
+	if (entry.flags_ & EF_REVERSE)
+		PROFILE_COUNT(profile_, PC_EFFECT_REVERSE);
+	if (entry.flags_ & EF_SKIP)
+		PROFILE_COUNT(profile_, PC_EFFECT_SKIP);
+	if (entry.flags_ & EF_PICK)
+		PROFILE_COUNT(profile_, PC_EFFECT_PICK);
+#endif
+
+	total_ = entry.total_;
+	is_order_increase_ = (is_order_increase_ != ((entry.flags_ & EF_REVERSE) != 0));
 }
 
 /*--------------------------------------------------------------------------*
@@ -519,47 +1239,201 @@ Arguments:      player_num: Index of the player.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-void NintyNine::CheckRunningTotal(int player_num)
+template <typename RULES>
+void NintyNineT<RULES>::CheckRunningTotal(int player_num)
 {
 	// detect if the player loses
 	if (total_ > RUNNING_TOTAL_LIMIT)
 	{
-		if (is_display_)
-			printf("\nPlayer %d (%s) Loses!\n", player_num, DisplayAI(players_[player_num]->AI_));
+		if (trace_level_ >= TRACE_ELIMINATION)
+			Trace(TE_ELIMINATION, player_num, 0);
 
-		players_[player_num]->is_defeat_ = true;
+		players_[player_num].is_defeat_ = true;
+		out_rank_[player_num] = (unsigned char)(NUM_PLAYERS - players_left_ + 1);
+		PROFILE_COUNT(profile_, PC_ELIMINATION);
 
+		// leave the active-seat ring
+		active_mask_ &= ~(1u << player_num);
 		--players_left_;
 		total_ = RUNNING_TOTAL_LIMIT;
 	}
 }
 
+/*--------------------------------------------------------------------------*
+Name:           Trace
+
+Description:	Push an event of the current game to the trace.
+				Callers check trace_level_ first, so untraced games only pay
+				for the comparison.
+
+Arguments:      type: Event (TRACE_EVENT).
+				player_num: Index of the player.
+				value: Face value or special effect.
+				arg: Round or number of rounds.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void NintyNineT<RULES>::Trace(int type, int player_num, int value, int arg)
+{
+	TraceEvent event;
+	event.game_ = trace_game_;
+	event.type_ = (unsigned char)type;
+	event.player_ = (unsigned char)player_num;
+	event.ai_ = (unsigned char)players_[player_num].AI_;
+	event.value_ = (unsigned char)value;
+	event.total_ = (short)total_;
+	event.arg_ = (short)arg;
+
+	trace_->Push(event);
+}
+
 /*--------------------------------------------------------------------------*
 Name:           NextPlayer
 
-Description:	Get next player index.
+Description:	Get next player index, defeated players are stepped over
+				in O(1) with the active-seat ring.
 				Depend on if the order is increasing or decreasing.
 
-Arguments:      player_num: Index of the player.
+Arguments:      player_num: Index of the player (may be defeated).
 
 Returns:        Next player index.
 *---------------------------------------------------------------------------*/
-int NintyNine::NextPlayer(int player_num)
+template <typename RULES>
+int NintyNineT<RULES>::NextPlayer(int player_num)
 {
-	int num = 0;
+	return NextActiveSeat(active_mask_, player_num, is_order_increase_);
+}
 
-	if (is_order_increase_)
-	{
-		num = player_num + 1;
-		if (num == NUM_PLAYERS)
-			num = 0;
-	}
-	else
+#if NINTYNINE_PROFILE
+/*--------------------------------------------------------------------------*
+Name:           MergeProfile
+
+Description:	Add hot-path counters of this engine to profile, then reset them.
+
+Arguments:      profile: Counters to be added to.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+void NintyNineT<RULES>::MergeProfile(Profile &profile)
+{
+	profile.Merge(profile_);
+	profile_.Clear();
+}
+#endif
+
+// pre-instantiated engines
+
+#define NINTYNINE_INSTANTIATE(players, cards) template class POKER::NintyNineT<Rules<players, cards> >;
+NINTYNINE_CONFIGS(NINTYNINE_INSTANTIATE)
+#undef NINTYNINE_INSTANTIATE
+
+// game stats
+
+/*--------------------------------------------------------------------------*
+Name:           Record
+
+Description:	Record number of rounds and turns of a game.
+
+Arguments:      num_rounds: Number of rounds of the game.
+				num_turns: Number of turns of the game.
+				num_turns_limit: Max number of turns allowed for the game.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void GameStats::Record(int num_rounds, int num_turns, int num_turns_limit)
+{
+	num_rounds_ += num_rounds - 1;
+	if (highest_rounds_ < num_rounds)
+		highest_rounds_ = num_rounds;
+	if ((lowest_rounds_ == 0) || (lowest_rounds_ > num_rounds))
+		lowest_rounds_ = num_rounds;
+	if (NUM_ROUNDS_LIMIT < num_rounds)
+		++exceed_limit_rounds_;
+	rounds_.Add(num_rounds - 1);
+
+	num_turns_ += num_turns - 1;
+	if (highest_turns_ < num_turns)
+		highest_turns_ = num_turns;
+	if ((lowest_turns_ == 0) || (lowest_turns_ > num_turns))
+		lowest_turns_ = num_turns;
+	if (num_turns_limit < num_turns)
+		++exceed_limit_turns_;
+	turns_.Add(num_turns - 1);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Merge
+
+Description:	Merge stats recorded by another engine into this one.
+
+Arguments:      other: Stats to be merged.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void GameStats::Merge(const GameStats &other)
+{
+	num_games_ += other.num_games_;
+
+	num_rounds_ += other.num_rounds_;
+	if (highest_rounds_ < other.highest_rounds_)
+		highest_rounds_ = other.highest_rounds_;
+	if ((lowest_rounds_ == 0) || ((other.lowest_rounds_ != 0) && (lowest_rounds_ > other.lowest_rounds_)))
+		lowest_rounds_ = other.lowest_rounds_;
+	exceed_limit_rounds_ += other.exceed_limit_rounds_;
+	rounds_.Merge(other.rounds_);
+
+	num_turns_ += other.num_turns_;
+	if (highest_turns_ < other.highest_turns_)
+		highest_turns_ = other.highest_turns_;
+	if ((lowest_turns_ == 0) || ((other.lowest_turns_ != 0) && (lowest_turns_ > other.lowest_turns_)))
+		lowest_turns_ = other.lowest_turns_;
+	exceed_limit_turns_ += other.exceed_limit_turns_;
+	turns_.Merge(other.turns_);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Merge
+
+Description:	Merge samples recorded by another one (parallel form of Welford's method).
+
+Arguments:      other: Samples to be merged.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void RunningStat::Merge(const RunningStat &other)
+{
+	if (other.count_ == 0)
+		return;
+
+	if (count_ == 0)
 	{
-		num = player_num - 1;
-		if (num < 0)
-			num = NUM_PLAYERS - 1;
+		*this = other;
+		return;
 	}
 
-	return num;
+	long long count = count_ + other.count_;
+	double delta = other.mean_ - mean_;
+
+	mean_ += delta * other.count_ / count;
+	m2_ += other.m2_ + delta * delta * ((double)count_ * other.count_ / count);
+	count_ = count;
 }
+
+/*--------------------------------------------------------------------------*
+Name:           GetHalfWidth
+
+Description:	Half width of the confidence interval of the mean (normal approximation).
+
+Arguments:      z: Z-score of the confidence level (1.96 for 95%).
+
+Returns:        Half width (0 if there are less than 2 samples).
+*---------------------------------------------------------------------------*/
+double RunningStat::GetHalfWidth(double z) const
+{
+	if (count_ < 2)
+		return 0.0;
+
+	return z * std::sqrt(GetVariance() / count_);
+}
\ No newline at end of file
@@ -8,14 +8,39 @@
 
 #pragma once
 
+#include <memory>		// std::shared_ptr
+#include <type_traits>	// std::is_trivially_copyable
+#include <utility>		// std::swap
 #include <vector>
 
+#ifdef _MSC_VER
+#include <intrin.h>		// _BitScanForward, _BitScanReverse
+#endif
+
+#include "profile.h"
+#include "random.h"
+
 enum AI_ID
 {
 	AI_PLAYER = 0,
 	AI_RANDOM = 1,
 	AI_DUMB = 2,
 	AI_SMART = 3,
+	AI_MCTS = 4,
+	AI_EXTERNAL = 5,	// first strategy loaded from a shared library (see strategy.h), the n-th is AI_EXTERNAL + n
+};
+
+// largest number of strategies loaded from shared libraries (game logs keep 4 bits of AI id per seat)
+static const int MAX_STRATEGIES		= 8;
+// number of AI ids (built-in AI and loaded strategies)
+static const int NUM_AI				= AI_EXTERNAL + MAX_STRATEGIES;
+
+// rules to end a simulation early (can be combined)
+enum STOP_ID
+{
+	STOP_NONE = 0,
+	STOP_PRECISION = 1,
+	STOP_BETTER = 2,
 };
 
 // max face values of cards, default is 1~13
@@ -29,6 +54,21 @@ static const int RUNNING_TOTAL_LIMIT = 99;
 static const int NUM_PLAYERS			= 4;
 // default number of cards each player has
 static const int NUM_CARDS_PER_PLAYER	= 5;
+// largest number of players of all engine configurations (see NINTYNINE_CONFIGS)
+static const int MAX_PLAYERS			= 8;
+
+// engine configurations compiled into the program: CONFIG(number of players, number of cards per player)
+// each one is a fully specialized engine, the one to play is picked at runtime (see RunSimulation)
+// default running total limit and special cards are used, add a line here to support another configuration
+#define NINTYNINE_CONFIGS(CONFIG)	\
+	CONFIG(2, 5)					\
+	CONFIG(3, 5)					\
+	CONFIG(4, 5)					\
+	CONFIG(5, 5)					\
+	CONFIG(6, 5)					\
+	CONFIG(8, 5)					\
+	CONFIG(4, 3)					\
+	CONFIG(4, 7)
 
 // define AI
 
@@ -49,6 +89,8 @@ static const int AI_CHANCE_RANDOM		= 0;	// out of 100
 static const int AI_CHANCE_DUMB			= 0;	// out of 100
 // percentage of AI to be smart
 static const int AI_CHANCE_SMART		= 100;	// out of 100
+// percentage of AI to be MCTS (the rest after random, dumb and smart, see mcts.h for its search budget)
+static const int AI_CHANCE_MCTS			= 0;	// out of 100
 
 // number of games to be simulated
 // (if allow human player, set this to 1)
@@ -62,9 +104,48 @@ static const int NUM_ROUNDS_LIMIT	= 100;
 // max number of turns allowed for each game
 // leave this one unchanged
 static const int NUM_TURNS_LIMIT	= NUM_ROUNDS_LIMIT * NUM_PLAYERS;
+// seed of the random number generator
+// set this to 0 to seed from current time
+static const unsigned long long RANDOM_SEED = 0;
+// set this to true to give each game its own random stream (derived from RANDOM_SEED and game index)
+// so any game can be regenerated from its index, and results do not depend on NUM_THREADS
+static const bool USE_COUNTER_RNG	= true;
+// set this to true to shuffle the deck lazily: each card drawn is picked at random from the cards
+// not dealt yet (one Fisher-Yates step, without bias), so a new game or deck costs nothing
+// and only the cards a game reaches are shuffled (deals differ from the full shuffle for the same seed)
+static const bool USE_LAZY_SHUFFLE	= false;
+// number of worker threads used to simulate games
+// set this to 0 to use all hardware threads, set this to 1 to run on the main thread only
+// (human player and DISPLAY_GAME always run on the main thread)
+static const int NUM_THREADS		= 0;
+
+// early stopping: NUM_GAMES is the budget, the run ends as soon as the rule is met
+// STOP_PRECISION: confidence intervals of every win rate are narrower than +/- STOP_PRECISION,
+//                 and of average rounds and turns narrower than +/- STOP_PRECISION of the average
+// STOP_BETTER: one player wins significantly more often than every other player
+// (rule is checked every STOP_CHECK_GAMES games, so results do not depend on NUM_THREADS)
+static const int STOP_RULE			= STOP_NONE;	// STOP_NONE (play all games), STOP_PRECISION, STOP_BETTER, or both
+// confidence level of the intervals
+static const double STOP_CONFIDENCE	= 0.95;
+// target precision of STOP_PRECISION
+static const double STOP_PRECISION_TARGET = 0.01;
+// number of games played between checks
+static const int STOP_CHECK_GAMES	= 1000;
+
+// checkpoints of long runs: stats so far and the next game to play are saved every CHECKPOINT_GAMES games,
+// a run resumed from a checkpoint ends with the same result as a run never stopped (needs USE_COUNTER_RNG)
+static const int CHECKPOINT_GAMES	= 1000000;
 
 namespace POKER
 {
+	class DecisionTable;
+	class EffectTable;
+	class GameLogWriter;
+	struct StrategyPlugin;
+	class TraceRing;
+	struct GameRecord;
+	template <typename RULES> class MctsT;
+
 	// poker suits
 	enum SUIT
 	{
@@ -93,7 +174,7 @@ namespace POKER
 	// card weight
 	// used by smart AI, smart AI will prefer to keep card with higher weight value
 	// and only use them when: 1. it's necessary to prevent losing 2. no other card can be dealt
-	// special card weight should always has weight >= 1
+	// special card weight should always has weight >= 1 (and <= 3, weight is packed into 2 bits of a card)
 	enum WEIGHT
 	{
 		SP_NULL_WEIGHT		= 0,	// normal card
@@ -105,130 +186,435 @@ namespace POKER
 		SP_PICK_WEIGHT		= 1,	// pick another player
 	};
 
+	// a card packed into one byte
+	// bit 0~3: face value, bit 4~5: suit, bit 6~7: weight (so weight must be 0~3)
 	struct Cards
 	{
-		int value_;			// card value
-		SUIT suit_;			// card suit
-		int weight_;		// card weight
+		unsigned char data_;	// packed card data
 
 		// constructor
-		Cards() : value_(0), suit_(SU_SPADE), weight_(0) {}
+		Cards() : data_(0) {}
 		// constructor
-		Cards(int value, SUIT suit, int weight) 
-			: value_(value), suit_(suit), weight_(weight) {}
+		Cards(int value, SUIT suit, int weight)
+			: data_((unsigned char)(value | (suit << 4) | (weight << 6))) {}
+
+		// card value
+		int GetValue(void) const { return data_ & 0x0F; }
+		// card suit
+		SUIT GetSuit(void) const { return (SUIT)((data_ >> 4) & 0x03); }
+		// card weight
+		int GetWeight(void) const { return data_ >> 6; }
 	};
 
-	typedef std::vector<Cards *> CardList;
+	typedef std::vector<Cards> CardList;
 
-	class Player
+	// index of the lowest set bit of a non-zero mask
+	inline int LowestBit(unsigned int mask)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return (int)index;
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+
+	// index of the highest set bit of a non-zero mask
+	inline int HighestBit(unsigned int mask)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanReverse(&index, mask);
+		return (int)index;
+#else
+		return 31 - __builtin_clz(mask);
+#endif
+	}
+
+	// active-seat ring: bit i of active is set if player i is still in the game
+	// next player still in the game after player_num in the given order (player_num itself may be out)
+	inline int NextActiveSeat(unsigned int active, int player_num, bool is_order_increase)
+	{
+		if (is_order_increase)
+		{
+			unsigned int after = active & ~((2u << player_num) - 1);
+			return LowestBit(after ? after : active);
+		}
+
+		unsigned int before = active & ((1u << player_num) - 1);
+		return HighestBit(before ? before : active);
+	}
+
+	// player still in the game who starts a round in the given order (first seat of the ring)
+	inline int FirstActiveSeat(unsigned int active, bool is_order_increase)
+	{
+		return is_order_increase ? LowestBit(active) : HighestBit(active);
+	}
+
+	// draw a card with one step of a lazy Fisher-Yates shuffle (USE_LAZY_SHUFFLE):
+	// a random card of the rest of the deck is swapped to the current position and dealt
+	// step is the 32-bit random number of the step, antithetic mirrors the pick within the rest
+	inline Cards DrawShuffled(Cards deck[], int &deck_index, Random &rng, uint32_t step, bool is_antithetic = false)
+	{
+		int k = rng.Bounded(NUM_CARDS - deck_index, step);
+
+		std::swap(deck[deck_index], deck[is_antithetic ? NUM_CARDS - 1 - k : deck_index + k]);
+
+		return deck[deck_index++];
+	}
+
+	// special card mapping and weights of the default game (the SPECIAL and WEIGHT enums)
+	// to play with other special cards, define a struct with the same members and pass it to Rules
+	struct DefaultSpecials
+	{
+		static const int SP_10				= POKER::SP_10;
+		static const int SP_20				= POKER::SP_20;
+		static const int SP_99				= POKER::SP_99;
+		static const int SP_REVERSE			= POKER::SP_REVERSE;
+		static const int SP_SKIP			= POKER::SP_SKIP;
+		static const int SP_PICK			= POKER::SP_PICK;
+
+		static const int SP_10_WEIGHT		= POKER::SP_10_WEIGHT;
+		static const int SP_20_WEIGHT		= POKER::SP_20_WEIGHT;
+		static const int SP_99_WEIGHT		= POKER::SP_99_WEIGHT;
+		static const int SP_REVERSE_WEIGHT	= POKER::SP_REVERSE_WEIGHT;
+		static const int SP_SKIP_WEIGHT		= POKER::SP_SKIP_WEIGHT;
+		static const int SP_PICK_WEIGHT		= POKER::SP_PICK_WEIGHT;
+	};
+
+	// rules of a game, known at compile time
+	template <int PLAYERS, int CARDS_PER_PLAYER, int LIMIT = RUNNING_TOTAL_LIMIT, typename SPECIALS = DefaultSpecials>
+	struct Rules : public SPECIALS
+	{
+		static_assert((PLAYERS >= 2) && (PLAYERS <= MAX_PLAYERS), "number of players must be 2 ~ MAX_PLAYERS");
+		static_assert(PLAYERS * CARDS_PER_PLAYER < NUM_CARDS, "not enough cards to deal");
+
+		static const int NUM_PLAYERS			= PLAYERS;
+		static const int NUM_CARDS_PER_PLAYER	= CARDS_PER_PLAYER;
+		static const int RUNNING_TOTAL_LIMIT	= LIMIT;
+	};
+
+	// rules set by the constants above
+	typedef Rules<NUM_PLAYERS, NUM_CARDS_PER_PLAYER, RUNNING_TOTAL_LIMIT> DefaultRules;
+
+	// rule parameters of an engine, shadow the global defaults inside PlayerT and NintyNineT
+	// so the code of the engine reads the same as with the global constants
+#define NINTYNINE_RULE_PARAMETERS(RULES)											\
+	static const int NUM_PLAYERS			= RULES::NUM_PLAYERS;					\
+	static const int NUM_CARDS_PER_PLAYER	= RULES::NUM_CARDS_PER_PLAYER;			\
+	static const int RUNNING_TOTAL_LIMIT	= RULES::RUNNING_TOTAL_LIMIT;			\
+	static const int NUM_TURNS_LIMIT		= NUM_ROUNDS_LIMIT * RULES::NUM_PLAYERS;	\
+	static const int SP_10					= RULES::SP_10;							\
+	static const int SP_20					= RULES::SP_20;							\
+	static const int SP_99					= RULES::SP_99;							\
+	static const int SP_REVERSE				= RULES::SP_REVERSE;					\
+	static const int SP_SKIP				= RULES::SP_SKIP;						\
+	static const int SP_PICK				= RULES::SP_PICK;						\
+	static const int SP_10_WEIGHT			= RULES::SP_10_WEIGHT;					\
+	static const int SP_20_WEIGHT			= RULES::SP_20_WEIGHT;					\
+	static const int SP_99_WEIGHT			= RULES::SP_99_WEIGHT;					\
+	static const int SP_REVERSE_WEIGHT		= RULES::SP_REVERSE_WEIGHT;				\
+	static const int SP_SKIP_WEIGHT			= RULES::SP_SKIP_WEIGHT;				\
+	static const int SP_PICK_WEIGHT			= RULES::SP_PICK_WEIGHT;
+
+	// player hands, stored inline with a fixed number of cards
+	template <int SIZE>
+	struct HandT
+	{
+		Cards cards_[SIZE];
+
+		Cards &operator[](int index) { return cards_[index]; }
+		const Cards &operator[](int index) const { return cards_[index]; }
+	};
+
+	template <typename RULES>
+	class PlayerT
 	{
 	public:
-		bool is_defeat_;	// flag on if the player is defeated
-		CardList hands_;	// player hands
-		int AI_;			// player AI (the strategy)
+		NINTYNINE_RULE_PARAMETERS(RULES)
 
-		// constructor
-		Player(int ai) : is_defeat_(false), AI_(ai) {}
+		bool is_defeat_;							// flag on if the player is defeated
+		HandT<NUM_CARDS_PER_PLAYER> hands_;			// player hands
+		int AI_;									// player AI (the strategy)
+		const DecisionTable *table_;				// precomputed choices of dumb/smart AI (null: scan hands)
+		const EffectTable *effects_;				// effects dumb/smart AI score their cards with (set by the engine)
 
-		// play game
-		int Play(int total);
+		// constructor
+		PlayerT(int ai = AI_SMART) : is_defeat_(false), AI_(ai), table_(nullptr), effects_(nullptr) {}
 
-		// strategy
+		// strategy (the engine picks the one of each seat, see NintyNineT::Pick)
 
 		// (AI 0) human player
 		int PlayHuman(int total);
 		// (AI 1) randomly choose a card
-		int PlayRandom(void);
+		int PlayRandom(Random &rng);
 		// (AI 2) only pick the highest possible number of cards
-		int PlayerDumb(int total);
+		int PlayerDumb(int total) const;
 		// (AI 3) use special cards when dealing with critical situation
-		int PlayerSmart(int total);
+		int PlayerSmart(int total) const;
+		// (AI 4) Monte Carlo tree search and (AI 5~) strategies loaded from shared libraries
+		// are done by the engine (see mcts.h and strategy.h)
 	};
 
-	typedef std::vector<Player *> PlayerList;
+	// full state of a game between two turns, trivially copyable (a fork is a plain copy, no allocation)
+	// what makes up a game lives here, the AI line-up and what an engine is set to do live in the engine
+	template <typename RULES>
+	struct GameStateT
+	{
+		NINTYNINE_RULE_PARAMETERS(RULES)
+
+		HandT<NUM_CARDS_PER_PLAYER> hands_[NUM_PLAYERS];	// hands of each player
+		Cards deck_[NUM_CARDS];								// deck order
+		Random rng_;										// random number generator of the engine
+		int deck_index_;									// index of the current card of deck
+		int total_;											// running total number
+		int player_num_;									// player to move
+		int players_left_;									// number of players left
+		int num_played_;									// number of cards dealt in this game
+		unsigned int defeat_mask_;							// bit i is set if player i is defeated
+		bool is_order_increase_;							// player order
+	};
+
+	// streaming mean and variance (Welford), can be merged with another one (Chan et al.)
+	struct RunningStat
+	{
+		long long count_;			// number of samples
+		double mean_;				// mean of samples
+		double m2_;					// sum of squared differences from the mean
+
+		RunningStat() : count_(0), mean_(0.0), m2_(0.0) {}
+
+		// add a sample
+		void Add(double x)
+		{
+			++count_;
+			double delta = x - mean_;
+			mean_ += delta / count_;
+			m2_ += delta * (x - mean_);
+		}
+
+		// merge samples recorded by another one
+		void Merge(const RunningStat &other);
+		// sample variance
+		double GetVariance(void) const { return (count_ > 1) ? m2_ / (count_ - 1) : 0.0; }
+		// half width of the confidence interval of the mean (z: z-score of the confidence level)
+		double GetHalfWidth(double z) const;
+	};
 
 	struct GameStats
 	{
 		int num_games_;				// number games played
-		int num_rounds_;			// total number of rounds
+		long long num_rounds_;		// total number of rounds
 		int lowest_rounds_;			// lowest number of rounds of all games
 		int highest_rounds_;		// highest number of rounds of all games
 		int exceed_limit_rounds_;	// number of times that exceed round limit (play too long)
-		int num_turns_;				// total number of rounds
+		long long num_turns_;		// total number of turns
 		int lowest_turns_;			// lowest number of rounds of all games
 		int highest_turns_;			// highest number of rounds of all games
 		int exceed_limit_turns_;	// number of times that exceed round limit (play too long)
+		RunningStat rounds_;		// mean and variance of number of rounds (same samples as num_rounds_)
+		RunningStat turns_;			// mean and variance of number of turns (same samples as num_turns_)
 
 		GameStats() : num_games_(0), num_rounds_(0), lowest_rounds_(0), highest_rounds_(0), exceed_limit_rounds_(0),
 			num_turns_(0), lowest_turns_(0), highest_turns_(0), exceed_limit_turns_(0) {}
 		~GameStats() {}
+
+		// record number of rounds and turns of a game
+		void Record(int num_rounds, int num_turns, int num_turns_limit);
+		// merge stats recorded by another engine
+		void Merge(const GameStats &other);
 	};
 
-	class NintyNine
+	template <typename RULES>
+	class NintyNineT
 	{
 	public:
+		NINTYNINE_RULE_PARAMETERS(RULES)
+
+		typedef PlayerT<RULES> Player;
+		typedef GameStateT<RULES> GameState;
+
+		static_assert(std::is_trivially_copyable<GameState>::value, "game state must be trivially copyable");
+
+		// number of cards dealt kept in history (power of 2, more than one round of NUM_PLAYERS)
+		static const int PLAY_HISTORY = 16;
+
 		// constructor
-		NintyNine(bool is_display);
+		NintyNineT(bool is_display, unsigned long long seed = RANDOM_SEED);
 		// destructor
-		~NintyNine();
+		~NintyNineT();
 
 		// initialize
 		void Initialize(void);
+		// initialize with a given AI for each player (share the line-up of another engine)
+		void Initialize(const int ai_list[]);
 		// play a single game
 		int Play(GameStats &stats);
-		// free
-		void Free(void);
+
+		// start a game (shuffle and deal), player 0 plays first
+		void StartGame(void);
+		// shuffle the deck
+		void Shuffle(void);
+		// deal cards to player
+		void DealCards(void);
+		// one player plays a turn, return true if there's only one player left
+		bool PlayerTurn(int player_num);
+		// one player deals the card at index of its hands, return true if there's only one player left
+		bool PlayCard(int player_num, int index);
+		// get next player not defeated
+		int NextPlayer(int player_num);
+
+		// restart random stream (game index in counter-based mode), also restore deck order
+		void SeedStream(unsigned long long stream);
+		// let dumb/smart AI look up their choices in a table (null to scan hands), call after Initialize
+		// returns false if the table is built for another running total limit or other weights,
+		// or effects other than the special cards of RULES are set (the table only holds those)
+		bool SetDecisionTable(const DecisionTable *table);
+		// play cards with the effects of a compiled table (null: special cards of RULES, see effects.h)
+		// other effects drop the decision table of dumb/smart AI, they score their cards with the effects
+		// returns false if the table is compiled for another running total limit (effects are left unchanged)
+		bool SetEffects(const EffectTable *effects);
+		// record the card picked every turn into a game log (null to stop recording)
+		void SetGameLog(GameLogWriter *log);
+		// trace the events of sampled games into a ring of a trace sink (null to stop tracing)
+		void SetTrace(TraceRing *trace) { trace_ = trace; }
+		// ring the events are traced into (null: not traced)
+		TraceRing *GetTrace(void) const { return trace_; }
+		// shuffle with antithetic draws (every swap index k of 0 ~ i becomes i - k)
+		void SetAntithetic(bool is_antithetic) { is_antithetic_ = is_antithetic; }
+		// save the state of the game, player_num is to move
+		void Snapshot(GameState &state, int player_num) const;
+		// restore a saved state, the AI line-up and settings of the engine are kept
+		void Restore(const GameState &state);
+		// play one turn on a saved state: the player to move deals the card at index (-1: its AI picks),
+		// then the next player is to move, returns true if there's only one player left
+		bool Step(GameState &state, int index = -1);
+		// card picked by the registered strategy of a player (not human), random is the random number of the turn
+		int PlayStrategy(int player_num, unsigned long long random) const;
+		// redeal the cards player_num can't see (hands of other players and the rest of the deck) at random,
+		// and reseed the engine so later shuffles are unknown too; the copy no longer traces or records
+		void Determinize(int player_num, Random &rng);
+		// replay a logged game (same AI, random stream and picks), returns the winner
+		// or -1 if the record does not match the game (picks run out, left over or random picks differ)
+		int Replay(const GameRecord &record, GameStats &stats);
 
 		// Get a full deck
 		CardList GetDeck(void);
 		// Get running total
-		int GetRunningTotal(void);
-		// Get player list
-		PlayerList GetPlayerList(void);
+		int GetRunningTotal(void) const;
+		// Get player order
+		bool IsOrderIncrease(void) const;
+		// Get number of players not defeated
+		int GetPlayersLeft(void) const;
+		// Get a player
+		const Player &GetPlayer(int player_num) const;
+		// Get random seed
+		unsigned long long GetSeed(void) const;
+		// Get effects cards are played with (see SetEffects)
+		const EffectTable *GetEffects(void) const { return effects_; }
+		// Get random stream (game index in counter-based mode)
+		unsigned long long GetStream(void) const { return stream_; }
+		// Get number of games started by this engine
+		unsigned int GetNumStarted(void) const { return num_started_; }
+		// Get number of rounds of the last game played (as counted by Play)
+		int GetNumRounds(void) const { return num_rounds_; }
+		// Get number of turns of the last game played (as counted by Play)
+		int GetNumTurns(void) const { return num_turns_; }
+		// Get order in which a player is defeated in this game (1: first out, 0: not defeated)
+		int GetOutRank(int player_num) const { return out_rank_[player_num]; }
+		// Get number of cards dealt in this game
+		int GetNumPlayed(void) const { return num_played_; }
+		// Get player who dealt the n-th card of this game (one of the last PLAY_HISTORY cards)
+		int GetPlayedBy(int n) const { return history_[n & (PLAY_HISTORY - 1)] >> 4; }
+		// Get face value of the n-th card of this game (one of the last PLAY_HISTORY cards)
+		int GetPlayedValue(int n) const { return history_[n & (PLAY_HISTORY - 1)] & 0x0F; }
 
 		// display deck
 		void DisplayDeck(void);
 		// display players' hands
 		void DisplayHands(void);
 
+		// create 52 cards in the order of a new deck
+		static void CreateCards(Cards cards[]);
+
+#if NINTYNINE_PROFILE
+		// add hot-path counters of this engine to profile, then reset them
+		void MergeProfile(Profile &profile);
+#endif
+
 	private:
-		CardList cards_;			// total cards
-		CardList deck_;				// one deck of cards
-		int deck_index_;			// index of the current card of deck
-		PlayerList players_;		// players
-		int total_;					// running total number
-		int players_left_;			// number of players left
-		bool is_order_increase_;	// player order
-		bool is_display_;			// display game info
+		Cards cards_[NUM_CARDS];		// total cards
+		Cards deck_[NUM_CARDS];			// one deck of cards
+		int deck_index_;				// index of the current card of deck
+		Player players_[NUM_PLAYERS];	// players
+		int total_;						// running total number
+		int players_left_;				// number of players left
+		unsigned int active_mask_;		// bit i is set if player i is not defeated (active-seat ring)
+		bool is_order_increase_;		// player order
+		bool is_antithetic_;			// shuffle with antithetic draws
+		unsigned long long seed_;		// random seed
+		unsigned long long stream_;		// random stream
+		Random rng_;					// random number generator
+		unsigned char history_[PLAY_HISTORY];	// last cards dealt: player << 4 | face value
+		int num_played_;				// number of cards dealt in this game
+		unsigned int num_started_;		// number of games started
+		int num_rounds_;				// number of rounds of the last game played
+		int num_turns_;					// number of turns of the last game played
+		unsigned char out_rank_[NUM_PLAYERS];	// order in which each player is defeated (0: not defeated, not part of GameState)
+		std::shared_ptr<MctsT<RULES> > mcts_[NUM_PLAYERS];	// search of each MCTS player (shared by copies)
+		const StrategyPlugin *strategy_[NUM_PLAYERS];		// registered strategy of each player (null: human player)
+		const EffectTable *effects_;	// effect of each card on each running total (shared by copies)
+		GameLogWriter *log_;			// game log recording picks (null: not recorded)
+		TraceRing *trace_;				// ring of the game trace (null: not traced, console trace if displayed)
+		int trace_level_;				// verbosity of the current game (TRACE_OFF if it is not sampled)
+		unsigned long long trace_game_;	// index of the current game in the trace
+		const GameRecord *replay_;		// game being replayed (null: players pick cards)
+		int replay_pick_;				// index of the next pick of the replayed game
+		bool is_replay_error_;			// the replayed game does not match its record
+#if NINTYNINE_PROFILE
+		Profile profile_;				// hot-path counters
+#endif
 
 		// create a deck of 52 cards
 		void CreateDeck(void);
-		// free deck
-		void FreeDeck(void);
 		// initialize players
 		void InitPlayers(void);
-		// free players
-		void FreePlayers(void);
+		// initialize players from a given AI list
+		void InitPlayers(const int ai_list[]);
+		// look up the strategy of each player, create a search for each MCTS player
+		void InitStrategies(void);
+
+		// card pick of a player, a switch on its AI (loaded strategies through their plugin)
+		int Pick(int player_num);
+		// card pick of each AI
+		int PickHuman(int player_num);
+		int PickRandom(int player_num);
+		int PickDumb(int player_num);
+		int PickSmart(int player_num);
+		int PickMcts(int player_num);
+		int PickExternal(int player_num);
+
+		// card slot picked by a player from the replayed game
+		int ReplayPick(int player_num);
 
-		// shuffle the deck
-		void Shuffle(void);
-		// deal cards to player
-		void DealCards(void);
-		// one player plays a turn, return true if there's only one player left
-		bool PlayerTurn(int player_num);
 		// add card number to running total, also deals special cards
 		void AddRunningTotal(int value);
 		// check if the player loses (running total higher than RUNNING_TOTAL_LIMIT)
 		void CheckRunningTotal(int player_num);
-		// get next player
-		int NextPlayer(int player_num);
+		// push an event of the current game to the trace
+		void Trace(int type, int player_num, int value, int arg = 0);
 	};
 
+	// engine and player of the default rules
+	typedef NintyNineT<DefaultRules> NintyNine;
+	typedef PlayerT<DefaultRules> Player;
+
 	// Display card
 	char DisplayCard(int value);
 	// Display special cards
-	void DisplaySpecial(const CardList list);
+	void DisplaySpecial(const Cards *list, int num_cards);
 	// Display AI status
-	char *DisplayAI(int ai);
+	const char *DisplayAI(int ai);
 }
 
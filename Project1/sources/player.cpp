@@ -21,45 +21,14 @@ Approach:
    weight.
 ******************************************************************************/
 
-#include <cstdlib>		// std::rand
-
+#include "decision.h"
+#include "effects.h"
 #include "nintynine.h"
 
 using namespace POKER;
 
 // public functions
 
-/*--------------------------------------------------------------------------*
-Name:           Play
-
-Description:	Each player takes turn.
-
-Arguments:      total: Current running total. (Random player doesn't care)
-
-Returns:        Running total after this turn.
-*---------------------------------------------------------------------------*/
-int Player::Play(int total)
-{
-	switch (AI_)
-	{
-	case AI_RANDOM:
-		return PlayRandom();
-		break;
-
-	case AI_DUMB:
-		return PlayerDumb(total);
-		break;
-
-	case AI_SMART:
-		return PlayerSmart(total);
-		break;
-
-	default:
-		return PlayHuman(total);
-		break;
-	}
-}
-
 /*--------------------------------------------------------------------------*
 Name:           PlayHuman
 
@@ -69,17 +38,18 @@ Arguments:      total: Current running total.
 
 Returns:        Running total after this turn.
 *---------------------------------------------------------------------------*/
-int Player::PlayHuman(int total)
+template <typename RULES>
+int PlayerT<RULES>::PlayHuman(int total)
 {
 	printf("Total: %d\n", total);
 	printf("Your hands: ");
 	for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
-		printf(" %c  ", DisplayCard(hands_[i]->value_));
+		printf(" %c  ", DisplayCard(hands_[i].GetValue()));
 	printf("\n            ");
 	for (int i = 1; i <= NUM_CARDS_PER_PLAYER; ++i)
 		printf("(%d) ", i);
 	printf("\n");
-	DisplaySpecial(hands_);
+	DisplaySpecial(hands_.cards_, NUM_CARDS_PER_PLAYER);
 	printf("\nYour choice (1-%d): ", NUM_CARDS_PER_PLAYER);
 
 	int input = 1;
@@ -94,13 +64,14 @@ Name:           PlayRandom
 
 Description:	(AI 1) "random" player. Randomly choose a card from hands.
 
-Arguments:      None.
+Arguments:      rng: Random number generator of the engine.
 
 Returns:        Running total after this turn.
 *---------------------------------------------------------------------------*/
-int Player::PlayRandom(void)
+template <typename RULES>
+int PlayerT<RULES>::PlayRandom(Random &rng)
 {
-	return std::rand() % NUM_CARDS_PER_PLAYER;
+	return rng.Range(NUM_CARDS_PER_PLAYER);
 }
 
 /*--------------------------------------------------------------------------*
@@ -109,28 +80,34 @@ Name:           PlayerDumb
 Description:	(AI 2) "dumb" player. Only pick the highest possible number of cards.
 It will not pick the card that will get the running total to exceed the limit.
 Also it does not know about the special ability on card.
+Normal cards add what the effect table says, special cards are taken for their face value.
 
 Arguments:      total: Current running total.
 
 Returns:        Running total after this turn.
 *---------------------------------------------------------------------------*/
-int Player::PlayerDumb(int total)
+template <typename RULES>
+int PlayerT<RULES>::PlayerDumb(int total) const
 {
-	int value = 0;
+	if (table_ != nullptr)
+		return table_->PlayDumb(total, hands_.cards_, NUM_CARDS_PER_PLAYER);
+
+	int best_total = -1;
 	int card_index = 0;
-	int value_limit = RUNNING_TOTAL_LIMIT - total;
 
-	// go through all cards on hand, find the largest value not exceeding limit
+	// go through all cards on hand, find the highest running total not exceeding limit
 
 	for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
 	{
-		if (hands_[i]->value_ > value)
+		// special cards are taken for their face value, selected with a mask (about half the cards are special)
+		int value = hands_[i].GetValue();
+		int new_total = effects_->Get(total, value).total_;
+		new_total += (total + value - new_total) & -(effects_->GetWeight(value) != SP_NULL_WEIGHT);
+
+		if ((new_total > best_total) && (new_total <= RUNNING_TOTAL_LIMIT))
 		{
-			if (hands_[i]->value_ <= value_limit)
-			{
-				card_index = i;
-				value = hands_[i]->value_;
-			}
+			card_index = i;
+			best_total = new_total;
 		}
 	}
 
@@ -145,41 +122,51 @@ First, it will try to pick the highest possible number of cards. (but it knows t
 If there's no normal card it can deal, it will then choose special ability cards.
 But it will deal the ones with lower weight first.
 And only save the most important ones (highest weight) to last.
+Cards are scored by the running total and weight of the effect table, so the
+weights follow the effects (see EffectTable::GetWeight).
 
 Arguments:      total: Current running total.
 
 Returns:        Running total after this turn.
 *---------------------------------------------------------------------------*/
-int Player::PlayerSmart(int total)
+template <typename RULES>
+int PlayerT<RULES>::PlayerSmart(int total) const
 {
-	int value = 0;
+	if (table_ != nullptr)
+		return table_->PlaySmart(total, hands_.cards_, NUM_CARDS_PER_PLAYER);
+
+	int best_total = -1;
 	int card_index = 0;
-	int value_limit = RUNNING_TOTAL_LIMIT - total;
 	bool can_use_normal_card = false;
 
 	int special_index = 0;
+	int weights[NUM_CARDS_PER_PLAYER];
 
 	// go through all normal cards (weight == SP_NULL_WEIGHT) on hand
-	// find the largest value not exceeding limit
+	// find the highest running total not exceeding limit
 	// if no card is found, use special card
 
 	for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
 	{
+		int value = hands_[i].GetValue();
+		weights[i] = effects_->GetWeight(value);
+
 		// find special card (weight 1 than weight 2)
-		if ((special_index == 0) && (hands_[i]->weight_ != SP_NULL_WEIGHT))
+		if ((special_index == 0) && (weights[i] != SP_NULL_WEIGHT))
 		{
-			if ((hands_[i]->weight_ == 2) && (hands_[special_index]->weight_ == 0))
+			if ((weights[i] == 2) && (weights[special_index] == 0))
 				special_index = i;
-			else if ((hands_[i]->weight_ == 1) && (hands_[special_index]->weight_ != 1))
+			else if ((weights[i] == 1) && (weights[special_index] != 1))
 				special_index = i;
 		}
 
-		if ((hands_[i]->weight_ == SP_NULL_WEIGHT) && (hands_[i]->value_ > value))
+		int new_total = effects_->Get(total, value).total_;
+		if ((weights[i] == SP_NULL_WEIGHT) && (new_total > best_total))
 		{
-			if (hands_[i]->value_ <= value_limit)
+			if (new_total <= RUNNING_TOTAL_LIMIT)
 			{
 				card_index = i;
-				value = hands_[i]->value_;
+				best_total = new_total;
 				can_use_normal_card = true;
 			}
 		}
@@ -191,6 +178,12 @@ int Player::PlayerSmart(int total)
 		return special_index;
 }
 
+// pre-instantiated players
+
+#define NINTYNINE_INSTANTIATE(players, cards) template class POKER::PlayerT<Rules<players, cards> >;
+NINTYNINE_CONFIGS(NINTYNINE_INSTANTIATE)
+#undef NINTYNINE_INSTANTIATE
+
 /******************************************************************************
 Unit tests:
 1. human vs. random for 2 matches. Human always win.
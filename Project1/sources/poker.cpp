@@ -3,6 +3,7 @@
 // All content © 2014 DigiPen(USA) Corporation, all rights reserved.
 
 #include "nintynine.h"
+#include "strategy.h"
 
 using namespace POKER;
 
@@ -38,10 +39,11 @@ Name:           DisplaySpecial
 Description:	Display special cards.
 
 Arguments:      list: card list.
+				num_cards: number of cards in the list.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-void POKER::DisplaySpecial(CardList list)
+void POKER::DisplaySpecial(const Cards *list, int num_cards)
 {
 	bool is_SP_10 = false;
 	bool is_SP_20 = false;
@@ -51,26 +53,26 @@ void POKER::DisplaySpecial(CardList list)
 	bool is_SP_PICK = false;
 	bool is_special = false;
 
-	for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
+	for (int i = 0; i < num_cards; ++i)
 	{
 		// use weight to detect if the card is special
 		// normal card always has weight 0
 
-		if (list[i]->weight_)
+		if (list[i].GetWeight())
 		{
 			is_special = true;
 
-			if (list[i]->value_ == SP_10)
+			if (list[i].GetValue() == SP_10)
 				is_SP_10 = true;
-			if (list[i]->value_ == SP_20)
+			if (list[i].GetValue() == SP_20)
 				is_SP_20 = true;
-			if (list[i]->value_ == SP_99)
+			if (list[i].GetValue() == SP_99)
 				is_SP_99 = true;
-			if (list[i]->value_ == SP_REVERSE)
+			if (list[i].GetValue() == SP_REVERSE)
 				is_SP_REVERSE = true;
-			if (list[i]->value_ == SP_SKIP)
+			if (list[i].GetValue() == SP_SKIP)
 				is_SP_SKIP = true;
-			if (list[i]->value_ == SP_PICK)
+			if (list[i].GetValue() == SP_PICK)
 				is_SP_PICK = true;
 		}
 	}
@@ -102,14 +104,13 @@ Arguments:      ai: player AI.
 
 Returns:        None.
 *---------------------------------------------------------------------------*/
-char *POKER::DisplayAI(int ai)
+const char *POKER::DisplayAI(int ai)
 {
 	if (ai == AI_PLAYER)
 		return "Human";
-	else if (ai == AI_RANDOM)
-		return "Monkey";
-	else if (ai == AI_DUMB)
-		return "Idiot";
-	else
-		return "Smart";
+
+	// built-in or loaded strategy
+	const StrategyPlugin *strategy = GetStrategy(ai);
+
+	return (strategy != nullptr) ? strategy->name_ : "External";
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Hot-path instrumentation of the engine
+
+#include <cstdio>
+
+#include "nintynine.h"
+#include "profile.h"
+
+#if NINTYNINE_PROFILE
+
+using namespace POKER;
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           Clear
+
+Description:	Reset all counters.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void Profile::Clear(void)
+{
+	for (int i = 0; i < PC_NUMBER; ++i)
+		counts_[i] = 0;
+
+	for (int i = 0; i < PT_NUMBER; ++i)
+	{
+		calls_[i] = 0;
+		ticks_[i] = 0;
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Merge
+
+Description:	Add counters recorded by another engine.
+
+Arguments:      other: Counters to be merged.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void Profile::Merge(const Profile &other)
+{
+	for (int i = 0; i < PC_NUMBER; ++i)
+		counts_[i] += other.counts_[i];
+
+	for (int i = 0; i < PT_NUMBER; ++i)
+	{
+		calls_[i] += other.calls_[i];
+		ticks_[i] += other.ticks_[i];
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Display
+
+Description:	Display counters and average ticks of timed calls.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void Profile::Display(void) const
+{
+	static const char *effect_names[] = { "add", "turn", "set", "reverse", "skip", "pick" };
+
+	printf("\nProfile (time in CPU ticks):\n");
+
+	printf("Shuffles: %llu (deck ran out during a game: %llu), average %.1f ticks\n",
+		counts_[PC_SHUFFLE], counts_[PC_RESHUFFLE],
+		calls_[PT_SHUFFLE] ? (double)ticks_[PT_SHUFFLE] / calls_[PT_SHUFFLE] : 0.0);
+	printf("Turns: %llu (skipped by defeated players: %llu)\n", counts_[PC_TURN], counts_[PC_DEFEATED_TURN]);
+	printf("Eliminations: %llu\n", counts_[PC_ELIMINATION]);
+
+	for (int i = 0; i < PT_NUMBER - PT_DECISION; ++i)
+	{
+		unsigned long long calls = calls_[PT_DECISION + i];
+		if (calls == 0)
+			continue;
+
+		printf("Decisions of %s AI: %llu, average %.1f ticks\n", DisplayAI(i), calls,
+			(double)ticks_[PT_DECISION + i] / calls);
+	}
+
+	printf("Card effects dealt:");
+	for (int i = 0; i <= PC_EFFECT_PICK - PC_EFFECT_ADD; ++i)
+		printf(" %s %llu", effect_names[i], counts_[PC_EFFECT_ADD + i]);
+	printf("\n");
+}
+
+#endif
\ No newline at end of file
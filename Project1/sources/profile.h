@@ -0,0 +1,94 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Hot-path instrumentation of the engine
+// each engine counts and times its own events (so threads never share counters),
+// the simulation driver merges them into SimResult when the games are done
+// timers read the CPU time stamp counter (ticks, not seconds)
+
+#pragma once
+
+// set this to 1 (here or on the compiler command line) to count and time the engine's hot paths
+// with 0, the PROFILE_* macros are empty and engines and results don't carry a Profile
+#ifndef NINTYNINE_PROFILE
+#define NINTYNINE_PROFILE 0
+#endif
+
+#if NINTYNINE_PROFILE
+
+#ifdef _MSC_VER
+#include <intrin.h>		// __rdtsc
+#else
+#include <x86intrin.h>	// __rdtsc
+#endif
+
+namespace POKER
+{
+	struct Profile
+	{
+		// events counted
+		enum COUNTER
+		{
+			PC_SHUFFLE,				// deck shuffled
+			PC_RESHUFFLE,			// deck ran out during a game and was shuffled again
+			PC_TURN,				// turns played
+			PC_DEFEATED_TURN,		// turns skipped by defeated players
+			PC_ELIMINATION,			// players defeated
+			PC_EFFECT_ADD,			// cards dealt with an effect on the total (same order as EFFECT_KIND from EK_ADD)
+			PC_EFFECT_TURN,
+			PC_EFFECT_SET,
+			PC_EFFECT_REVERSE,		// cards dealt with a flag (same order as EFFECT_FLAG)
+			PC_EFFECT_SKIP,
+			PC_EFFECT_PICK,
+			PC_NUMBER,
+		};
+
+		// code timed
+		enum TIMER
+		{
+			PT_SHUFFLE,				// shuffling the deck
+			PT_DECISION,			// AI decisions (one timer per AI_ID, PT_DECISION + AI)
+			PT_NUMBER = PT_DECISION + 5,
+		};
+
+		unsigned long long counts_[PC_NUMBER];		// number of events
+		unsigned long long calls_[PT_NUMBER];		// number of timed calls
+		unsigned long long ticks_[PT_NUMBER];		// total ticks of timed calls
+
+		// constructor
+		Profile() { Clear(); }
+
+		// reset all counters
+		void Clear(void);
+		// add counters of another engine
+		void Merge(const Profile &other);
+		// display counters
+		void Display(void) const;
+
+		// add a timed call started at start_ticks
+		void AddTime(int timer, unsigned long long start_ticks)
+		{
+			++calls_[timer];
+			ticks_[timer] += GetTicks() - start_ticks;
+		}
+
+		// current value of the time stamp counter
+		static unsigned long long GetTicks(void) { return __rdtsc(); }
+	};
+}
+
+// count an event
+#define PROFILE_COUNT(profile, counter)			(++(profile).counts_[POKER::Profile::counter])
+// start a timer (declares a local variable named name)
+#define PROFILE_START(name)						unsigned long long name = POKER::Profile::GetTicks()
+// stop a timer started by PROFILE_START
+#define PROFILE_STOP(profile, timer, name)		((profile).AddTime(POKER::Profile::timer, name))
+
+#else
+
+#define PROFILE_COUNT(profile, counter)			((void)0)
+#define PROFILE_START(name)						((void)0)
+#define PROFILE_STOP(profile, timer, name)		((void)0)
+
+#endif
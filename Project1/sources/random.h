@@ -0,0 +1,120 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Random number generator owned by each engine (xoshiro256**)
+// seeded explicitly, so games can be reproduced and engines can run on different threads
+// Seed(seed, stream) gives an independent stream for each stream number (counter-based mode)
+// Bounded gives integers in a range without bias, Fill generates many numbers in one go
+
+#pragma once
+
+#include <cstdint>
+
+namespace POKER
+{
+	class Random
+	{
+	public:
+		// constructor
+		Random(uint64_t seed = 0) { Seed(seed); }
+
+		// seed the generator
+		void Seed(uint64_t seed) { Seed(seed, 0); }
+
+		// seed the generator to the given stream of a seed
+		// the same (seed, stream) pair always gives the same sequence
+		void Seed(uint64_t seed, uint64_t stream)
+		{
+			uint64_t x = Hash(seed) ^ Hash(stream + 0x632BE59BD9B4E019ULL);
+
+			for (int i = 0; i < 4; ++i)
+				state_[i] = SplitMix(x);
+		}
+
+		// get next 64-bit random number
+		uint64_t Next(void)
+		{
+			uint64_t result = Rotate(state_[1] * 5, 7) * 9;
+			uint64_t t = state_[1] << 17;
+
+			state_[2] ^= state_[0];
+			state_[3] ^= state_[1];
+			state_[1] ^= state_[2];
+			state_[0] ^= state_[3];
+			state_[2] ^= t;
+			state_[3] = Rotate(state_[3], 45);
+
+			return result;
+		}
+
+		// get next 32-bit random number (high half of a 64-bit one)
+		uint32_t Next32(void) { return (uint32_t)(Next() >> 32); }
+
+		// fill a buffer with 32-bit random numbers, both halves of each 64-bit number are used
+		void Fill(uint32_t *buffer, int count)
+		{
+			int i = 0;
+
+			for (; i + 1 < count; i += 2)
+			{
+				uint64_t x = Next();
+				buffer[i] = (uint32_t)(x >> 32);
+				buffer[i + 1] = (uint32_t)x;
+			}
+
+			if (i < count)
+				buffer[i] = Next32();
+		}
+
+		// get random number in [0, range)
+		// (multiply-shift, slightly biased toward some numbers when range is not a power of 2)
+		int Range(int range)
+		{
+			return (int)(((Next() >> 32) * (uint64_t)range) >> 32);
+		}
+
+		// get random number in [0, range) without bias (Lemire's multiply and reject)
+		// x is the first 32-bit random number tried, more are drawn only if it is rejected
+		int Bounded(uint32_t range, uint32_t x)
+		{
+			uint64_t m = (uint64_t)x * range;
+			uint32_t low = (uint32_t)m;
+
+			if (low < range)
+			{
+				// reject the numbers that would make some results more likely (2^32 mod range of them)
+				uint32_t threshold = (0u - range) % range;
+
+				while (low < threshold)
+				{
+					m = (uint64_t)Next32() * range;
+					low = (uint32_t)m;
+				}
+			}
+
+			return (int)(m >> 32);
+		}
+
+		// get random number in [0, range) without bias
+		int Bounded(uint32_t range) { return Bounded(range, Next32()); }
+
+	private:
+		uint64_t state_[4];		// generator state
+
+		// rotate left
+		static uint64_t Rotate(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+		// split mix 64, used to expand seeds into generator state
+		static uint64_t SplitMix(uint64_t &x)
+		{
+			uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		}
+
+		// hash a value with split mix 64
+		static uint64_t Hash(uint64_t x) { return SplitMix(x); }
+	};
+}
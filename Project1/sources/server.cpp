@@ -0,0 +1,563 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Local game server: sessions (turn state machines) and the epoll loop
+
+#include <cstdarg>		// va_list
+#include <cstdio>		// std::vsnprintf, std::sscanf
+#include <cstring>		// std::strncmp, std::strerror, std::memchr
+#include <ctime>		// std::time
+#include <memory>		// std::unique_ptr
+#include <vector>
+
+#include "server.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace POKER;
+
+// number of events taken from epoll at a time
+static const int SERVER_EVENTS = 256;
+// milliseconds before accepting again once the process runs out of file descriptors
+static const int SERVER_ACCEPT_RETRY = 100;
+
+// append formatted text to the output of a connection
+static void Write(std::string &out, const char *format, ...)
+{
+	char text[128];
+	va_list args;
+
+	va_start(args, format);
+	int length = std::vsnprintf(text, sizeof(text), format, args);
+	va_end(args);
+
+	if (length > 0)
+		out.append(text, (length < (int)sizeof(text)) ? length : (int)sizeof(text) - 1);
+}
+
+// a game of the human player in seat 0 against AI, played one decision at a time
+class ServerSession
+{
+public:
+	// destructor
+	virtual ~ServerSession() {}
+
+	// start a game on a random stream, write what happens until the human player is to move
+	virtual void Start(unsigned long long stream, std::string &out) = 0;
+	// human player deals the card at index, write what happens until it is to move again
+	// returns false if the game is over, it is not the turn of the human player or index is out of range
+	virtual bool Play(int index, std::string &out) = 0;
+	// number of players
+	virtual int GetNumPlayers(void) const = 0;
+	// number of cards each player has
+	virtual int GetNumCardsPerPlayer(void) const = 0;
+};
+
+// session on the engine of a configuration
+// the game is suspended between calls: player_num_ is to move, and is the human player unless the game is over
+template <typename RULES>
+class ServerSessionT : public ServerSession
+{
+public:
+	typedef NintyNineT<RULES> Engine;
+
+	// constructor
+	ServerSessionT(const int ai[], unsigned long long seed, const EffectTable *effects)
+		: game_(false, seed), player_num_(0), is_end_(true)
+	{
+		int ai_list[Engine::NUM_PLAYERS];
+		ai_list[0] = AI_PLAYER;
+		for (int i = 1; i < Engine::NUM_PLAYERS; ++i)
+			ai_list[i] = ai[i];
+
+		game_.Initialize(ai_list);
+		game_.SetEffects(effects);
+	}
+
+	void Start(unsigned long long stream, std::string &out)
+	{
+		game_.SeedStream(stream);
+		game_.StartGame();
+		player_num_ = 0;
+		is_end_ = false;
+
+		Write(out, "GAME %d %d\n", Engine::NUM_PLAYERS, Engine::NUM_CARDS_PER_PLAYER);
+		Run(out);
+	}
+
+	bool Play(int index, std::string &out)
+	{
+		if (is_end_ || (index < 0) || (index >= Engine::NUM_CARDS_PER_PLAYER))
+			return false;
+
+		is_end_ = game_.PlayCard(player_num_, index);
+		Report(player_num_, out);
+		player_num_ = game_.NextPlayer(player_num_);
+
+		Run(out);
+
+		return true;
+	}
+
+	int GetNumPlayers(void) const { return Engine::NUM_PLAYERS; }
+	int GetNumCardsPerPlayer(void) const { return Engine::NUM_CARDS_PER_PLAYER; }
+
+private:
+	Engine game_;		// the game
+	int player_num_;	// player to move
+	bool is_end_;		// the game is over
+
+	// play the turns of AI players inline until the human player is to move or the game ends
+	void Run(std::string &out)
+	{
+		while (!is_end_ && (game_.GetPlayer(player_num_).AI_ != AI_PLAYER))
+		{
+			is_end_ = game_.PlayerTurn(player_num_);
+			Report(player_num_, out);
+			player_num_ = game_.NextPlayer(player_num_);
+		}
+
+		if (is_end_)
+		{
+			for (int i = 0; i < Engine::NUM_PLAYERS; ++i)
+			{
+				if (!game_.GetPlayer(i).is_defeat_)
+					Write(out, "WIN %d\n", i);
+			}
+			return;
+		}
+
+		// human player is to move
+		Write(out, "TURN %d", game_.GetRunningTotal());
+		for (int i = 0; i < Engine::NUM_CARDS_PER_PLAYER; ++i)
+			Write(out, " %d", game_.GetPlayer(player_num_).hands_[i].GetValue());
+		Write(out, "\n");
+	}
+
+	// write the card a player just dealt, and whether it lost
+	void Report(int player_num, std::string &out)
+	{
+		Write(out, "DEAL %d %d %d\n", player_num, game_.GetPlayedValue(game_.GetNumPlayed() - 1), game_.GetRunningTotal());
+
+		if (game_.GetPlayer(player_num).is_defeat_)
+			Write(out, "OUT %d\n", player_num);
+	}
+};
+
+// a client connection
+struct ServerConnection
+{
+	int socket_;								// socket of the connection
+	std::string in_;							// received text not handled yet (part of a line)
+	std::string out_;							// text not sent yet
+	std::unique_ptr<ServerSession> session_;	// game of the connection (null: no game started)
+	bool is_closing_;							// close once out_ is sent
+	unsigned int events_;						// epoll events the socket is watched for
+
+	// constructor
+	ServerConnection(int socket) : socket_(socket), is_closing_(false), events_(0) {}
+};
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           CreateSession
+
+Description:	Create a session on the engine compiled for a configuration.
+
+Arguments:      num_players: Number of players.
+				num_cards_per_player: Number of cards each player has.
+				ai: AI of each seat (seat 0 is the human player).
+				seed: Random seed.
+				effects: Card effects (null: special cards of the rules).
+
+Returns:        Session, null if no engine is compiled for the configuration.
+*---------------------------------------------------------------------------*/
+static ServerSession *CreateSession(int num_players, int num_cards_per_player, const int ai[], unsigned long long seed,
+	const EffectTable *effects)
+{
+#define NINTYNINE_SESSION(players, cards)										\
+	if ((num_players == players) && (num_cards_per_player == cards))			\
+		return new ServerSessionT<Rules<players, cards> >(ai, seed, effects);
+
+	NINTYNINE_CONFIGS(NINTYNINE_SESSION)
+#undef NINTYNINE_SESSION
+
+	return nullptr;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           HandleLine
+
+Description:	Handle a command line of a connection, write the reply.
+
+Arguments:      settings: Server settings.
+				connection: Connection.
+				line: Command line (without line end).
+				seed: Random seed of the server.
+				next_game: Random stream of the next game started.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void HandleLine(const ServerSettings &settings, ServerConnection &connection, const std::string &line,
+	unsigned long long seed, unsigned long long &next_game)
+{
+	std::string &out = connection.out_;
+	int num_players = settings.num_players_;
+	int num_cards_per_player = settings.num_cards_per_player_;
+	int index = 0;
+
+	if (line.empty())
+		return;
+
+	if ((line.compare(0, 3, "NEW") == 0) && ((line.size() == 3) || (line[3] == ' ')))
+	{
+		if ((line.size() > 3) && (std::sscanf(line.c_str() + 3, "%d %d", &num_players, &num_cards_per_player) != 2))
+		{
+			Write(out, "ERROR usage: NEW [players cards]\n");
+			return;
+		}
+
+		ServerSession *session = connection.session_.get();
+		if ((session == nullptr) || (session->GetNumPlayers() != num_players) ||
+			(session->GetNumCardsPerPlayer() != num_cards_per_player))
+		{
+			session = CreateSession(num_players, num_cards_per_player, settings.ai_, seed, settings.effects_);
+			if (session == nullptr)
+			{
+				Write(out, "ERROR no engine for %d players with %d cards\n", num_players, num_cards_per_player);
+				return;
+			}
+
+			connection.session_.reset(session);
+		}
+
+		session->Start(next_game++, out);
+	}
+	else if (std::sscanf(line.c_str(), "PLAY %d", &index) == 1)
+	{
+		if (!connection.session_)
+			Write(out, "ERROR no game, send NEW\n");
+		else if (!connection.session_->Play(index, out))
+			Write(out, "ERROR game is over or bad card index\n");
+	}
+	else if (line == "QUIT")
+		connection.is_closing_ = true;
+	else
+		Write(out, "ERROR unknown command\n");
+}
+
+#ifndef _WIN32
+/*--------------------------------------------------------------------------*
+Name:           CloseConnection
+
+Description:	Stop watching a connection and close it.
+
+Arguments:      poll: epoll instance.
+				connections: Connections (indexed by socket).
+				socket: Socket of the connection.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void CloseConnection(int poll, std::vector<std::unique_ptr<ServerConnection> > &connections, int socket)
+{
+	epoll_ctl(poll, EPOLL_CTL_DEL, socket, nullptr);
+	close(socket);
+	connections[socket].reset();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           SendOutput
+
+Description:	Send as much output of a connection as the socket takes,
+				watch the socket for room to send the rest. Commands are not
+				read while SERVER_MAX_OUTPUT or more is waiting, and the socket
+				stays watched for room to send while read commands wait, so
+				they are handled once the client takes its output.
+
+Arguments:      poll: epoll instance.
+				connection: Connection.
+
+Returns:        false if the connection is to be closed.
+*---------------------------------------------------------------------------*/
+static bool SendOutput(int poll, ServerConnection &connection)
+{
+	size_t sent = 0;
+
+	while (sent < connection.out_.size())
+	{
+		ssize_t length = send(connection.socket_, connection.out_.data() + sent, connection.out_.size() - sent, MSG_NOSIGNAL);
+		if (length < 0)
+		{
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+				break;
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+
+		sent += length;
+	}
+
+	connection.out_.erase(0, sent);
+
+	if (connection.out_.empty() && connection.is_closing_)
+		return false;
+
+	bool is_reading = !connection.is_closing_ && (connection.out_.size() < (size_t)SERVER_MAX_OUTPUT);
+	bool is_waiting_send = !connection.out_.empty() || (connection.in_.find('\n') != std::string::npos);
+	unsigned int events = (is_reading ? (unsigned int)EPOLLIN : 0u) | (is_waiting_send ? (unsigned int)EPOLLOUT : 0u);
+	if (events != connection.events_)
+	{
+		epoll_event event;
+		event.events = events;
+		event.data.fd = connection.socket_;
+		epoll_ctl(poll, EPOLL_CTL_MOD, connection.socket_, &event);
+		connection.events_ = events;
+	}
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           ReceiveInput
+
+Description:	Read what a connection sent and handle every full line.
+				Each chunk read is checked before it is kept, so a client
+				that never ends its line can't grow the input. Once
+				SERVER_MAX_OUTPUT is waiting to be sent, the lines left and
+				the socket are not read any more (see SendOutput).
+
+Arguments:      settings: Server settings.
+				connection: Connection.
+				seed: Random seed of the server.
+				next_game: Random stream of the next game started.
+
+Returns:        false if the connection is closed by the client, fails,
+				or sends a line longer than SERVER_MAX_LINE.
+*---------------------------------------------------------------------------*/
+static bool ReceiveInput(const ServerSettings &settings, ServerConnection &connection, unsigned long long seed,
+	unsigned long long &next_game)
+{
+	char buffer[4096];
+
+	for (;;)
+	{
+		// handle the full lines received, the rest waits while the client does not take its output
+		size_t start = 0;
+		for (size_t end; !connection.is_closing_ && (connection.out_.size() < (size_t)SERVER_MAX_OUTPUT) &&
+			((end = connection.in_.find('\n', start)) != std::string::npos); start = end + 1)
+		{
+			size_t line_end = ((end > start) && (connection.in_[end - 1] == '\r')) ? end - 1 : end;
+			HandleLine(settings, connection, connection.in_.substr(start, line_end - start), seed, next_game);
+		}
+
+		connection.in_.erase(0, start);
+
+		if (connection.is_closing_ || (connection.out_.size() >= (size_t)SERVER_MAX_OUTPUT))
+			break;
+
+		// lines after the first one of the last chunk
+		if (connection.in_.size() > (size_t)SERVER_MAX_LINE)
+			return false;
+
+		ssize_t length = recv(connection.socket_, buffer, sizeof(buffer), 0);
+		if (length == 0)
+			return false;
+		if (length < 0)
+		{
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+				break;
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+
+		// the line waiting for its end must stay within SERVER_MAX_LINE with what this chunk adds to it
+		const char *newline = (const char *)std::memchr(buffer, '\n', length);
+		size_t added = (newline != nullptr) ? (size_t)(newline - buffer) : (size_t)length;
+		if (connection.in_.size() + added > (size_t)SERVER_MAX_LINE)
+			return false;
+
+		connection.in_.append(buffer, length);
+	}
+
+	return true;
+}
+#endif
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           RunServer
+
+Description:	Serve games on the loopback address until the process is stopped.
+				One thread multiplexes all connections: a session only runs
+				when its client sends a command, AI players move inline.
+
+Arguments:      settings: Server settings.
+				error: Why the server can't start.
+
+Returns:        false if the server can't start.
+*---------------------------------------------------------------------------*/
+bool POKER::RunServer(const ServerSettings &settings, std::string &error)
+{
+#ifdef _WIN32
+	error = "the server needs epoll, it runs on Linux only";
+	return false;
+#else
+	unsigned long long seed = (settings.seed_ != 0) ? settings.seed_ : (unsigned long long)std::time(0);
+	unsigned long long next_game = 0;
+
+	// listen on the loopback address
+
+	int listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	if (listener < 0)
+	{
+		error = std::strerror(errno);
+		return false;
+	}
+
+	int reuse = 1;
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons((unsigned short)settings.port_);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	if ((bind(listener, (const sockaddr *)&address, sizeof(address)) != 0) || (listen(listener, SOMAXCONN) != 0))
+	{
+		error = std::strerror(errno);
+		close(listener);
+		return false;
+	}
+
+	int poll = epoll_create1(0);
+	epoll_event event;
+	event.events = EPOLLIN;
+	event.data.fd = listener;
+	if ((poll < 0) || (epoll_ctl(poll, EPOLL_CTL_ADD, listener, &event) != 0))
+	{
+		error = std::strerror(errno);
+		close(listener);
+		return false;
+	}
+
+	// serve connections
+
+	std::vector<std::unique_ptr<ServerConnection> > connections;
+	int num_connections = 0;
+	epoll_event events[SERVER_EVENTS];
+
+	// the listener stops being watched while the process is out of file descriptors,
+	// otherwise the pending connection keeps it readable and epoll returns it right away forever
+	bool is_listening = true;
+
+	for (;;)
+	{
+		int num_events = epoll_wait(poll, events, SERVER_EVENTS, is_listening ? -1 : SERVER_ACCEPT_RETRY);
+		if (num_events < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			error = std::strerror(errno);
+			break;
+		}
+
+		// try again to accept (connections may have closed since)
+		if (!is_listening)
+		{
+			event.events = EPOLLIN;
+			event.data.fd = listener;
+			is_listening = (epoll_ctl(poll, EPOLL_CTL_ADD, listener, &event) == 0);
+		}
+
+		for (int i = 0; i < num_events; ++i)
+		{
+			int socket = events[i].data.fd;
+
+			// new connections
+			if (socket == listener)
+			{
+				int client;
+				while ((client = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK)) >= 0)
+				{
+					if (num_connections >= settings.max_sessions_)
+					{
+						close(client);
+						continue;
+					}
+
+					if ((size_t)client >= connections.size())
+						connections.resize(client + 1);
+
+					connections[client].reset(new ServerConnection(client));
+					++num_connections;
+
+					event.events = EPOLLIN;
+					event.data.fd = client;
+					epoll_ctl(poll, EPOLL_CTL_ADD, client, &event);
+
+					ServerConnection &connection = *connections[client];
+					connection.events_ = EPOLLIN;
+					Write(connection.out_, "HELLO %d %d %d\n", settings.num_players_, settings.num_cards_per_player_,
+						RUNNING_TOTAL_LIMIT);
+					if (!SendOutput(poll, connection))
+					{
+						CloseConnection(poll, connections, client);
+						--num_connections;
+					}
+				}
+
+				// pending connections wait in the backlog until descriptors are free again
+				if ((errno == EMFILE) || (errno == ENFILE))
+				{
+					epoll_ctl(poll, EPOLL_CTL_DEL, listener, nullptr);
+					is_listening = false;
+				}
+				continue;
+			}
+
+			// commands and room to send on a connection
+			if (((size_t)socket >= connections.size()) || !connections[socket])
+				continue;
+
+			ServerConnection &connection = *connections[socket];
+			bool is_open = ((events[i].events & (EPOLLERR | EPOLLHUP)) == 0);
+
+			// lines held back at SERVER_MAX_OUTPUT are handled on room to send
+			bool has_lines = (connection.in_.find('\n') != std::string::npos);
+			if (is_open && ((events[i].events & EPOLLIN) || has_lines))
+				is_open = ReceiveInput(settings, connection, seed, next_game);
+			if (is_open)
+				is_open = SendOutput(poll, connection);
+
+			if (!is_open)
+			{
+				CloseConnection(poll, connections, socket);
+				--num_connections;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < connections.size(); ++i)
+	{
+		if (connections[i])
+			close((int)i);
+	}
+	close(poll);
+	close(listener);
+
+	return false;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Local game server: many human-vs-AI tables in one process
+// every connection is a session playing one game at a time, the human player sits in seat 0
+// a session is a state machine around NintyNine::PlayerTurn: AI seats play inline as soon as they
+// are to move, and the game suspends (no thread is held) when the human player is to move
+// connections are multiplexed on one epoll loop on the loopback address (Linux only)
+// a session of smart/dumb/random AI takes a few hundred bytes, but an MCTS seat keeps its own search tree
+// (MCTS_NODES nodes), so line-ups with MCTS only suit a few hundred sessions
+//
+// line protocol, client to server:
+//   NEW [players cards]    start a new game (default: rules of the server)
+//   PLAY index             human player deals the card at index of its hands
+//   QUIT                   close the connection
+// server to client:
+//   HELLO players cards limit      on connection, default rules of the server
+//   GAME players cards             a game starts
+//   DEAL player value total        a player deals a card, total is the running total after it
+//   OUT player                     a player loses
+//   TURN total value ...           human player is to move, face values of its hands
+//   WIN player                     the game ends
+//   ERROR message                  bad command, the game is unchanged
+
+#pragma once
+
+#include <string>
+
+#include "nintynine.h"
+
+namespace POKER
+{
+	// largest number of connections served at the same time
+	static const int SERVER_MAX_SESSIONS = 10000;
+	// longest command line accepted, a connection sending a longer line is closed
+	static const int SERVER_MAX_LINE = 256;
+	// output a connection may hold before its commands are no longer read (until the client takes the output)
+	static const int SERVER_MAX_OUTPUT = 64 * 1024;
+
+	// settings of the server
+	struct ServerSettings
+	{
+		int port_;						// TCP port on the loopback address
+		int num_players_;				// default number of players of a game
+		int num_cards_per_player_;		// default number of cards each player has
+		int ai_[MAX_PLAYERS];			// AI of each seat (seat 0 is always the human player)
+		int max_sessions_;				// largest number of connections served at the same time
+		unsigned long long seed_;		// random seed (0: seed from current time), game i of the server uses stream i
+		const EffectTable *effects_;	// card effects (null: special cards of the rules, see effects.h)
+
+		// constructor
+		ServerSettings()
+			: port_(9999), num_players_(NUM_PLAYERS), num_cards_per_player_(NUM_CARDS_PER_PLAYER),
+			max_sessions_(SERVER_MAX_SESSIONS), seed_(RANDOM_SEED), effects_(nullptr)
+		{
+			for (int i = 0; i < MAX_PLAYERS; ++i)
+				ai_[i] = AI_SMART;
+		}
+	};
+
+	// serve games until the process is stopped
+	// returns false (with a message in error) if the server can't start
+	bool RunServer(const ServerSettings &settings, std::string &error);
+}
@@ -0,0 +1,567 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+#include <cmath>		// std::sqrt, std::log
+#include <thread>		// std::thread
+#include <vector>
+
+#include "checkpoint.h"
+#include "effects.h"
+#include "export.h"
+#include "gamelog.h"
+#include "simulation.h"
+#include "trace.h"
+
+using namespace POKER;
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           PlayGames
+
+Description:	Play games [first_game, last_game) on an engine.
+				In counter-based mode, each game uses the random stream of its index.
+
+Arguments:      game: Initialized engine.
+				first_game: Index of the first game.
+				last_game: Index after the last game.
+				result: Stats of the games.
+				log: Records the games (null: not recorded).
+				trace: Ring of the trace (null: the trace of the engine is kept).
+				exporter: Exports the result of each game (null: not exported).
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+static void PlayGames(NintyNineT<RULES> &game, int first_game, int last_game, SimResult &result, GameLogWriter *log,
+	TraceRing *trace, ExportWriter *exporter)
+{
+	TraceRing *engine_trace = game.GetTrace();
+	if (trace != nullptr)
+		game.SetTrace(trace);
+
+	game.SetGameLog(log);
+	if (log != nullptr)
+		log->Start(first_game);
+
+	for (int i = first_game; i < last_game; ++i)
+	{
+		if (USE_COUNTER_RNG)
+			game.SeedStream(i);
+
+		if (log != nullptr)
+			log->BeginGame(i, result.ai_);
+
+		int winner = game.Play(result.stats_);
+		++result.stats_.num_games_;
+		++result.win_player_[winner];
+
+		if (log != nullptr)
+			log->EndGame();
+
+		if (exporter != nullptr)
+			exporter->AddGame(i, winner, game);
+	}
+
+	game.SetGameLog(nullptr);
+	game.SetTrace(engine_trace);
+
+#if NINTYNINE_PROFILE
+	game.MergeProfile(result.profile_);
+#endif
+}
+
+/*--------------------------------------------------------------------------*
+Name:           SimulateGames
+
+Description:	Worker thread. Create an engine with the given AI line-up
+				and play games [first_game, last_game).
+
+Arguments:      ai_list: AI of each player.
+				seed: Random seed of the main engine.
+				settings: Simulation settings.
+				first_game: Index of the first game.
+				last_game: Index after the last game.
+				result: Stats of this thread.
+				log: Records the games of this thread (null: not recorded).
+				trace: Ring of the trace of this thread (null: not traced).
+				exporter: Exports the games of this thread (null: not exported).
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+static void SimulateGames(const int *ai_list, unsigned long long seed, const SimSettings *settings,
+	int first_game, int last_game, ThreadResult *result, GameLogWriter *log, TraceRing *trace, ExportWriter *exporter)
+{
+	NintyNineT<RULES> game(false, seed);
+
+	game.Initialize(ai_list);
+	// the table fits the rules, the main engine took it (see RunSimulation)
+	game.SetDecisionTable(settings->table_);
+	game.SetEffects(settings->effects_);
+
+	// without counter-based mode, each range of games needs its own stream
+	if (!USE_COUNTER_RNG)
+		game.SeedStream(first_game + 1);
+
+	for (int i = 0; i < RULES::NUM_PLAYERS; ++i)
+		result->result_.ai_[i] = ai_list[i];
+
+	PlayGames(game, first_game, last_game, result->result_, log, trace, exporter);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PlayGames
+
+Description:	Play games [first_game, last_game), split evenly across threads.
+				With a single thread, the given engine is used.
+				Games are written to the log of settings in order of game index.
+
+Arguments:      game: Initialized engine (provides AI line-up).
+				settings: Simulation settings.
+				num_threads: Number of threads.
+				first_game: Index of the first game.
+				last_game: Index after the last game.
+				result: Merged result of all threads.
+				traces: Ring of the trace of each thread (null: not traced).
+				exporters: Exporter of each thread (null: not exported).
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+static void PlayGames(NintyNineT<RULES> &game, const SimSettings &settings, int num_threads,
+	int first_game, int last_game, SimResult &result, TraceRing *const traces[], ExportWriter exporters[])
+{
+	int num_games = last_game - first_game;
+	if (num_threads > num_games)
+		num_threads = num_games;
+
+	// each thread records its games in memory
+	std::vector<GameLogWriter> logs;
+	if (settings.log_ != nullptr)
+		logs.resize(num_threads, GameLogWriter(RULES::NUM_PLAYERS, RULES::NUM_CARDS_PER_PLAYER));
+
+	// play on the main thread
+
+	if (num_threads <= 1)
+	{
+		PlayGames(game, first_game, last_game, result, logs.empty() ? nullptr : &logs[0], traces[0],
+			(exporters != nullptr) ? &exporters[0] : nullptr);
+
+		if (!logs.empty())
+			settings.log_->Write(logs[0]);
+
+		return;
+	}
+
+	// split games across threads
+
+	std::vector<ThreadResult> results(num_threads);
+	std::vector<std::thread> threads;
+
+	int games_per_thread = num_games / num_threads;
+	int games_left = num_games % num_threads;
+
+	for (int i = 0; i < num_threads; ++i)
+	{
+		int last = first_game + games_per_thread + ((i < games_left) ? 1 : 0);
+		threads.emplace_back(SimulateGames<RULES>, result.ai_, result.seed_, &settings, first_game, last, &results[i],
+			logs.empty() ? nullptr : &logs[i], traces[i], (exporters != nullptr) ? &exporters[i] : nullptr);
+		first_game = last;
+	}
+
+	// merge results, ranges of games are written in order
+
+	for (int i = 0; i < num_threads; ++i)
+	{
+		threads[i].join();
+		result.Merge(results[i].result_);
+
+		if (!logs.empty())
+			settings.log_->Write(logs[i]);
+	}
+}
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           SimResult
+
+Description:	Constructor.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+SimResult::SimResult()
+	: num_players_(0), seed_(0), confidence_(STOP_CONFIDENCE), stop_rule_(STOP_NONE), best_player_(-1)
+{
+	for (int i = 0; i < MAX_PLAYERS; ++i)
+	{
+		ai_[i] = 0;
+		win_player_[i] = 0;
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Merge
+
+Description:	Merge result recorded by another thread.
+
+Arguments:      other: Result to be merged.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void SimResult::Merge(const SimResult &other)
+{
+	stats_.Merge(other.stats_);
+
+	for (int i = 0; i < MAX_PLAYERS; ++i)
+		win_player_[i] += other.win_player_[i];
+
+#if NINTYNINE_PROFILE
+	profile_.Merge(other.profile_);
+#endif
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetNumThreads
+
+Description:	Get number of threads to be used.
+
+Arguments:      num_threads: Requested number of threads (0 means all hardware threads).
+				num_games: Number of games to be played.
+
+Returns:        Number of threads, at least 1 and at most num_games.
+*---------------------------------------------------------------------------*/
+int POKER::GetNumThreads(int num_threads, int num_games)
+{
+	if (num_threads <= 0)
+		num_threads = (int)std::thread::hardware_concurrency();
+
+	// human player and game display can only be done on the main thread
+	if (AI_CHANCE_PLAYER || DISPLAY_GAME)
+		num_threads = 1;
+
+	if (num_threads > num_games)
+		num_threads = num_games;
+	if (num_threads < 1)
+		num_threads = 1;
+
+	return num_threads;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetZScore
+
+Description:	Z-score of a two-sided confidence level (inverse of the normal
+				distribution, rational approximation of Abramowitz and Stegun 26.2.23,
+				error below 0.00045).
+
+Arguments:      confidence: Confidence level (0 ~ 1, e.g. 0.95).
+
+Returns:        Z-score (1.96 for 0.95).
+*---------------------------------------------------------------------------*/
+double POKER::GetZScore(double confidence)
+{
+	double p = (1.0 - confidence) / 2.0;
+	if (p <= 0.0)
+		p = 1e-12;
+	if (p > 0.5)
+		p = 0.5;
+
+	double t = std::sqrt(-2.0 * std::log(p));
+
+	return t - (2.515517 + 0.802853 * t + 0.010328 * t * t) / (1.0 + 1.432788 * t + 0.189269 * t * t + 0.001308 * t * t * t);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetWilsonInterval
+
+Description:	Wilson score interval of a win rate (stays inside 0 ~ 1 and works
+				for rates close to 0 or 1, unlike the normal approximation).
+
+Arguments:      wins: Number of wins.
+				games: Number of games.
+				z: Z-score of the confidence level.
+				low: Lower bound of the interval.
+				high: Upper bound of the interval.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void POKER::GetWilsonInterval(int wins, int games, double z, double &low, double &high)
+{
+	if (games == 0)
+	{
+		low = 0.0;
+		high = 1.0;
+		return;
+	}
+
+	double n = games;
+	double rate = wins / n;
+	double z2 = z * z;
+	double center = (rate + z2 / (2.0 * n)) / (1.0 + z2 / n);
+	double half = (z / (1.0 + z2 / n)) * std::sqrt(rate * (1.0 - rate) / n + z2 / (4.0 * n * n));
+
+	low = center - half;
+	high = center + half;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           CheckStopRule
+
+Description:	Check stopping rules on the result so far.
+				STOP_PRECISION: every win rate interval is narrower than +/- precision,
+				and intervals of average rounds and turns are narrower than +/- precision
+				of the average.
+				STOP_BETTER: the lower bound of one player's win rate is above the upper
+				bounds of all other players. Checking after every chunk would inflate
+				the chance of a wrong stop, so these intervals are Bonferroni-corrected
+				over all checks of the run and all players: a wrong stop needs one of
+				them to miss its true rate, which happens with probability at most
+				1 - confidence over the whole run.
+
+Arguments:      settings: Simulation settings (rules, confidence, precision).
+				num_checks: Number of times the rules are checked in the run.
+				result: Result so far, records the rule met.
+
+Returns:        The rule met (STOP_NONE if none).
+*---------------------------------------------------------------------------*/
+int POKER::CheckStopRule(const SimSettings &settings, int num_checks, SimResult &result)
+{
+	const GameStats &stats = result.stats_;
+	if ((settings.stop_rule_ == STOP_NONE) || (stats.num_games_ < 2))
+		return STOP_NONE;
+
+	double z = GetZScore(settings.confidence_);
+	double low[MAX_PLAYERS];
+	double high[MAX_PLAYERS];
+
+	for (int i = 0; i < result.num_players_; ++i)
+		GetWilsonInterval(result.win_player_[i], stats.num_games_, z, low[i], high[i]);
+
+	if (settings.stop_rule_ & STOP_PRECISION)
+	{
+		bool is_precise = (stats.rounds_.GetHalfWidth(z) <= settings.precision_ * stats.rounds_.mean_) &&
+			(stats.turns_.GetHalfWidth(z) <= settings.precision_ * stats.turns_.mean_);
+
+		for (int i = 0; i < result.num_players_; ++i)
+		{
+			if ((high[i] - low[i]) / 2.0 > settings.precision_)
+				is_precise = false;
+		}
+
+		if (is_precise)
+		{
+			result.stop_rule_ = STOP_PRECISION;
+			return STOP_PRECISION;
+		}
+	}
+
+	if (settings.stop_rule_ & STOP_BETTER)
+	{
+		double alpha = (1.0 - settings.confidence_) / ((double)((num_checks > 1) ? num_checks : 1) * result.num_players_);
+		double z_better = GetZScore(1.0 - alpha);
+
+		for (int i = 0; i < result.num_players_; ++i)
+			GetWilsonInterval(result.win_player_[i], stats.num_games_, z_better, low[i], high[i]);
+
+		int best = 0;
+		for (int i = 1; i < result.num_players_; ++i)
+		{
+			if (result.win_player_[i] > result.win_player_[best])
+				best = i;
+		}
+
+		bool is_better = true;
+		for (int i = 0; i < result.num_players_; ++i)
+		{
+			if ((i != best) && (high[i] >= low[best]))
+				is_better = false;
+		}
+
+		if (is_better)
+		{
+			result.stop_rule_ = STOP_BETTER;
+			result.best_player_ = best;
+			return STOP_BETTER;
+		}
+	}
+
+	return STOP_NONE;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           RunSimulation
+
+Description:	Simulate games. The games are split evenly across threads,
+				each thread has its own engine using the same AI line-up as
+				the given engine. With a single thread, the given engine is used.
+				With a stopping rule, games are played check_games_ at a time, the
+				rule is checked every check_games_ games (smaller chunks included)
+				and the run ends as soon as it is met.
+				With a game log, at most LOG_CHUNK_GAMES games are played at a time.
+				With a trace, each thread pushes its events into its own ring.
+				With an export, each thread fills its own blocks of rows.
+				With a checkpoint file, at most checkpoint_games_ games are played
+				at a time and a checkpoint is written after each chunk. A resumed
+				run starts from the next game of its checkpoint, on the same chunks.
+
+Arguments:      game: Initialized engine (provides AI line-up).
+				settings: Simulation settings.
+				result: Merged result of all threads.
+
+Returns:        false if the checkpoint to resume is from another engine, AI
+				line-up, seed or effect table, or a checkpoint can't be written.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+bool POKER::RunSimulation(NintyNineT<RULES> &game, const SimSettings &settings, SimResult &result)
+{
+	typedef NintyNineT<RULES> Engine;
+
+	int num_games = settings.num_games_;
+	int num_threads = GetNumThreads(settings.num_threads_, num_games);
+	unsigned long long effects_hash = game.GetEffects()->GetHash();
+
+	// record game settings
+
+	result.num_players_ = Engine::NUM_PLAYERS;
+	result.seed_ = game.GetSeed();
+	result.confidence_ = settings.confidence_;
+	for (int i = 0; i < Engine::NUM_PLAYERS; ++i)
+		result.ai_[i] = game.GetPlayer(i).AI_;
+
+	// continue a run from its checkpoint
+	int start_game = 0;
+
+	if (settings.resume_ != nullptr)
+	{
+		const Checkpoint &checkpoint = *settings.resume_;
+
+		if ((checkpoint.num_players_ != Engine::NUM_PLAYERS) || (checkpoint.num_cards_per_player_ != Engine::NUM_CARDS_PER_PLAYER) ||
+			(checkpoint.limit_ != Engine::RUNNING_TOTAL_LIMIT) || (checkpoint.seed_ != result.seed_) ||
+			(checkpoint.num_threads_ != num_threads) || (checkpoint.is_lazy_shuffle_ != (USE_LAZY_SHUFFLE ? 1 : 0)) ||
+			(checkpoint.effects_hash_ != effects_hash))
+			return false;
+
+		for (int i = 0; i < Engine::NUM_PLAYERS; ++i)
+		{
+			if (checkpoint.ai_[i] != result.ai_[i])
+				return false;
+
+			result.win_player_[i] = checkpoint.win_player_[i];
+		}
+
+		result.stats_ = checkpoint.stats_;
+		start_game = checkpoint.next_game_;
+	}
+
+	// play games, check stopping rules between each chunk of games
+
+	int chunk_games = num_games;
+	if ((settings.stop_rule_ != STOP_NONE) && (settings.check_games_ > 0))
+		chunk_games = settings.check_games_;
+
+	// logged games are kept in memory until their chunk ends
+	if (settings.log_ != nullptr)
+	{
+		settings.log_->WriteHeader(Engine::NUM_PLAYERS, Engine::NUM_CARDS_PER_PLAYER, Engine::RUNNING_TOTAL_LIMIT, effects_hash,
+			result.seed_);
+
+		if (chunk_games > LOG_CHUNK_GAMES)
+			chunk_games = LOG_CHUNK_GAMES;
+	}
+
+	if ((settings.checkpoint_ != nullptr) && (settings.checkpoint_games_ > 0) && (chunk_games > settings.checkpoint_games_))
+		chunk_games = settings.checkpoint_games_;
+
+	// each thread keeps its ring for every chunk
+	std::vector<TraceRing *> traces(num_threads, nullptr);
+	if (settings.trace_ != nullptr)
+	{
+		for (int i = 0; i < num_threads; ++i)
+			traces[i] = settings.trace_->AddRing();
+	}
+
+	// each thread keeps its exporter for every chunk, a block may hold games of several chunks
+	std::vector<ExportWriter> exporters;
+	if (settings.export_ != nullptr)
+	{
+		settings.export_->WriteHeader(Engine::NUM_PLAYERS, Engine::NUM_CARDS_PER_PLAYER, Engine::RUNNING_TOTAL_LIMIT, result.seed_);
+		exporters.resize(num_threads, ExportWriter(settings.export_));
+	}
+
+	// the rules are checked every check_games_ games even when a log or checkpoint cuts the chunks
+	// smaller, so the number of checks only depends on the game budget
+	int check_games = (settings.check_games_ > 0) ? settings.check_games_ : num_games;
+	int num_checks = (check_games > 0) ? (num_games + check_games - 1) / check_games : 1;
+
+	for (int first_game = start_game; first_game < num_games; first_game += chunk_games)
+	{
+		int last_game = first_game + chunk_games;
+		if (last_game > num_games)
+			last_game = num_games;
+
+		PlayGames(game, settings, num_threads, first_game, last_game, result, traces.data(),
+			exporters.empty() ? nullptr : exporters.data());
+
+		bool is_check = ((last_game / check_games) != (first_game / check_games)) || (last_game == num_games);
+		if (is_check && (CheckStopRule(settings, num_checks, result) != STOP_NONE))
+			break;
+
+		if (settings.checkpoint_ != nullptr)
+		{
+			Checkpoint checkpoint;
+			MakeCheckpoint(settings, result, Engine::RUNNING_TOTAL_LIMIT, effects_hash, num_threads, last_game, checkpoint);
+
+			if (!SaveCheckpoint(settings.checkpoint_, checkpoint))
+				return false;
+		}
+	}
+
+	for (size_t i = 0; i < exporters.size(); ++i)
+		exporters[i].Flush();
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           RunSimulation
+
+Description:	Simulate games on the engine compiled for the number of
+				players and number of cards per player in settings.
+				The engine is initialized with AI picked by the settings in nintynine.h.
+
+Arguments:      settings: Simulation settings.
+				result: Merged result of all threads.
+
+Returns:        false if no engine is compiled for this configuration,
+				the decision table is built for other rules, or on a checkpoint error.
+*---------------------------------------------------------------------------*/
+bool POKER::RunSimulation(const SimSettings &settings, SimResult &result)
+{
+#define NINTYNINE_RUN(players, cards)													\
+	if ((settings.num_players_ == players) && (settings.num_cards_per_player_ == cards))	\
+	{																					\
+		NintyNineT<Rules<players, cards> > game(DISPLAY_GAME, settings.seed_);			\
+		game.Initialize();																\
+		if (!game.SetDecisionTable(settings.table_))									\
+			return false;																\
+		game.SetEffects(settings.effects_);												\
+		return RunSimulation(game, settings, result);									\
+	}
+
+	NINTYNINE_CONFIGS(NINTYNINE_RUN)
+#undef NINTYNINE_RUN
+
+	return false;
+}
+
+// pre-instantiated simulations
+
+#define NINTYNINE_INSTANTIATE(players, cards)	\
+	template bool POKER::RunSimulation(NintyNineT<Rules<players, cards> > &, const SimSettings &, SimResult &);
+NINTYNINE_CONFIGS(NINTYNINE_INSTANTIATE)
+#undef NINTYNINE_INSTANTIATE
\ No newline at end of file
@@ -0,0 +1,103 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Multithreaded simulation driver
+// each worker thread owns its own engine (players and deck), plays a share of the games
+// and records stats into its own cache line padded slot, slots are merged at the end
+
+#pragma once
+
+#include "nintynine.h"
+
+// size of a cache line, per-thread data is padded to this size to prevent false sharing
+static const int CACHE_LINE_SIZE = 64;
+
+namespace POKER
+{
+	struct Checkpoint;
+	class DecisionTable;
+	class EffectTable;
+	class ExportFile;
+	class GameLogFile;
+	class TraceSink;
+
+	// settings of a simulation run (default values are set in nintynine.h)
+	struct SimSettings
+	{
+		int num_players_;				// number of players
+		int num_cards_per_player_;		// number of cards each player has
+		int num_games_;					// number of games to be played
+		int num_threads_;				// number of threads (0 means all hardware threads)
+		unsigned long long seed_;		// random seed of the engine (0 means seed from current time)
+		const DecisionTable *table_;	// decision table of dumb and smart AI (null: AI scans its hands)
+		const EffectTable *effects_;	// card effects (null: special cards of the rules, see effects.h)
+		int stop_rule_;					// early stopping rules (STOP_ID, num_games_ is the budget)
+		double confidence_;				// confidence level of intervals
+		double precision_;				// target precision of STOP_PRECISION
+		int check_games_;				// number of games between checks of stop_rule_
+		GameLogFile *log_;				// log recording every game (null: not recorded, needs USE_COUNTER_RNG)
+		TraceSink *trace_;				// trace of sampled games (null: not traced)
+		ExportFile *export_;			// export of the result of every game (null: not exported)
+		const char *checkpoint_;		// checkpoint file written between chunks of games (null: no checkpoint)
+		int checkpoint_games_;			// number of games between checkpoints
+		const Checkpoint *resume_;		// checkpoint the run resumes from (null: start from the first game)
+
+		// constructor
+		SimSettings()
+			: num_players_(NUM_PLAYERS), num_cards_per_player_(NUM_CARDS_PER_PLAYER), num_games_(NUM_GAMES),
+			num_threads_(NUM_THREADS), seed_(RANDOM_SEED), table_(nullptr), effects_(nullptr), stop_rule_(STOP_RULE), confidence_(STOP_CONFIDENCE),
+			precision_(STOP_PRECISION_TARGET), check_games_(STOP_CHECK_GAMES), log_(nullptr), trace_(nullptr), export_(nullptr),
+			checkpoint_(nullptr), checkpoint_games_(CHECKPOINT_GAMES), resume_(nullptr) {}
+	};
+
+	// result of a simulation run
+	struct SimResult
+	{
+		GameStats stats_;				// game stats
+		int num_players_;				// number of players
+		int ai_[MAX_PLAYERS];			// AI of each player
+		int win_player_[MAX_PLAYERS];	// number of wins of each player
+		unsigned long long seed_;		// random seed
+		double confidence_;				// confidence level of intervals
+		int stop_rule_;					// rule that ended the run early (STOP_NONE: all games played)
+		int best_player_;				// player who wins significantly more often (STOP_BETTER), or -1
+#if NINTYNINE_PROFILE
+		Profile profile_;				// hot-path counters of all engines
+#endif
+
+		// constructor
+		SimResult();
+
+		// merge result recorded by another thread
+		void Merge(const SimResult &other);
+	};
+
+	// per-thread result, padded so results of different threads never share a cache line
+	struct ThreadResult
+	{
+		SimResult result_;
+		char padding_[CACHE_LINE_SIZE];
+	};
+
+	// get number of threads to be used (resolve NUM_THREADS = 0 to hardware threads)
+	int GetNumThreads(int num_threads, int num_games);
+
+	// z-score of a two-sided confidence level (1.96 for 0.95)
+	double GetZScore(double confidence);
+	// Wilson score interval of a win rate
+	void GetWilsonInterval(int wins, int games, double z, double &low, double &high);
+	// check stopping rules on the result so far, returns the rule met (STOP_NONE if none)
+	// (num_checks: times the rules are checked in the run, STOP_BETTER is corrected for all of them)
+	int CheckStopRule(const SimSettings &settings, int num_checks, SimResult &result);
+
+	// simulate games, using the AI line-up of the given engine
+	// returns false if the checkpoint to resume is from another engine, line-up or seed, or a checkpoint can't be written
+	template <typename RULES>
+	bool RunSimulation(NintyNineT<RULES> &game, const SimSettings &settings, SimResult &result);
+
+	// simulate games on the engine compiled for the number of players and cards in settings
+	// returns false if there's no such engine (see NINTYNINE_CONFIGS), the decision table is built for other rules,
+	// or on a checkpoint error (see above)
+	bool RunSimulation(const SimSettings &settings, SimResult &result);
+}
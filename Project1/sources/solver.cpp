@@ -0,0 +1,495 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Perfect-information ("double dummy") solver
+
+#include <algorithm>	// std::swap
+#include <chrono>		// std::chrono::steady_clock
+
+#include "solver.h"
+#include "mcts.h"
+#include "strategy.h"
+
+using namespace POKER;
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           SolverT
+
+Description:	Constructor. Allocate the transposition table and create Zobrist keys.
+
+Arguments:      seed: Seed of Zobrist keys.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+SolverT<RULES>::SolverT(unsigned long long seed)
+	: table_((size_t)1 << SOLVER_TABLE_BITS), mask_(((unsigned long long)1 << SOLVER_TABLE_BITS) - 1),
+	rng_(seed), root_player_(0), root_players_left_(0), horizon_(0), num_nodes_(0), node_limit_(0), is_aborted_(false)
+{
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+	{
+		for (int j = 0; j <= NUM_VALUES; ++j)
+		{
+			for (int k = 0; k < NUM_CARDS_PER_PLAYER; ++k)
+				key_hands_[i][j][k] = rng_.Next();
+		}
+
+		key_player_[i] = rng_.Next();
+	}
+
+	for (int i = 0; i <= RUNNING_TOTAL_LIMIT; ++i)
+		key_total_[i] = rng_.Next();
+
+	for (int i = 0; i < SOLVER_DEPTH; ++i)
+		key_depth_[i] = rng_.Next();
+
+	key_order_ = rng_.Next();
+	key_root_ = 0;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Solve
+
+Description:	Solve the position where player_num is to move.
+				Every card of its hands is searched with a full window, so each outcome
+				is exact (cards of the same face value share it). The search depth grows
+				by 2 turns each iteration, until every card is resolved, SOLVER_DEPTH
+				is reached, or SOLVER_NODES positions are searched (the outcomes of
+				the last finished iteration are kept).
+
+Arguments:      game: Engine holding the position (not modified).
+				player_num: Player to move (must not be defeated).
+				results: Outcome of dealing each card of the hands (NUM_CARDS_PER_PLAYER).
+
+Returns:        Best outcome of the player (SOLVER_RESULT).
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int SolverT<RULES>::Solve(const Engine &game, int player_num, int results[])
+{
+	Engine root = game;
+	GameState state;
+	root.Snapshot(state, player_num);
+
+	key_root_ = rng_.Next();
+	root_player_ = player_num;
+	root_players_left_ = root.GetPlayersLeft();
+	node_limit_ = num_nodes_ + SOLVER_NODES;
+
+	for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
+		results[i] = SR_UNKNOWN;
+
+	for (horizon_ = 2; horizon_ <= SOLVER_DEPTH; horizon_ += 2)
+	{
+		int iteration[NUM_CARDS_PER_PLAYER];
+		bool is_resolved = true;
+
+		is_aborted_ = false;
+
+		for (int i = 0; (i < NUM_CARDS_PER_PLAYER) && !is_aborted_; ++i)
+		{
+			int value = root.GetPlayer(player_num).hands_[i].GetValue();
+
+			// same face value as an earlier card, same outcome
+			int j = 0;
+			while (root.GetPlayer(player_num).hands_[j].GetValue() != value)
+				++j;
+
+			if (j < i)
+			{
+				iteration[i] = iteration[j];
+				continue;
+			}
+
+			root.PlayCard(player_num, i);
+			++num_nodes_;
+
+			iteration[i] = GetOutcome(root);
+			if (iteration[i] == SR_UNKNOWN)
+				iteration[i] = Search(root, root.NextPlayer(player_num), 1, SR_LOSE, SR_WIN);
+
+			root.Restore(state);
+
+			if (iteration[i] == SR_UNKNOWN)
+				is_resolved = false;
+		}
+
+		if (is_aborted_)
+			break;
+
+		for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
+			results[i] = iteration[i];
+
+		if (is_resolved)
+			break;
+	}
+
+	int best = SR_LOSE;
+	for (int i = 0; i < NUM_CARDS_PER_PLAYER; ++i)
+	{
+		if (results[i] > best)
+			best = results[i];
+	}
+
+	return best;
+}
+
+// private functions
+
+/*--------------------------------------------------------------------------*
+Name:           Search
+
+Description:	Alpha-beta search. Root player picks the best outcome for itself,
+				other players pick the worst outcome for root player.
+				Only one card of each face value is searched. Cards that end the search
+				right away are checked first, then the best card stored in the
+				transposition table. Proven outcomes (win or lose) of the table are
+				used by every iteration, other outcomes only by the iteration that stored them.
+
+Arguments:      game: Engine holding the position (restored before returning).
+				player_num: Player to move (defeated players are skipped).
+				depth: Number of turns from the root.
+				alpha: Lower bound of the outcome.
+				beta: Upper bound of the outcome.
+
+Returns:        Outcome of root player (SOLVER_RESULT).
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int SolverT<RULES>::Search(Engine &game, int player_num, int depth, int alpha, int beta)
+{
+	if (depth >= horizon_)
+		return SR_UNKNOWN;
+
+	if (num_nodes_ >= node_limit_)
+	{
+		is_aborted_ = true;
+		return SR_UNKNOWN;
+	}
+
+	// defeated players skip their turn
+	while (game.GetPlayer(player_num).is_defeat_)
+		player_num = game.NextPlayer(player_num);
+
+	// look up transposition table
+
+	unsigned long long key = Hash(game, player_num, depth);
+	Entry &entry = table_[key & mask_];
+	int first_value = 0;
+
+	if (entry.key_ == key)
+	{
+		bool is_proven = ((entry.value_ == SR_WIN) && (entry.bound_ != BOUND_UPPER)) ||
+			((entry.value_ == SR_LOSE) && (entry.bound_ != BOUND_LOWER));
+
+		if (is_proven)
+			return entry.value_;
+
+		if ((entry.horizon_ == horizon_) &&
+			((entry.bound_ == BOUND_EXACT) ||
+			((entry.bound_ == BOUND_LOWER) && (entry.value_ >= beta)) ||
+			((entry.bound_ == BOUND_UPPER) && (entry.value_ <= alpha))))
+			return entry.value_;
+
+		first_value = entry.move_;
+	}
+
+	// every card is dealt on the engine of the position, then the position is restored
+	GameState state;
+	game.Snapshot(state, player_num);
+
+	bool is_root_player = (player_num == root_player_);
+	int alpha_start = alpha;
+	int beta_start = beta;
+	int best = is_root_player ? SR_LOSE : SR_WIN;
+	int best_value = 0;
+
+	// deal one card of each face value, check the ones that end the search
+
+	int moves[NUM_CARDS_PER_PLAYER];		// cards to be searched
+	int num_moves = 0;
+	int searched = 0;		// bit i is set if face value i is dealt
+
+	for (int i = 0; (i < NUM_CARDS_PER_PLAYER) && (alpha < beta); ++i)
+	{
+		int value = game.GetPlayer(player_num).hands_[i].GetValue();
+		if (searched & (1 << value))
+			continue;
+		searched |= 1 << value;
+
+		game.PlayCard(player_num, i);
+		++num_nodes_;
+
+		int result = GetOutcome(game);
+		game.Restore(state);
+
+		if (result == SR_UNKNOWN)
+		{
+			// search it later, the best card of the table goes first
+			moves[num_moves] = i;
+			if ((value == first_value) && (num_moves > 0))
+				std::swap(moves[0], moves[num_moves]);
+			++num_moves;
+			continue;
+		}
+
+		if (is_root_player ? (result > best) : (result < best))
+		{
+			best = result;
+			best_value = value;
+		}
+
+		if (is_root_player && (best > alpha))
+			alpha = best;
+		if (!is_root_player && (best < beta))
+			beta = best;
+	}
+
+	// search the other cards
+
+	for (int i = 0; (i < num_moves) && (alpha < beta); ++i)
+	{
+		game.PlayCard(player_num, moves[i]);
+
+		int result = Search(game, game.NextPlayer(player_num), depth + 1, alpha, beta);
+		game.Restore(state);
+
+		if (is_root_player ? (result > best) : (result < best))
+		{
+			best = result;
+			best_value = game.GetPlayer(player_num).hands_[moves[i]].GetValue();
+		}
+
+		if (is_root_player && (best > alpha))
+			alpha = best;
+		if (!is_root_player && (best < beta))
+			beta = best;
+	}
+
+	// store into transposition table (always replace), unless the search was cut short
+
+	if (is_aborted_)
+		return SR_UNKNOWN;
+
+	entry.key_ = key;
+	entry.value_ = (signed char)best;
+	entry.move_ = (unsigned char)best_value;
+	entry.horizon_ = (unsigned char)horizon_;
+	if (best <= alpha_start)
+		entry.bound_ = BOUND_UPPER;
+	else if (best >= beta_start)
+		entry.bound_ = BOUND_LOWER;
+	else
+		entry.bound_ = BOUND_EXACT;
+
+	return best;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetOutcome
+
+Description:	Outcome of root player after a card is dealt.
+
+Arguments:      game: Engine after the card is dealt.
+
+Returns:        SR_LOSE if root player is defeated, SR_WIN if another player is defeated,
+				SR_UNKNOWN if nobody is defeated.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+int SolverT<RULES>::GetOutcome(Engine &game)
+{
+	if (game.GetPlayer(root_player_).is_defeat_)
+		return SR_LOSE;
+
+	if (game.GetPlayersLeft() < root_players_left_)
+		return SR_WIN;
+
+	return SR_UNKNOWN;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Hash
+
+Description:	Zobrist key of a position.
+				Hands are hashed as sets of face values (order of cards doesn't matter).
+				Defeated players and the cards to be drawn are fixed under a root,
+				they are covered by the root key and the depth.
+
+Arguments:      game: Engine holding the position.
+				player_num: Player to move.
+				depth: Number of turns from the root.
+
+Returns:        Key of the position.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+unsigned long long SolverT<RULES>::Hash(Engine &game, int player_num, int depth)
+{
+	unsigned long long key = key_root_ ^ key_depth_[depth] ^ key_player_[player_num] ^ key_total_[game.GetRunningTotal()];
+
+	if (game.IsOrderIncrease())
+		key ^= key_order_;
+
+	for (int i = 0; i < NUM_PLAYERS; ++i)
+	{
+		const Cards *hands = game.GetPlayer(i).hands_.cards_;
+		int count[NUM_VALUES + 1] = { 0 };
+
+		for (int j = 0; j < NUM_CARDS_PER_PLAYER; ++j)
+		{
+			int value = hands[j].GetValue();
+			key ^= key_hands_[i][value][count[value]++];
+		}
+	}
+
+	return key;
+}
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           SolvePositions
+
+Description:	Sample one position from each game and solve it.
+				Game i uses the random stream of its index, and is played by AI
+				for 1 ~ SOLVER_SAMPLE_TURNS turns (games that end earlier are skipped).
+				The card AI would deal is compared with the outcome of each card.
+
+Arguments:      settings: Simulation settings (number of games, decision table).
+				report: Solver report.
+
+Returns:        false if the decision table is built for other rules,
+				or the line-up has a human player.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+static bool SolvePositions(const SimSettings &settings, SolverReport &report)
+{
+	typedef NintyNineT<RULES> Engine;
+	typedef PlayerT<RULES> Player;
+
+	Engine game(false, settings.seed_);
+	game.Initialize();
+	if (!game.SetDecisionTable(settings.table_))
+		return false;
+	game.SetEffects(settings.effects_);
+
+	for (int i = 0; i < RULES::NUM_PLAYERS; ++i)
+	{
+		if (game.GetPlayer(i).AI_ == AI_PLAYER)
+			return false;
+	}
+
+	SolverT<RULES> solver(game.GetSeed());
+	Random sampler;
+	std::shared_ptr<MctsT<RULES> > searches[RULES::NUM_PLAYERS];
+
+	report.num_players_ = RULES::NUM_PLAYERS;
+	report.seed_ = game.GetSeed();
+
+	std::chrono::steady_clock::duration solve_time(0);
+
+	for (int i = 0; i < settings.num_games_; ++i)
+	{
+		// play to the sampled turn
+
+		game.SeedStream(i);
+		sampler.Seed(game.GetSeed(), i);
+
+		int num_turns = 1 + sampler.Range(SOLVER_SAMPLE_TURNS);
+		int player_num = 0;
+		bool is_end = false;
+
+		game.StartGame();
+		for (int j = 0; (j < num_turns) && !is_end; ++j)
+		{
+			is_end = game.PlayerTurn(player_num);
+			player_num = game.NextPlayer(player_num);
+		}
+
+		if (is_end)
+			continue;
+
+		while (game.GetPlayer(player_num).is_defeat_)
+			player_num = game.NextPlayer(player_num);
+
+		// card picked by AI (random AI and loaded strategies use a copy of the sampler, MCTS AI its own search,
+		// the game is not changed)
+
+		Player player = game.GetPlayer(player_num);
+		Random rng = sampler;
+		int choice;
+		if (player.AI_ == AI_MCTS)
+		{
+			if (!searches[player_num])
+				searches[player_num] = std::make_shared<MctsT<RULES> >(player_num);
+
+			choice = searches[player_num]->Play(game);
+		}
+		else if (GetStrategy(player.AI_) != nullptr)
+			choice = game.PlayStrategy(player_num, rng.Next());
+		else
+			choice = player.PlayerSmart(game.GetRunningTotal());
+
+		// solve
+
+		int results[RULES::NUM_CARDS_PER_PLAYER];
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		int best = solver.Solve(game, player_num, results);
+		solve_time += std::chrono::steady_clock::now() - start;
+
+		SolverStats &stats = report.ai_[player.AI_];
+
+		++stats.num_positions_;
+		if (best == SR_WIN)
+		{
+			++stats.num_win_;
+			if (results[choice] == SR_WIN)
+				++stats.num_match_win_;
+		}
+		else if (best == SR_LOSE)
+			++stats.num_lose_;
+		else
+			++stats.num_unknown_;
+
+		if (results[choice] == best)
+			++stats.num_match_best_;
+	}
+
+	report.num_nodes_ = solver.GetNumNodes();
+	report.seconds_ = std::chrono::duration<double>(solve_time).count();
+
+	return true;
+}
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           RunSolver
+
+Description:	Sample and solve positions on the engine compiled for the number of
+				players and number of cards per player in settings.
+				The engine is initialized with AI picked by the settings in nintynine.h.
+
+Arguments:      settings: Simulation settings (num_games_ is the number of sampled games).
+				report: Solver report.
+
+Returns:        false if no engine is compiled for this configuration, the decision
+				table is built for other rules, or the line-up has a human player.
+*---------------------------------------------------------------------------*/
+bool POKER::RunSolver(const SimSettings &settings, SolverReport &report)
+{
+#define NINTYNINE_SOLVE(players, cards)													\
+	if ((settings.num_players_ == players) && (settings.num_cards_per_player_ == cards))	\
+		return SolvePositions<Rules<players, cards> >(settings, report);
+	NINTYNINE_CONFIGS(NINTYNINE_SOLVE)
+#undef NINTYNINE_SOLVE
+
+	return false;
+}
+
+// pre-instantiated solvers
+
+#define NINTYNINE_INSTANTIATE(players, cards) template class POKER::SolverT<Rules<players, cards> >;
+NINTYNINE_CONFIGS(NINTYNINE_INSTANTIATE)
+#undef NINTYNINE_INSTANTIATE
\ No newline at end of file
@@ -0,0 +1,139 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Perfect-information ("double dummy") solver
+// knows all hands and the order of every card still to be drawn (the remaining deck, then the decks
+// shuffled by the engine's random number generator), and searches every card each player can deal
+// the question solved for the player to move: can it make another player lose first,
+// assuming all other players play against it (paranoid search)? with 2 players, this is winning the game
+// iterative deepening alpha-beta search over PlayCard transitions,
+// results are kept in a Zobrist-hashed transposition table
+// positions not resolved within SOLVER_DEPTH turns or SOLVER_NODES searched positions are unknown
+
+#pragma once
+
+#include <vector>
+
+#include "nintynine.h"
+#include "simulation.h"
+
+namespace POKER
+{
+	// max number of turns searched from a position
+	static const int SOLVER_DEPTH			= 64;
+	// max number of positions searched to solve a sampled position (keeps the solver at a steady rate)
+	static const int SOLVER_NODES			= 100000;
+	// transposition table has 2^SOLVER_TABLE_BITS entries (16 bytes each), allocated once
+	static const int SOLVER_TABLE_BITS		= 20;
+	// a sampled position is taken after 1 ~ SOLVER_SAMPLE_TURNS turns played by AI
+	static const int SOLVER_SAMPLE_TURNS	= 40;
+
+	// outcome of a position for the player to move
+	enum SOLVER_RESULT
+	{
+		SR_LOSE		= -1,	// loses first whatever it plays
+		SR_UNKNOWN	= 0,	// not resolved (search limit reached)
+		SR_WIN		= 1,	// can make another player lose first
+	};
+
+	// choices of an AI compared with the solver
+	struct SolverStats
+	{
+		int num_positions_;		// number of positions solved
+		int num_win_;			// positions with a winning card
+		int num_match_win_;		// positions with a winning card where AI deals one
+		int num_lose_;			// positions lost whatever card is dealt
+		int num_unknown_;		// positions not resolved
+		int num_match_best_;	// positions where AI deals a card with the best outcome
+
+		SolverStats() : num_positions_(0), num_win_(0), num_match_win_(0), num_lose_(0), num_unknown_(0),
+			num_match_best_(0) {}
+	};
+
+	// result of a solver run
+	struct SolverReport
+	{
+		SolverStats ai_[NUM_AI];			// stats of each AI (indexed by AI_ID)
+		int num_players_;				// number of players
+		long long num_nodes_;			// number of positions searched
+		double seconds_;				// time spent by the solver
+		unsigned long long seed_;		// random seed of the sampled games
+
+		SolverReport() : num_players_(0), num_nodes_(0), seconds_(0.0), seed_(0) {}
+	};
+
+	template <typename RULES>
+	class SolverT
+	{
+	public:
+		NINTYNINE_RULE_PARAMETERS(RULES)
+
+		typedef NintyNineT<RULES> Engine;
+		typedef GameStateT<RULES> GameState;
+
+		// constructor (seed of Zobrist keys)
+		SolverT(unsigned long long seed);
+
+		// solve the position where player_num is to move
+		// results[i] is the outcome of dealing card i of its hands, returns the best outcome
+		int Solve(const Engine &game, int player_num, int results[]);
+
+		// number of positions searched so far
+		long long GetNumNodes(void) const { return num_nodes_; }
+
+	private:
+		// bound of a stored value
+		enum BOUND
+		{
+			BOUND_EXACT,
+			BOUND_LOWER,
+			BOUND_UPPER,
+		};
+
+		// transposition table entry
+		struct Entry
+		{
+			unsigned long long key_;		// Zobrist key of the position
+			signed char value_;				// outcome (SOLVER_RESULT)
+			unsigned char bound_;			// BOUND of value_
+			unsigned char move_;			// face value of the best card (searched first next time)
+			unsigned char horizon_;			// search depth of the iteration that stored it
+		};
+
+		std::vector<Entry> table_;			// transposition table
+		unsigned long long mask_;			// table size - 1
+
+		// Zobrist keys
+		// cards: [player][face value][number of cards of this value before it in the hands]
+		unsigned long long key_hands_[NUM_PLAYERS][NUM_VALUES + 1][NUM_CARDS_PER_PLAYER];
+		unsigned long long key_total_[RUNNING_TOTAL_LIMIT + 1];
+		unsigned long long key_player_[NUM_PLAYERS];
+		unsigned long long key_order_;
+		// turn from the root (also tells how many cards are drawn, the order of cards is fixed)
+		unsigned long long key_depth_[SOLVER_DEPTH];
+		// changed for each root, so entries of other roots (other decks and defeated players) never match
+		unsigned long long key_root_;
+
+		Random rng_;						// generates keys
+		int root_player_;					// player to move at the root
+		int root_players_left_;				// number of players left at the root
+		int horizon_;						// search depth of the current iteration
+		long long num_nodes_;				// number of positions searched
+		long long node_limit_;				// search stops when num_nodes_ reaches this
+		bool is_aborted_;					// node limit reached in the current iteration
+
+		// search a position, value is from the view of root player
+		int Search(Engine &game, int player_num, int depth, int alpha, int beta);
+		// outcome after player_num dealt a card (SR_UNKNOWN: nobody lost yet)
+		int GetOutcome(Engine &game);
+		// Zobrist key of a position
+		unsigned long long Hash(Engine &game, int player_num, int depth);
+	};
+
+	// sample positions from settings.num_games_ games (line-up picked by the settings in nintynine.h)
+	// and solve them on one thread, count how often each AI deals a winning card
+	// returns false if there's no such engine (see NINTYNINE_CONFIGS), the decision table is built for other rules
+	// or the line-up has a human player
+	bool RunSolver(const SimSettings &settings, SolverReport &report);
+}
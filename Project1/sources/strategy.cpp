@@ -0,0 +1,291 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Strategy registry and strategies loaded from shared libraries
+
+#include "nintynine.h"
+#include "strategy.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+using namespace POKER;
+
+static_assert(NUM_AI <= 16, "AI ids must fit 4 bits of a game log");
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           PickRandom
+
+Description:	(AI 1) "random" strategy. Same draw as Random::Range
+				on the random number of the turn.
+
+Arguments:      turn: Turn of the player.
+
+Returns:        Index of the card picked.
+*---------------------------------------------------------------------------*/
+static int PickRandom(const StrategyTurn *turn)
+{
+	return (int)(((turn->random_ >> 32) * (unsigned long long)turn->num_cards_) >> 32);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PickDumb
+
+Description:	(AI 2) "dumb" strategy. Same pick as PlayerT::PlayerDumb.
+
+Arguments:      turn: Turn of the player.
+
+Returns:        Index of the card picked.
+*---------------------------------------------------------------------------*/
+static int PickDumb(const StrategyTurn *turn)
+{
+	int best_total = -1;
+	int card_index = 0;
+
+	for (int i = 0; i < turn->num_cards_; ++i)
+	{
+		// special cards are taken for their face value
+		int new_total = (turn->weights_[i] != SP_NULL_WEIGHT) ? turn->total_ + turn->values_[i] : turn->totals_[i];
+
+		if ((new_total > best_total) && (new_total <= turn->limit_))
+		{
+			card_index = i;
+			best_total = new_total;
+		}
+	}
+
+	return card_index;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PickSmart
+
+Description:	(AI 3) "smart" strategy. Same pick as PlayerT::PlayerSmart.
+				MCTS plays as this outside of an engine.
+
+Arguments:      turn: Turn of the player.
+
+Returns:        Index of the card picked.
+*---------------------------------------------------------------------------*/
+static int PickSmart(const StrategyTurn *turn)
+{
+	int best_total = -1;
+	int card_index = 0;
+	bool can_use_normal_card = false;
+
+	int special_index = 0;
+
+	for (int i = 0; i < turn->num_cards_; ++i)
+	{
+		int weight = turn->weights_[i];
+
+		// find special card (weight 1 than weight 2)
+		if ((special_index == 0) && (weight != SP_NULL_WEIGHT))
+		{
+			if ((weight == 2) && (turn->weights_[special_index] == 0))
+				special_index = i;
+			else if ((weight == 1) && (turn->weights_[special_index] != 1))
+				special_index = i;
+		}
+
+		if ((weight == SP_NULL_WEIGHT) && (turn->totals_[i] > best_total) && (turn->totals_[i] <= turn->limit_))
+		{
+			card_index = i;
+			best_total = turn->totals_[i];
+			can_use_normal_card = true;
+		}
+	}
+
+	return can_use_normal_card ? card_index : special_index;
+}
+
+// built-in strategies
+static const StrategyPlugin random_strategy = { NINTYNINE_STRATEGY_VERSION, "Monkey", PickRandom };
+static const StrategyPlugin dumb_strategy = { NINTYNINE_STRATEGY_VERSION, "Idiot", PickDumb };
+static const StrategyPlugin smart_strategy = { NINTYNINE_STRATEGY_VERSION, "Smart", PickSmart };
+static const StrategyPlugin mcts_strategy = { NINTYNINE_STRATEGY_VERSION, "MCTS", PickSmart };
+
+// registered strategies by AI id: built-in AI, then loaded strategies
+// (filled at startup before any game is played, then only read)
+static const StrategyPlugin *strategies[NUM_AI] = { nullptr, &random_strategy, &dumb_strategy, &smart_strategy, &mcts_strategy };
+static int num_strategies = 0;
+
+static_assert((AI_RANDOM == 1) && (AI_DUMB == 2) && (AI_SMART == 3) && (AI_MCTS == 4) && (AI_EXTERNAL == 5),
+	"built-in strategies are listed by AI id");
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           RegisterStrategy
+
+Description:	Register a strategy, it plays as the next free AI id.
+
+Arguments:      plugin: Strategy (kept until the program ends).
+
+Returns:        AI id of the strategy, -1 if the registry is full or
+				the strategy is built for another version.
+*---------------------------------------------------------------------------*/
+int POKER::RegisterStrategy(const StrategyPlugin *plugin)
+{
+	if ((num_strategies >= MAX_STRATEGIES) || (plugin == nullptr) || (plugin->version_ != NINTYNINE_STRATEGY_VERSION) ||
+		(plugin->name_ == nullptr) || (plugin->pick_ == nullptr))
+		return -1;
+
+	strategies[AI_EXTERNAL + num_strategies] = plugin;
+
+	return AI_EXTERNAL + num_strategies++;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           LoadStrategy
+
+Description:	Load a strategy library and register its strategy.
+				The library stays loaded until the program ends,
+				or is unloaded right away if its strategy can't be used.
+
+Arguments:      path: Path of the library.
+				ai: AI id of the strategy.
+				error: Why the strategy can't be loaded.
+
+Returns:        false if the library can't be loaded, has no entry function,
+				is built for another version, or the registry is full.
+*---------------------------------------------------------------------------*/
+bool POKER::LoadStrategy(const char *path, int &ai, std::string &error)
+{
+	error.clear();
+
+	if (num_strategies >= MAX_STRATEGIES)
+	{
+		error = "too many strategies are loaded";
+		return false;
+	}
+
+#ifdef _WIN32
+	HMODULE library = LoadLibraryA(path);
+	if (library == nullptr)
+	{
+		error = "can not load the library";
+		return false;
+	}
+
+	StrategyEntry entry = (StrategyEntry)GetProcAddress(library, NINTYNINE_STRATEGY_ENTRY);
+#define NINTYNINE_STRATEGY_CLOSE(library) FreeLibrary(library)
+#else
+	void *library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if (library == nullptr)
+	{
+		const char *message = dlerror();
+		error = (message != nullptr) ? message : "can not load the library";
+		return false;
+	}
+
+	StrategyEntry entry = (StrategyEntry)dlsym(library, NINTYNINE_STRATEGY_ENTRY);
+#define NINTYNINE_STRATEGY_CLOSE(library) dlclose(library)
+#endif
+
+	if (entry == nullptr)
+	{
+		error = "the library has no " NINTYNINE_STRATEGY_ENTRY " function";
+		NINTYNINE_STRATEGY_CLOSE(library);
+		return false;
+	}
+
+	const StrategyPlugin *plugin = entry();
+
+	if (plugin == nullptr)
+		error = NINTYNINE_STRATEGY_ENTRY " returns no strategy";
+	else if (plugin->version_ != NINTYNINE_STRATEGY_VERSION)
+		error = "the strategy is built for version " + std::to_string(plugin->version_) +
+			" of the interface, not version " + std::to_string(NINTYNINE_STRATEGY_VERSION);
+	else if (plugin->name_ == nullptr)
+		error = "the strategy has no name";
+	else if (plugin->pick_ == nullptr)
+		error = "the strategy has no pick function";
+
+	ai = error.empty() ? RegisterStrategy(plugin) : -1;
+
+	if (ai < 0)
+	{
+		if (error.empty())
+			error = "too many strategies are loaded";
+
+		NINTYNINE_STRATEGY_CLOSE(library);
+		return false;
+	}
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetStrategy
+
+Description:	Get the strategy of an AI id.
+
+Arguments:      ai: AI id.
+
+Returns:        Strategy, null for the human player or if no strategy is
+				registered for the id.
+*---------------------------------------------------------------------------*/
+const StrategyPlugin *POKER::GetStrategy(int ai)
+{
+	if ((ai < 0) || (ai >= AI_EXTERNAL + num_strategies))
+		return nullptr;
+
+	return strategies[ai];
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetNumStrategies
+
+Description:	Get number of strategies registered after the built-in AI.
+
+Arguments:      None.
+
+Returns:        Number of registered strategies (loaded or linked).
+*---------------------------------------------------------------------------*/
+int POKER::GetNumStrategies(void)
+{
+	return num_strategies;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           ParseAI
+
+Description:	Get the AI id of a command line letter.
+
+Arguments:      letter: r (random), d (dumb), s (smart), m (MCTS),
+				or 1 ~ MAX_STRATEGIES (registered strategies in order).
+
+Returns:        AI id, -1 if the letter is unknown or no strategy is
+				registered for the number.
+*---------------------------------------------------------------------------*/
+int POKER::ParseAI(char letter)
+{
+	switch (letter)
+	{
+	case 'r':
+		return AI_RANDOM;
+
+	case 'd':
+		return AI_DUMB;
+
+	case 's':
+		return AI_SMART;
+
+	case 'm':
+		return AI_MCTS;
+
+	default:
+		if ((letter >= '1') && (letter < '1' + num_strategies))
+			return AI_EXTERNAL + (letter - '1');
+
+		return -1;
+	}
+}
\ No newline at end of file
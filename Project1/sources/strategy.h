@@ -0,0 +1,74 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Strategy registry and strategies loaded from shared libraries
+// every AI but the human player is a registered strategy: built-in AI (random, dumb, smart, MCTS)
+// are registered under their AI ids, strategies of other teams are built as shared libraries and
+// loaded at startup (--strategy FILE), the n-th loaded strategy plays as AI id AI_EXTERNAL + n
+// in any engine but the batch engine
+// an engine looks up the strategy of each seat once per line-up, built-in AI are picked by a switch on
+// the AI with the engine's own copy of their pick (it reads the hands and decision table in place),
+// only loaded strategies get a StrategyTurn filled in and are called through pick_
+//
+// a strategy library includes only this header and exports the entry function:
+//   static int Pick(const POKER::StrategyTurn *turn) { return 0; }
+//   static const POKER::StrategyPlugin plugin = { NINTYNINE_STRATEGY_VERSION, "Mine", Pick };
+//   extern "C" const POKER::StrategyPlugin *NintyNineStrategy(void) { return &plugin; }
+// (add __declspec(dllexport) on Windows)
+
+#pragma once
+
+#include <string>
+
+// version of the strategy interface, libraries built for another version are not loaded
+#define NINTYNINE_STRATEGY_VERSION	1
+// name of the entry function exported by a strategy library
+#define NINTYNINE_STRATEGY_ENTRY	"NintyNineStrategy"
+
+namespace POKER
+{
+	// what a strategy sees on its turn
+	struct StrategyTurn
+	{
+		int player_num_;				// seat of the player to move
+		int num_players_;				// number of seats
+		int players_left_;				// number of players not defeated
+		int is_order_increase_;			// player order (1: to the next seat, 0: to the previous seat)
+		int total_;						// running total
+		int limit_;						// running total limit, the player loses if its card goes over it
+		int num_cards_;					// number of cards in hand
+		const int *values_;				// face values of the cards in hand
+		unsigned long long random_;		// random number of the turn, drawn from the random stream of the game
+		const int *weights_;			// weights of the cards in hand (0: normal card, see EffectTable::GetWeight)
+		const int *totals_;				// running total after each card in hand (from the card effects of the game)
+	};
+
+	// a strategy exported by a shared library
+	// pick_ returns the index of the card to deal (0 is dealt if it is out of range),
+	// it is called from worker threads at the same time, so it must not change shared state
+	// games are reproducible (and game logs replay) if the pick only depends on the turn it is given
+	struct StrategyPlugin
+	{
+		int version_;									// NINTYNINE_STRATEGY_VERSION
+		const char *name_;								// short name shown in reports
+		int (*pick_)(const StrategyTurn *turn);			// pick a card
+	};
+
+	// entry function of a strategy library
+	typedef const StrategyPlugin *(*StrategyEntry)(void);
+
+	// register a strategy (loaded or linked into the program), call before games are played
+	// returns its AI id, or -1 if MAX_STRATEGIES (nintynine.h) are registered or it is built for another version
+	int RegisterStrategy(const StrategyPlugin *plugin);
+	// load a strategy library and register its strategy, ai is its AI id
+	// returns false and a message in error if it can't be loaded (the library is unloaded again)
+	bool LoadStrategy(const char *path, int &ai, std::string &error);
+	// strategy of an AI id, built-in or loaded (null for the human player and ids with no strategy)
+	const StrategyPlugin *GetStrategy(int ai);
+	// number of strategies registered after the built-in AI
+	int GetNumStrategies(void);
+	// AI id of a command line letter: r (random), d (dumb), s (smart), m (MCTS),
+	// 1 ~ MAX_STRATEGIES (registered strategies in order), -1 if unknown
+	int ParseAI(char letter);
+}
@@ -0,0 +1,759 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Rule/parameter sweep
+
+#include <algorithm>	// std::swap, std::copy
+#include <cstdlib>		// std::atoi
+#include <ctime>		// std::time
+#include <fstream>
+#include <iomanip>		// std::setprecision
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include "sweep.h"
+#include "workpool.h"
+
+using namespace POKER;
+
+// grid keys of abilities (order of ABILITY)
+static const char *SPECIAL_KEYS[AB_NUMBER] = { "sp_10", "sp_20", "sp_99", "sp_reverse", "sp_skip", "sp_pick" };
+static const char *WEIGHT_KEYS[AB_NUMBER] = { "w_10", "w_20", "w_99", "w_reverse", "w_skip", "w_pick" };
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           SetRule
+
+Description:	Set a rule parameter of a point from a grid value.
+
+Arguments:      rules: Rules of the point.
+				key: Grid key.
+				value: Grid value.
+
+Returns:        false if the key is unknown or the value is not a number (or AI letters).
+*---------------------------------------------------------------------------*/
+static bool SetRule(RuleSet &rules, const std::string &key, const std::string &value)
+{
+	if (key == "ai")
+	{
+		for (size_t i = 0; i < value.size(); ++i)
+		{
+			if ((value[i] != 'r') && (value[i] != 'd') && (value[i] != 's'))
+				return false;
+		}
+
+		for (int i = 0; i < MAX_PLAYERS; ++i)
+		{
+			char ai = value[i % value.size()];
+			rules.ai_[i] = (ai == 'r') ? AI_RANDOM : ((ai == 'd') ? AI_DUMB : AI_SMART);
+		}
+
+		return true;
+	}
+
+	if (value.find_first_not_of("0123456789") != std::string::npos)
+		return false;
+
+	int number = std::atoi(value.c_str());
+
+	if (key == "players")
+		rules.num_players_ = number;
+	else if (key == "cards")
+		rules.num_cards_per_player_ = number;
+	else if (key == "limit")
+		rules.limit_ = number;
+	else if (key == "games")
+		rules.num_games_ = number;
+	else
+	{
+		for (int i = 0; i < AB_NUMBER; ++i)
+		{
+			if (key == SPECIAL_KEYS[i])
+			{
+				rules.special_[i] = number;
+				return true;
+			}
+
+			if (key == WEIGHT_KEYS[i])
+			{
+				rules.weight_[i] = number;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           WriteRow
+
+Description:	Write the CSV row of a point.
+
+Arguments:      out: Output stream.
+				index: Index of the point.
+				rules: Rules of the point.
+				result: Result of the point.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void WriteRow(std::ostream &out, int index, const RuleSet &rules, const SimResult &result)
+{
+	const GameStats &stats = result.stats_;
+
+	out << index << ',' << rules.num_players_ << ',' << rules.num_cards_per_player_ << ',' << rules.limit_;
+	for (int i = 0; i < AB_NUMBER; ++i)
+		out << ',' << rules.special_[i];
+	for (int i = 0; i < AB_NUMBER; ++i)
+		out << ',' << rules.weight_[i];
+
+	out << ',';
+	for (int i = 0; i < rules.num_players_; ++i)
+		out << ((rules.ai_[i] == AI_RANDOM) ? 'r' : ((rules.ai_[i] == AI_DUMB) ? 'd' : 's'));
+
+	out << ',' << stats.num_games_ << ',' << stats.rounds_.mean_ << ',' << stats.turns_.mean_ << ','
+		<< stats.exceed_limit_rounds_ << ',' << stats.exceed_limit_turns_;
+
+	for (int i = 0; i < MAX_PLAYERS; ++i)
+	{
+		out << ',';
+		if (i < rules.num_players_)
+			out << (double)result.win_player_[i] / stats.num_games_;
+	}
+
+	out << '\n';
+}
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           RuleSet
+
+Description:	Constructor. Rules are the defaults set in nintynine.h.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+RuleSet::RuleSet()
+	: num_players_(NUM_PLAYERS), num_cards_per_player_(NUM_CARDS_PER_PLAYER), limit_(RUNNING_TOTAL_LIMIT),
+	num_games_(NUM_GAMES)
+{
+	special_[AB_10] = SP_10;
+	special_[AB_20] = SP_20;
+	special_[AB_99] = SP_99;
+	special_[AB_REVERSE] = SP_REVERSE;
+	special_[AB_SKIP] = SP_SKIP;
+	special_[AB_PICK] = SP_PICK;
+
+	weight_[AB_10] = SP_10_WEIGHT;
+	weight_[AB_20] = SP_20_WEIGHT;
+	weight_[AB_99] = SP_99_WEIGHT;
+	weight_[AB_REVERSE] = SP_REVERSE_WEIGHT;
+	weight_[AB_SKIP] = SP_SKIP_WEIGHT;
+	weight_[AB_PICK] = SP_PICK_WEIGHT;
+
+	for (int i = 0; i < MAX_PLAYERS; ++i)
+		ai_[i] = AI_SMART;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           IsValid
+
+Description:	Check if the rules can be played.
+
+Arguments:      None.
+
+Returns:        false if there are too many players or cards, the limit is out of
+				the range of an effect table, or a weight is out of range.
+*---------------------------------------------------------------------------*/
+bool RuleSet::IsValid(void) const
+{
+	if ((num_players_ < 2) || (num_players_ > MAX_PLAYERS) || (num_cards_per_player_ < 1) ||
+		(num_cards_per_player_ > SWEEP_MAX_CARDS) || (num_players_ * num_cards_per_player_ >= NUM_CARDS) ||
+		(limit_ < 1) || (limit_ > EFFECT_MAX_LIMIT) || (num_games_ < 1))
+		return false;
+
+	for (int i = 0; i < AB_NUMBER; ++i)
+	{
+		if ((weight_[i] < 0) || (weight_[i] > 3))
+			return false;
+	}
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           SmartTuning
+
+Description:	Constructor. Priorities are the weights of nintynine.h, and
+				special cards are never dealt early.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+SmartTuning::SmartTuning()
+{
+	RuleSet rules;
+
+	for (int i = 0; i < AB_NUMBER; ++i)
+	{
+		priority_[i] = (float)rules.weight_[i];
+		threshold_[i] = -1;
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           SweepEngine
+
+Description:	Constructor. Create the deck of the rules.
+
+Arguments:      rules: Rules to be played.
+				seed: Random seed.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+SweepEngine::SweepEngine(const RuleSet &rules, unsigned long long seed)
+	: rules_(rules), deck_index_(0), total_(0), players_left_(rules.num_players_), is_order_increase_(true),
+	seed_(seed), rng_(seed)
+{
+	// ability of each face value, the first ability listed wins
+
+	for (int value = 0; value <= NUM_VALUES; ++value)
+	{
+		ability_[value] = AB_NUMBER;
+		for (int i = AB_NUMBER - 1; i >= 0; --i)
+		{
+			if (rules_.special_[i] == value)
+				ability_[value] = i;
+		}
+	}
+
+	// effects of the abilities, compiled for the limit of the rules
+
+	CardEffects effects;
+	effects.SetSpecials(rules_.special_[AB_10], rules_.special_[AB_20], rules_.special_[AB_99], rules_.special_[AB_REVERSE],
+		rules_.special_[AB_SKIP], rules_.special_[AB_PICK], rules_.limit_);
+	effects_.Compile(effects, rules_.limit_);
+
+	// create 52 cards (same order as NintyNine::CreateCards)
+
+	for (int i = 0; i < SU_NUMBER; ++i)
+	{
+		for (int j = 0; j < NUM_VALUES; ++j)
+		{
+			int value = j + 1;
+			int weight = (ability_[value] == AB_NUMBER) ? SP_NULL_WEIGHT : rules_.weight_[ability_[value]];
+
+			cards_[i * NUM_VALUES + j] = Cards(value, (SUIT)i, weight);
+		}
+	}
+
+	std::copy(cards_, cards_ + NUM_CARDS, deck_);
+
+	for (int i = 0; i < MAX_PLAYERS; ++i)
+		tuning_[i] = nullptr;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           SeedStream
+
+Description:	Restart the random stream of the engine (see NintyNine::SeedStream).
+
+Arguments:      stream: Stream number.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void SweepEngine::SeedStream(unsigned long long stream)
+{
+	rng_.Seed(seed_, stream);
+
+	std::copy(cards_, cards_ + NUM_CARDS, deck_);
+}
+
+
+/*--------------------------------------------------------------------------*
+Name:           Play
+
+Description:	Play a single game (same turn and round counting as NintyNine::Play).
+
+Arguments:      stats: record game stats.
+
+Returns:        Winner id.
+*---------------------------------------------------------------------------*/
+int SweepEngine::Play(GameStats &stats)
+{
+	StartGame();
+
+	int num_players = rules_.num_players_;
+	int num_rounds = 0;
+	int num_turns = 0;
+	int player_num = 0;
+
+	for (;;)
+	{
+		++num_turns;
+
+		if (player_num == FirstActiveSeat(active_mask_, is_order_increase_))
+			++num_rounds;
+
+		bool is_end = PlayerTurn(player_num);
+		player_num = NextPlayer(player_num);
+
+		if (is_end)
+			break;
+	}
+
+	stats.Record(num_rounds, num_turns, NUM_ROUNDS_LIMIT * num_players);
+
+	for (int i = 0; i < num_players; ++i)
+	{
+		if (!is_defeat_[i])
+			return i;
+	}
+
+	return 0;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           SetTuning
+
+Description:	Let a smart player pick cards with tuned choices.
+
+Arguments:      player_num: index of the player.
+				tuning: Tuned choices (null: play as the smart AI), kept by the caller.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void SweepEngine::SetTuning(int player_num, const SmartTuning *tuning)
+{
+	tuning_[player_num] = tuning;
+}
+
+// private functions
+
+/*--------------------------------------------------------------------------*
+Name:           Shuffle
+
+Description:	Shuffle the deck (Fisher-Yates, same draws as NintyNine::Shuffle).
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void SweepEngine::Shuffle(void)
+{
+	if (!USE_LAZY_SHUFFLE)
+	{
+		for (int i = NUM_CARDS - 1; i > 0; --i)
+			std::swap(deck_[i], deck_[rng_.Range(i + 1)]);
+	}
+
+	deck_index_ = 0;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           StartGame
+
+Description:	Reset running total and player order, shuffle and deal.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void SweepEngine::StartGame(void)
+{
+	deck_index_ = 0;
+	total_ = 0;
+	players_left_ = rules_.num_players_;
+	active_mask_ = (1u << rules_.num_players_) - 1;
+	is_order_increase_ = true;
+
+	Shuffle();
+
+	// random numbers of the lazy shuffle steps of the deal, generated in one go (as NintyNine::DealCards)
+	uint32_t steps[MAX_PLAYERS * SWEEP_MAX_CARDS];
+
+	if (USE_LAZY_SHUFFLE)
+		rng_.Fill(steps, rules_.num_players_ * rules_.num_cards_per_player_);
+
+	for (int i = 0; i < rules_.num_players_; ++i)
+	{
+		is_defeat_[i] = false;
+
+		for (int j = 0; j < rules_.num_cards_per_player_; ++j)
+		{
+			if (deck_index_ >= NUM_CARDS)
+				Shuffle();
+
+			hands_[i][j] = USE_LAZY_SHUFFLE ?
+				DrawShuffled(deck_, deck_index_, rng_, steps[i * rules_.num_cards_per_player_ + j]) :
+				deck_[deck_index_++];
+		}
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PlayerTurn
+
+Description:	A player plays a turn.
+
+Arguments:      player_num: index of the player.
+
+Returns:        true: only one player left. Game end condition.
+				false: more than one players left.
+*---------------------------------------------------------------------------*/
+bool SweepEngine::PlayerTurn(int player_num)
+{
+	if (!is_defeat_[player_num])
+	{
+		int index = PickCard(player_num);
+
+		AddRunningTotal(hands_[player_num][index].GetValue());
+
+		if (deck_index_ >= NUM_CARDS)
+			Shuffle();
+
+		hands_[player_num][index] = USE_LAZY_SHUFFLE ?
+			DrawShuffled(deck_, deck_index_, rng_, rng_.Next32()) :
+			deck_[deck_index_++];
+
+		// detect if the player loses
+		if (total_ > rules_.limit_)
+		{
+			is_defeat_[player_num] = true;
+			active_mask_ &= ~(1u << player_num);
+			--players_left_;
+			total_ = rules_.limit_;
+		}
+	}
+
+	return players_left_ <= 1;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PickCard
+
+Description:	Card picked by the AI of a player, same choices as PlayerT
+				(PlayRandom, PlayerDumb, PlayerSmart) with the limit of the rules.
+
+Arguments:      player_num: index of the player.
+
+Returns:        Index of the card in the player's hands.
+*---------------------------------------------------------------------------*/
+int SweepEngine::PickCard(int player_num)
+{
+	const Cards *hands = hands_[player_num];
+	int num_cards = rules_.num_cards_per_player_;
+	int ai = rules_.ai_[player_num];
+
+	if (ai == AI_RANDOM)
+		return rng_.Range(num_cards);
+
+	if ((ai == AI_SMART) && (tuning_[player_num] != nullptr))
+		return PickTuned(player_num);
+
+	int value = 0;
+	int card_index = 0;
+	int value_limit = rules_.limit_ - total_;
+	int special_index = 0;
+
+	for (int i = 0; i < num_cards; ++i)
+	{
+		int weight = hands[i].GetWeight();
+
+		// smart AI keeps special cards (weight 1 than weight 2) for last
+		if (ai == AI_SMART)
+		{
+			if ((special_index == 0) && (weight != SP_NULL_WEIGHT))
+			{
+				if ((weight == 2) && (hands[special_index].GetWeight() == 0))
+					special_index = i;
+				else if ((weight == 1) && (hands[special_index].GetWeight() != 1))
+					special_index = i;
+			}
+
+			if (weight != SP_NULL_WEIGHT)
+				continue;
+		}
+
+		if ((hands[i].GetValue() > value) && (hands[i].GetValue() <= value_limit))
+		{
+			card_index = i;
+			value = hands[i].GetValue();
+		}
+	}
+
+	if ((ai == AI_SMART) && (value == 0))
+		return special_index;
+
+	return card_index;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PickTuned
+
+Description:	Card picked by a player with tuned choices (see SmartTuning).
+				Special cards due early come first (lowest priority first),
+				then the largest normal card that fits, then the special card
+				of the lowest priority.
+
+Arguments:      player_num: index of the player.
+
+Returns:        Index of the card in the player's hands.
+*---------------------------------------------------------------------------*/
+int SweepEngine::PickTuned(int player_num)
+{
+	const SmartTuning &tuning = *tuning_[player_num];
+	const Cards *hands = hands_[player_num];
+	int num_cards = rules_.num_cards_per_player_;
+	int value_limit = rules_.limit_ - total_;
+
+	int value = 0;
+	int card_index = -1;
+	int special_index = -1;
+	int early_index = -1;
+
+	for (int i = 0; i < num_cards; ++i)
+	{
+		int ability = ability_[hands[i].GetValue()];
+
+		if (ability == AB_NUMBER)
+		{
+			if ((hands[i].GetValue() > value) && (hands[i].GetValue() <= value_limit))
+			{
+				card_index = i;
+				value = hands[i].GetValue();
+			}
+		}
+		else
+		{
+			if ((special_index < 0) ||
+				(tuning.priority_[ability] < tuning.priority_[ability_[hands[special_index].GetValue()]]))
+				special_index = i;
+
+			if ((value_limit <= tuning.threshold_[ability]) && ((early_index < 0) ||
+				(tuning.priority_[ability] < tuning.priority_[ability_[hands[early_index].GetValue()]])))
+				early_index = i;
+		}
+	}
+
+	if (early_index >= 0)
+		return early_index;
+	if (card_index >= 0)
+		return card_index;
+	if (special_index >= 0)
+		return special_index;
+
+	return 0;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           AddRunningTotal
+
+Description:	Add card number to running total, also deals special cards.
+				+/-10 and +/-20 turn down within 9 and 19 of the limit,
+				"99" sets the running total to the limit (same as the default rules),
+				looked up in the effect table compiled for the rules.
+
+Arguments:      value: Card face value.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void SweepEngine::AddRunningTotal(int value)
+{
+	const EffectEntry &entry = effects_.Get(total_, value);
+
+	total_ = entry.total_;
+	is_order_increase_ = (is_order_increase_ != ((entry.flags_ & EF_REVERSE) != 0));
+}
+
+/*--------------------------------------------------------------------------*
+Name:           NextPlayer
+
+Description:	Get next player index not defeated, depending on player order.
+
+Arguments:      player_num: Index of the player.
+
+Returns:        Next player index.
+*---------------------------------------------------------------------------*/
+int SweepEngine::NextPlayer(int player_num)
+{
+	return NextActiveSeat(active_mask_, player_num, is_order_increase_);
+}
+
+// sweep
+
+/*--------------------------------------------------------------------------*
+Name:           ReadSweepGrid
+
+Description:	Read a grid file. Every combination of the listed values is a point,
+				the first key listed changes slowest. Keys not listed keep their
+				default value, "#" starts a comment.
+
+Arguments:      path: Path of the grid file.
+				points: Points that can be played.
+				num_invalid: Number of points left out.
+				error_line: Line number of a bad line (0 if the file can't be read).
+
+Returns:        false if the file can't be read or has a bad line.
+*---------------------------------------------------------------------------*/
+bool POKER::ReadSweepGrid(const char *path, std::vector<RuleSet> &points, int &num_invalid, int &error_line)
+{
+	points.clear();
+	num_invalid = 0;
+	error_line = 0;
+
+	std::ifstream file(path);
+	if (!file)
+		return false;
+
+	// keys and their values
+
+	std::vector<std::string> keys;
+	std::vector<std::vector<std::string> > values;
+	std::string line;
+
+	for (int line_num = 1; std::getline(file, line); ++line_num)
+	{
+		line = line.substr(0, line.find('#'));
+
+		std::istringstream words(line);
+		std::string key;
+		if (!(words >> key))
+			continue;
+
+		std::vector<std::string> list;
+		std::string value;
+		RuleSet test;
+
+		while (words >> value)
+		{
+			if (!SetRule(test, key, value))
+			{
+				error_line = line_num;
+				return false;
+			}
+
+			list.push_back(value);
+		}
+
+		if (list.empty())
+		{
+			error_line = line_num;
+			return false;
+		}
+
+		keys.push_back(key);
+		values.push_back(list);
+	}
+
+	// every combination, counting with the last key changing fastest
+
+	std::vector<size_t> choice(keys.size(), 0);
+
+	for (;;)
+	{
+		RuleSet point;
+		for (size_t i = 0; i < keys.size(); ++i)
+			SetRule(point, keys[i], values[i][choice[i]]);
+
+		if (point.IsValid())
+			points.push_back(point);
+		else
+			++num_invalid;
+
+		int i = (int)keys.size() - 1;
+		for (; i >= 0; --i)
+		{
+			if (++choice[i] < values[i].size())
+				break;
+
+			choice[i] = 0;
+		}
+
+		if (i < 0)
+			break;
+	}
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           RunSweep
+
+Description:	Play every point of a sweep on a work-stealing pool, one job per point.
+				Each point plays its games on random streams 0, 1, 2, ... so points
+				are compared on the same shuffles. A row is written (and flushed)
+				as soon as it and all rows before it are done, so rows stay in
+				point order while the sweep streams its results.
+
+Arguments:      points: Points of the sweep.
+				num_threads: Number of threads (0 means all hardware threads).
+				seed: Random seed (0 means seed from current time).
+				out: Output of CSV rows.
+
+Returns:        Random seed of all points.
+*---------------------------------------------------------------------------*/
+unsigned long long POKER::RunSweep(const std::vector<RuleSet> &points, int num_threads, unsigned long long seed, std::ostream &out)
+{
+	if (seed == 0)
+		seed = (unsigned long long)std::time(0);
+
+	out << "point,players,cards,limit";
+	for (int i = 0; i < AB_NUMBER; ++i)
+		out << ',' << SPECIAL_KEYS[i];
+	for (int i = 0; i < AB_NUMBER; ++i)
+		out << ',' << WEIGHT_KEYS[i];
+	out << ",ai,games,mean_rounds,mean_turns,exceed_rounds,exceed_turns";
+	for (int i = 0; i < MAX_PLAYERS; ++i)
+		out << ",win_" << i;
+	out << '\n' << std::setprecision(6);
+
+	int num_points = (int)points.size();
+	std::vector<ThreadResult> results(num_points);
+	std::vector<char> is_done(num_points, 0);
+	int next_row = 0;
+	std::mutex out_mutex;
+
+	WorkPool pool(GetNumThreads(num_threads, num_points));
+
+	pool.Run(num_points, [&](int job, int)
+	{
+		const RuleSet &rules = points[job];
+		SimResult &result = results[job].result_;
+
+		SweepEngine game(rules, seed);
+
+		// without counter-based mode, each point needs its own stream
+		if (!USE_COUNTER_RNG)
+			game.SeedStream(job + 1);
+
+		for (int i = 0; i < rules.num_games_; ++i)
+		{
+			if (USE_COUNTER_RNG)
+				game.SeedStream(i);
+
+			int winner = game.Play(result.stats_);
+			++result.stats_.num_games_;
+			++result.win_player_[winner];
+		}
+
+		// write every row that is ready
+		std::lock_guard<std::mutex> lock(out_mutex);
+
+		is_done[job] = 1;
+		for (; (next_row < num_points) && is_done[next_row]; ++next_row)
+			WriteRow(out, next_row, points[next_row], results[next_row].result_);
+
+		out.flush();
+	});
+
+	return seed;
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Rule/parameter sweep
+// a grid file lists values of rule parameters, every combination is a point of the sweep
+// points are played by SweepEngine, an engine whose rules (players, cards, limit, special cards
+// and weights) are set at runtime, so a grid of variants runs in one process without rebuilding
+// with the default rules it plays exactly the same games as NintyNine (same random streams)
+// points run on a work-stealing pool, one CSV row per point is written as soon as all earlier rows are done
+
+#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "effects.h"
+#include "nintynine.h"
+#include "simulation.h"
+
+namespace POKER
+{
+	// largest number of cards per player of a sweep point
+	static const int SWEEP_MAX_CARDS = 8;
+
+	// special abilities (order of SPECIAL), a face value with more than one ability gets the first one
+	enum ABILITY
+	{
+		AB_10,
+		AB_20,
+		AB_99,
+		AB_REVERSE,
+		AB_SKIP,
+		AB_PICK,
+		AB_NUMBER,		// normal card
+	};
+
+	// rules of a sweep point, set at runtime (default values are set in nintynine.h)
+	struct RuleSet
+	{
+		int num_players_;				// number of players
+		int num_cards_per_player_;		// number of cards each player has
+		int limit_;						// running total limit
+		int special_[AB_NUMBER];		// face value of each ability (a value outside 1 ~ NUM_VALUES removes it)
+		int weight_[AB_NUMBER];			// weight of each ability (0 ~ 3)
+		int ai_[MAX_PLAYERS];			// AI of each player
+		int num_games_;					// number of games
+
+		// constructor
+		RuleSet();
+
+		// check if the rules can be played
+		bool IsValid(void) const;
+	};
+
+	// choices of a tuned smart AI (genome of the tuner, see tuner.h)
+	// with no card to deal early, it deals the largest normal card that fits, as the smart AI does;
+	// if none fits, it deals the special card of the lowest priority, saving the highest for last
+	// a special card is dealt before normal cards once the room left under the limit is at most its threshold
+	struct SmartTuning
+	{
+		float priority_[AB_NUMBER];		// priority of each ability (lowest dealt first)
+		int threshold_[AB_NUMBER];		// room left at which each ability is dealt early (-1: never)
+
+		// constructor (priorities are the weights of nintynine.h, never dealt early)
+		SmartTuning();
+	};
+
+	// engine playing rules set at runtime
+	class SweepEngine
+	{
+	public:
+		// constructor
+		SweepEngine(const RuleSet &rules, unsigned long long seed);
+
+		// restart random stream (game index in counter-based mode), also restore deck order
+		void SeedStream(unsigned long long stream);
+		// play a single game, returns the winner
+		int Play(GameStats &stats);
+		// let a smart player pick cards with tuned choices (null: play as the smart AI)
+		void SetTuning(int player_num, const SmartTuning *tuning);
+
+	private:
+		RuleSet rules_;										// rules
+		int ability_[NUM_VALUES + 1];						// ability of each face value
+		EffectTable effects_;								// effect of each card on each running total
+		Cards cards_[NUM_CARDS];							// cards in the order of a new deck
+		Cards deck_[NUM_CARDS];								// one deck of cards
+		int deck_index_;									// index of the current card of deck
+		Cards hands_[MAX_PLAYERS][SWEEP_MAX_CARDS];			// player hands
+		bool is_defeat_[MAX_PLAYERS];						// flag on if the player is defeated
+		int total_;											// running total number
+		int players_left_;									// number of players left
+		unsigned int active_mask_;							// bit i is set if player i is not defeated (active-seat ring)
+		bool is_order_increase_;							// player order
+		unsigned long long seed_;							// random seed
+		Random rng_;										// random number generator
+		const SmartTuning *tuning_[MAX_PLAYERS];			// tuned choices of each player (null: not tuned)
+
+		// shuffle the deck
+		void Shuffle(void);
+		// shuffle and deal cards to players
+		void StartGame(void);
+		// one player plays a turn, return true if there's only one player left
+		bool PlayerTurn(int player_num);
+		// card picked by the AI of a player (same as PlayerT)
+		int PickCard(int player_num);
+		// card picked by a player with tuned choices
+		int PickTuned(int player_num);
+		// add card number to running total, also deals special cards
+		void AddRunningTotal(int value);
+		// get next player
+		int NextPlayer(int player_num);
+	};
+
+	// read a grid file, every combination of the listed values is a point
+	// a line is a key and its values, e.g. "limit 79 89 99", "ai ssss sssr", keys are
+	// players, cards, limit, games, sp_10, sp_20, sp_99, sp_reverse, sp_skip, sp_pick (face values),
+	// w_10, w_20, w_99, w_reverse, w_skip, w_pick (weights), ai (r/d/s for each seat, repeated to fill all seats)
+	// points that can't be played (e.g. not enough cards) are left out and counted in num_invalid
+	// returns false if the file can't be read or has a bad line (error_line, 0 if the file can't be read)
+	bool ReadSweepGrid(const char *path, std::vector<RuleSet> &points, int &num_invalid, int &error_line);
+
+	// play every point on threads (0 means all hardware threads), write a CSV row of each point to out
+	// returns the random seed of all points (seed 0 means seed from current time)
+	unsigned long long RunSweep(const std::vector<RuleSet> &points, int num_threads, unsigned long long seed, std::ostream &out);
+}
@@ -0,0 +1,210 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Round-robin tournament
+
+#include "tournament.h"
+#include "workpool.h"
+
+using namespace POKER;
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           AddLineups
+
+Description:	Enumerate line-ups (AI in non-decreasing order, so each multiset once)
+				and add every distinct seat rotation of each one.
+
+Arguments:      ais: AI taking part.
+				num_players: Number of players.
+				seat: Seat being filled.
+				first: Lowest index into ais allowed for this seat.
+				lineup: AI of seats filled so far.
+				result: Seat rotations are added to results_ and lineup_.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void AddLineups(const std::vector<int> &ais, int num_players, int seat, int first, int lineup[],
+	TournamentResult &result)
+{
+	if (seat < num_players)
+	{
+		for (int i = first; i < (int)ais.size(); ++i)
+		{
+			lineup[seat] = ais[i];
+			AddLineups(ais, num_players, seat + 1, i, lineup, result);
+		}
+
+		return;
+	}
+
+	// every rotation, skip the ones equal to an earlier rotation (e.g. all seats the same AI)
+
+	for (int r = 0; r < num_players; ++r)
+	{
+		bool is_repeat = false;
+		for (int q = 0; (q < r) && !is_repeat; ++q)
+		{
+			is_repeat = true;
+			for (int i = 0; i < num_players; ++i)
+			{
+				if (lineup[(i + r) % num_players] != lineup[(i + q) % num_players])
+					is_repeat = false;
+			}
+		}
+
+		if (is_repeat)
+			continue;
+
+		SimResult rotation;
+		rotation.num_players_ = num_players;
+		rotation.seed_ = result.seed_;
+		for (int i = 0; i < num_players; ++i)
+			rotation.ai_[i] = lineup[(i + r) % num_players];
+
+		result.results_.push_back(rotation);
+		result.lineup_.push_back(result.num_lineups_);
+	}
+
+	++result.num_lineups_;
+}
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           RunTournament
+
+Description:	Play a tournament: every line-up in every seat rotation, each
+				rotation plays settings.sim_.num_games_ games. Rotations are split
+				into jobs, results of jobs are merged in job order, so the result
+				does not depend on the number of threads.
+
+Arguments:      settings: Tournament settings.
+				result: Result of each seat rotation.
+
+Returns:        false if the decision table is built for other rules.
+*---------------------------------------------------------------------------*/
+template <typename RULES>
+bool POKER::RunTournament(const TournamentSettings &settings, TournamentResult &result)
+{
+	typedef NintyNineT<RULES> Engine;
+
+	// seed of all games (resolves seed 0 the same way as the engine)
+	Engine main(false, settings.sim_.seed_);
+	main.Initialize();
+	if (!main.SetDecisionTable(settings.sim_.table_))
+		return false;
+
+	result.num_players_ = Engine::NUM_PLAYERS;
+	result.seed_ = main.GetSeed();
+	result.num_lineups_ = 0;
+	result.results_.clear();
+	result.lineup_.clear();
+
+	// line-ups and seat rotations
+
+	std::vector<int> ais;
+	for (int ai = AI_RANDOM; ai < NUM_AI; ++ai)
+	{
+		if (settings.ai_mask_ & (1 << ai))
+			ais.push_back(ai);
+	}
+
+	int lineup[MAX_PLAYERS];
+	AddLineups(ais, Engine::NUM_PLAYERS, 0, 0, lineup, result);
+
+	// split each rotation into jobs
+
+	int num_games = settings.sim_.num_games_;
+	int job_games = (settings.job_games_ > 0) ? settings.job_games_ : num_games;
+	int jobs_per_rotation = (num_games + job_games - 1) / job_games;
+	int num_rotations = (int)result.results_.size();
+
+	result.num_jobs_ = num_rotations * jobs_per_rotation;
+
+	std::vector<ThreadResult> jobs(result.num_jobs_);
+	const DecisionTable *table = settings.sim_.table_;
+	unsigned long long seed = result.seed_;
+
+	WorkPool pool(GetNumThreads(settings.sim_.num_threads_, result.num_jobs_));
+
+	pool.Run(result.num_jobs_, [&](int job, int)
+	{
+		const SimResult &rotation = result.results_[job / jobs_per_rotation];
+		int first_game = (job % jobs_per_rotation) * job_games;
+		int last_game = first_game + job_games;
+		if (last_game > num_games)
+			last_game = num_games;
+
+		Engine game(false, seed);
+		game.Initialize(rotation.ai_);
+		// the table fits the rules, the main engine took it
+		game.SetDecisionTable(table);
+		game.SetEffects(settings.sim_.effects_);
+
+		// without counter-based mode, each job needs its own stream
+		if (!USE_COUNTER_RNG)
+			game.SeedStream(job + 1);
+
+		SimResult &job_result = jobs[job].result_;
+		for (int i = first_game; i < last_game; ++i)
+		{
+			if (USE_COUNTER_RNG)
+				game.SeedStream(i);
+
+			int winner = game.Play(job_result.stats_);
+			++job_result.stats_.num_games_;
+			++job_result.win_player_[winner];
+		}
+
+#if NINTYNINE_PROFILE
+		game.MergeProfile(job_result.profile_);
+#endif
+	});
+
+	result.num_threads_ = pool.GetNumThreads();
+	result.num_steals_ = pool.GetNumSteals();
+
+	// merge jobs into their rotations
+
+	for (int i = 0; i < result.num_jobs_; ++i)
+		result.results_[i / jobs_per_rotation].Merge(jobs[i].result_);
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           RunTournament
+
+Description:	Play a tournament on the engine compiled for the number of
+				players and number of cards per player in settings.
+
+Arguments:      settings: Tournament settings.
+				result: Result of each seat rotation.
+
+Returns:        false if no engine is compiled for this configuration, no AI is picked,
+				or the decision table is built for other rules.
+*---------------------------------------------------------------------------*/
+bool POKER::RunTournament(const TournamentSettings &settings, TournamentResult &result)
+{
+	if ((settings.ai_mask_ & ((1 << NUM_AI) - 1) & ~(1 << AI_PLAYER)) == 0)
+		return false;
+
+#define NINTYNINE_TOURNAMENT(players, cards)												\
+	if ((settings.sim_.num_players_ == players) && (settings.sim_.num_cards_per_player_ == cards))	\
+		return RunTournament<Rules<players, cards> >(settings, result);
+
+	NINTYNINE_CONFIGS(NINTYNINE_TOURNAMENT)
+#undef NINTYNINE_TOURNAMENT
+
+	return false;
+}
+
+// pre-instantiated tournaments
+
+#define NINTYNINE_INSTANTIATE(players, cards)	\
+	template bool POKER::RunTournament<Rules<players, cards> >(const TournamentSettings &, TournamentResult &);
+NINTYNINE_CONFIGS(NINTYNINE_INSTANTIATE)
+#undef NINTYNINE_INSTANTIATE
\ No newline at end of file
@@ -0,0 +1,59 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Round-robin tournament
+// every line-up of the chosen AI (a multiset, e.g. Smart Smart Dumb Random) is played in every seat rotation,
+// so each AI sits in each seat and seat effects cancel out of the strategy comparison
+// each rotation plays the same games (game i uses random stream i), which also cancels out deck luck
+// rotations are split into jobs of TOURNAMENT_JOB_GAMES games and run on a work-stealing pool
+
+#pragma once
+
+#include <vector>
+
+#include "nintynine.h"
+#include "simulation.h"
+
+namespace POKER
+{
+	// number of games of a tournament job
+	static const int TOURNAMENT_JOB_GAMES = 1000;
+
+	// settings of a tournament
+	struct TournamentSettings
+	{
+		SimSettings sim_;				// rules, games of each seat rotation, threads and decision table
+		int ai_mask_;					// AI taking part (bit i set: AI_ID i, human is never picked)
+		int job_games_;					// number of games of a job
+
+		// constructor
+		TournamentSettings()
+			: ai_mask_((1 << AI_RANDOM) | (1 << AI_DUMB) | (1 << AI_SMART)), job_games_(TOURNAMENT_JOB_GAMES) {}
+	};
+
+	// result of a tournament
+	struct TournamentResult
+	{
+		int num_players_;					// number of players
+		unsigned long long seed_;			// random seed
+		int num_lineups_;					// number of line-ups
+		int num_jobs_;						// number of jobs
+		int num_threads_;					// number of threads
+		int num_steals_;					// number of jobs stolen by another thread
+		std::vector<SimResult> results_;	// result of each seat rotation (ai_ is AI of each seat)
+		std::vector<int> lineup_;			// line-up of each seat rotation
+
+		// constructor
+		TournamentResult() : num_players_(0), seed_(0), num_lineups_(0), num_jobs_(0), num_threads_(0), num_steals_(0) {}
+	};
+
+	// play a tournament on the engine of the rules, returns false if the decision table is built for other rules
+	template <typename RULES>
+	bool RunTournament(const TournamentSettings &settings, TournamentResult &result);
+
+	// play a tournament on the engine compiled for the number of players and cards in settings
+	// returns false if there's no such engine (see NINTYNINE_CONFIGS), no AI is picked
+	// or the decision table is built for other rules
+	bool RunTournament(const TournamentSettings &settings, TournamentResult &result);
+}
@@ -0,0 +1,368 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Game trace
+
+#include <chrono>		// std::chrono::milliseconds
+
+#include "effects.h"
+#include "nintynine.h"
+#include "trace.h"
+
+using namespace POKER;
+
+// number of events the writer moves from a ring at once
+static const int TRACE_BATCH = 256;
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           TraceRing
+
+Description:	Constructor.
+
+Arguments:      sink: Sink of the ring.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+TraceRing::TraceRing(TraceSink *sink)
+	: head_(0), tail_(0), sink_(sink)
+{
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetLevel
+
+Description:	Verbosity of a game.
+
+Arguments:      game: Game index.
+
+Returns:        Verbosity (TRACE_OFF if the game is not sampled).
+*---------------------------------------------------------------------------*/
+int TraceRing::GetLevel(unsigned long long game) const
+{
+	return sink_->GetLevel(game);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Push
+
+Description:	Add an event (engine thread). If the ring is full, wait for the
+				writer to make room, so traced games lose no event.
+				The console trace writes the event at once.
+
+Arguments:      event: Event.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void TraceRing::Push(const TraceEvent &event)
+{
+	if (sink_->IsSynchronous())
+	{
+		sink_->Write(event);
+		return;
+	}
+
+	unsigned int head = head_.load(std::memory_order_relaxed);
+	while (head - tail_.load(std::memory_order_acquire) >= (unsigned int)TRACE_RING_SIZE)
+		std::this_thread::yield();
+
+	events_[head & (TRACE_RING_SIZE - 1)] = event;
+	head_.store(head + 1, std::memory_order_release);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Pop
+
+Description:	Remove the oldest events (writer thread).
+
+Arguments:      events: Receives the events.
+				max_events: Maximum number of events removed.
+
+Returns:        Number of events removed.
+*---------------------------------------------------------------------------*/
+int TraceRing::Pop(TraceEvent events[], int max_events)
+{
+	unsigned int tail = tail_.load(std::memory_order_relaxed);
+	unsigned int num_events = head_.load(std::memory_order_acquire) - tail;
+	if (num_events > (unsigned int)max_events)
+		num_events = (unsigned int)max_events;
+
+	for (unsigned int i = 0; i < num_events; ++i)
+		events[i] = events_[(tail + i) & (TRACE_RING_SIZE - 1)];
+
+	tail_.store(tail + num_events, std::memory_order_release);
+
+	return (int)num_events;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           TraceSink
+
+Description:	Constructor.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+TraceSink::TraceSink()
+	: file_(nullptr), level_(TRACE_OFF), every_(1), is_synchronous_(false), is_running_(false)
+{
+}
+
+/*--------------------------------------------------------------------------*
+Name:           ~TraceSink
+
+Description:	Destructor, closes the trace.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+TraceSink::~TraceSink()
+{
+	Close();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Open
+
+Description:	Create the trace file and start the writer thread.
+
+Arguments:      path: Trace file.
+				level: Verbosity (TRACE_LEVEL).
+				every: Sampling period, games whose index is a multiple of it are traced.
+
+Returns:        false if the file can't be written.
+*---------------------------------------------------------------------------*/
+bool TraceSink::Open(const char *path, int level, int every)
+{
+	Close();
+
+	file_ = std::fopen(path, "w");
+	if (file_ == nullptr)
+		return false;
+
+	level_ = level;
+	every_ = (every > 0) ? every : 1;
+	is_synchronous_ = false;
+
+	is_running_ = true;
+	writer_ = std::thread(&TraceSink::RunWriter, this);
+
+	return true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           OpenConsole
+
+Description:	Trace every game to the console. Events are written by the
+				engine thread as they are pushed.
+
+Arguments:      level: Verbosity (TRACE_LEVEL).
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void TraceSink::OpenConsole(int level)
+{
+	Close();
+
+	file_ = stdout;
+	level_ = level;
+	every_ = 1;
+	is_synchronous_ = true;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Close
+
+Description:	Write the events left in the rings, stop the writer and close
+				the file. Engines must not push events any more.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void TraceSink::Close(void)
+{
+	if (writer_.joinable())
+	{
+		is_running_ = false;
+		writer_.join();
+	}
+
+	if ((file_ != nullptr) && (file_ != stdout))
+		std::fclose(file_);
+
+	file_ = nullptr;
+	level_ = TRACE_OFF;
+	rings_.clear();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           AddRing
+
+Description:	Add a ring buffer for an engine thread. The ring is kept until
+				the trace is closed.
+
+Arguments:      None.
+
+Returns:        The ring (null if the trace is not open).
+*---------------------------------------------------------------------------*/
+TraceRing *TraceSink::AddRing(void)
+{
+	if (file_ == nullptr)
+		return nullptr;
+
+	std::lock_guard<std::mutex> lock(rings_mutex_);
+	rings_.emplace_back(new TraceRing(this));
+
+	return rings_.back().get();
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetLevel
+
+Description:	Verbosity of a game.
+
+Arguments:      game: Game index.
+
+Returns:        Verbosity (TRACE_OFF if the game is not sampled).
+*---------------------------------------------------------------------------*/
+int TraceSink::GetLevel(unsigned long long game) const
+{
+	return ((game % every_) == 0) ? level_ : TRACE_OFF;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Write
+
+Description:	Format an event and write it to the file.
+
+Arguments:      event: Event.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void TraceSink::Write(const TraceEvent &event)
+{
+	const char *ai = DisplayAI(event.ai_);
+
+	switch (event.type_)
+	{
+	case TE_DEAL:
+		fprintf(file_, "game %llu: Player %d (%s) is dealt %c\n", event.game_, event.player_, ai, DisplayCard(event.value_));
+		break;
+
+	case TE_ROUND:
+		fprintf(file_, "game %llu: (Round %d) TOTAL: %d\n", event.game_, event.arg_, event.total_);
+		break;
+
+	case TE_PLAY:
+		fprintf(file_, "game %llu: Player %d (%s) deals %c, total %d\n", event.game_, event.player_, ai, DisplayCard(event.value_), event.total_);
+		break;
+
+	case TE_EFFECT:
+		if (event.value_ == EK_SET)
+			fprintf(file_, "game %llu: Player %d (%s) sets the total to %d\n", event.game_, event.player_, ai, event.total_);
+		else
+			fprintf(file_, "game %llu: Player %d (%s) moves the total by %+d to %d\n", event.game_, event.player_, ai, event.arg_, event.total_);
+		break;
+
+	case TE_ORDER:
+		if (event.value_ & EF_REVERSE)
+			fprintf(file_, "game %llu: Player %d (%s) reverses the order\n", event.game_, event.player_, ai);
+		if (event.value_ & EF_SKIP)
+			fprintf(file_, "game %llu: Player %d (%s) skips\n", event.game_, event.player_, ai);
+		if (event.value_ & EF_PICK)
+			fprintf(file_, "game %llu: Player %d (%s) picks\n", event.game_, event.player_, ai);
+		break;
+
+	case TE_ELIMINATION:
+		fprintf(file_, "game %llu: Player %d (%s) Loses!\n", event.game_, event.player_, ai);
+		break;
+
+	case TE_WIN:
+		fprintf(file_, "game %llu: Player %d (%s) Wins! (%d rounds)\n", event.game_, event.player_, ai, event.arg_);
+		break;
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetConsoleTrace
+
+Description:	Ring of the console trace (DISPLAY_GAME), every game is traced
+				at TRACE_PLAY and written by the engine thread.
+
+Arguments:      None.
+
+Returns:        The ring.
+*---------------------------------------------------------------------------*/
+TraceRing *POKER::GetConsoleTrace(void)
+{
+	static TraceSink console;
+	static TraceRing *ring = nullptr;
+
+	if (ring == nullptr)
+	{
+		console.OpenConsole(TRACE_PLAY);
+		ring = console.AddRing();
+	}
+
+	return ring;
+}
+
+// private functions
+
+/*--------------------------------------------------------------------------*
+Name:           RunWriter
+
+Description:	Writer thread. Move events from the rings to the file until the
+				trace is closed, then write the events left.
+
+Arguments:      None.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void TraceSink::RunWriter(void)
+{
+	while (is_running_)
+	{
+		if (Drain() == 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(TRACE_WRITER_SLEEP));
+	}
+
+	while (Drain() > 0)
+		;
+
+	std::fflush(file_);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Drain
+
+Description:	Move the events of every ring to the file.
+
+Arguments:      None.
+
+Returns:        Number of events written.
+*---------------------------------------------------------------------------*/
+int TraceSink::Drain(void)
+{
+	TraceEvent events[TRACE_BATCH];
+	int num_written = 0;
+
+	std::lock_guard<std::mutex> lock(rings_mutex_);
+	for (size_t i = 0; i < rings_.size(); ++i)
+	{
+		int num_events;
+		while ((num_events = rings_[i]->Pop(events, TRACE_BATCH)) > 0)
+		{
+			for (int j = 0; j < num_events; ++j)
+				Write(events[j]);
+			num_written += num_events;
+		}
+	}
+
+	return num_written;
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Game trace
+// engines push small fixed-size events (deal, play, special effect, elimination, win) into a ring buffer
+// of their own thread, a background writer thread formats the events and writes them to the trace file
+// so the game loop never formats text or waits on the file
+// each ring has a single producer (the engine thread) and a single consumer (the writer), so it needs no lock
+// a game is traced if its index is a multiple of the sampling period, events above the verbosity are skipped
+// the console trace (DISPLAY_GAME) formats on the engine thread instead, to keep its order with human input
+
+#pragma once
+
+#include <atomic>		// std::atomic
+#include <cstdio>		// FILE
+#include <memory>		// std::unique_ptr
+#include <mutex>		// std::mutex
+#include <thread>		// std::thread
+#include <vector>
+
+namespace POKER
+{
+	// number of events of each ring buffer (power of 2)
+	static const int TRACE_RING_SIZE = 4096;
+	// time the writer sleeps when every ring is empty (milliseconds)
+	static const int TRACE_WRITER_SLEEP = 1;
+
+	// verbosity, each level also traces the events of the levels below
+	enum TRACE_LEVEL
+	{
+		TRACE_OFF,				// nothing
+		TRACE_RESULT,			// winner of the game
+		TRACE_ELIMINATION,		// players defeated
+		TRACE_PLAY,				// rounds, cards dealt and special effects
+		TRACE_DEAL,				// cards dealt to the hands of players at the start of the game
+
+		TRACE_NUMBER,
+	};
+
+	// default verbosity of a trace file
+	static const int TRACE_DEFAULT_LEVEL = TRACE_PLAY;
+	// default sampling period of a trace file (1 in N games is traced)
+	static const int TRACE_DEFAULT_EVERY = 1000;
+
+	// trace events
+	enum TRACE_EVENT
+	{
+		TE_DEAL,				// a player is dealt a card (value)
+		TE_ROUND,				// a round starts (arg: round)
+		TE_PLAY,				// a player deals a card (value, total after the card)
+		TE_EFFECT,				// a card moves the total other than by its face value (value: EFFECT_KIND, total, arg: change)
+		TE_ORDER,				// a card with flags takes effect (value: EFFECT_FLAG)
+		TE_ELIMINATION,			// a player is defeated
+		TE_WIN,					// a player wins (arg: number of rounds)
+	};
+
+	// an event of a traced game
+	struct TraceEvent
+	{
+		unsigned long long game_;	// game index
+		unsigned char type_;		// TRACE_EVENT
+		unsigned char player_;		// player number
+		unsigned char ai_;			// AI of the player
+		unsigned char value_;		// face value or special effect
+		short total_;				// running total
+		short arg_;					// round (TE_ROUND) or number of rounds (TE_WIN)
+	};
+
+	class TraceSink;
+
+	// events of one engine thread, waiting for the writer
+	class TraceRing
+	{
+	public:
+		// constructor
+		explicit TraceRing(TraceSink *sink);
+
+		// verbosity of a game (TRACE_OFF if the game is not sampled)
+		int GetLevel(unsigned long long game) const;
+		// add an event, waits for the writer if the ring is full
+		void Push(const TraceEvent &event);
+		// remove up to max_events events, returns the number of events removed
+		int Pop(TraceEvent events[], int max_events);
+
+	private:
+		// the events keep head_ and tail_ on different cache lines
+		std::atomic<unsigned int> head_;		// number of events pushed (written by the engine thread)
+		TraceEvent events_[TRACE_RING_SIZE];	// events
+		std::atomic<unsigned int> tail_;		// number of events popped (written by the writer)
+		TraceSink *sink_;						// sink of the ring
+	};
+
+	// trace file and its writer thread
+	class TraceSink
+	{
+	public:
+		// constructor
+		TraceSink();
+		// destructor, closes the trace
+		~TraceSink();
+
+		// create the trace file and start the writer, returns false if it can't be written
+		// games whose index is a multiple of every are traced up to level
+		bool Open(const char *path, int level, int every);
+		// trace to the console on the engine thread (no writer)
+		void OpenConsole(int level);
+		// write the events left, stop the writer and close the file
+		void Close(void);
+
+		// add a ring for an engine thread (kept until the trace is closed), null if the trace is not open
+		TraceRing *AddRing(void);
+		// verbosity of a game (TRACE_OFF if the game is not sampled)
+		int GetLevel(unsigned long long game) const;
+		// the console trace formats events as they are pushed
+		bool IsSynchronous(void) const { return is_synchronous_; }
+		// format an event and write it to the file
+		void Write(const TraceEvent &event);
+
+	private:
+		FILE *file_;									// trace file (stdout for the console)
+		int level_;										// verbosity
+		int every_;										// sampling period (games)
+		bool is_synchronous_;							// format events on the engine thread
+		std::vector<std::unique_ptr<TraceRing> > rings_;	// ring of each engine thread
+		std::mutex rings_mutex_;						// guards rings_ (rings are added while the writer runs)
+		std::atomic<bool> is_running_;					// the writer keeps polling the rings
+		std::thread writer_;							// writer thread
+
+		// writer thread, moves events from the rings to the file
+		void RunWriter(void);
+		// move the events of every ring to the file, returns the number of events written
+		int Drain(void);
+
+		// not copyable, it owns the file and the writer
+		TraceSink(const TraceSink &);
+		TraceSink &operator=(const TraceSink &);
+	};
+
+	// ring of the console trace (DISPLAY_GAME), every game is traced at TRACE_PLAY
+	TraceRing *GetConsoleTrace(void);
+}
@@ -0,0 +1,323 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Evolutionary tuner of the smart AI
+
+#include <algorithm>	// std::sort, std::max
+#include <chrono>		// std::chrono::steady_clock
+#include <cmath>		// std::sqrt, std::log, std::cos, std::floor
+#include <ctime>		// std::time
+#include <iomanip>		// std::setprecision
+
+#include "tuner.h"
+#include "workpool.h"
+
+using namespace POKER;
+
+// number of genes: a priority and a threshold of each ability
+static const int NUM_GENES = 2 * AB_NUMBER;
+// games of a job, a candidate in a seat is split into jobs of at most this many games
+static const int JOB_GAMES = 1000;
+// share of the spreads moved to the kept candidates each generation
+static const double SPREAD_RATE = 0.7;
+// smallest spread of a priority and of a threshold
+static const double MIN_SPREAD_PRIORITY = 0.05;
+static const double MIN_SPREAD_THRESHOLD = 0.5;
+
+// CSV names of abilities (order of ABILITY)
+static const char *ABILITY_NAMES[AB_NUMBER] = { "10", "20", "99", "reverse", "skip", "pick" };
+
+// a candidate genome
+struct Candidate
+{
+	double genes_[NUM_GENES];	// priorities, then thresholds
+	SmartTuning tuning_;		// genes as played
+	int wins_;					// games won
+};
+
+// local functions
+
+/*--------------------------------------------------------------------------*
+Name:           SetTuning
+
+Description:	Turn genes into the choices played (thresholds are rounded down).
+
+Arguments:      genes: Genes of a candidate.
+				tuning: Tuned choices.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void SetTuning(const double genes[], SmartTuning &tuning)
+{
+	for (int i = 0; i < AB_NUMBER; ++i)
+	{
+		tuning.priority_[i] = (float)genes[i];
+		tuning.threshold_[i] = (int)std::floor(genes[AB_NUMBER + i]);
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           GetNormal
+
+Description:	Draw a standard normal number (Box-Muller).
+
+Arguments:      rng: Random number generator.
+
+Returns:        Normal number of mean 0 and variance 1.
+*---------------------------------------------------------------------------*/
+static double GetNormal(Random &rng)
+{
+	// uniform numbers in (0, 1]
+	double u = ((rng.Next() >> 11) + 1) * (1.0 / 9007199254740992.0);
+	double v = ((rng.Next() >> 11) + 1) * (1.0 / 9007199254740992.0);
+
+	return std::sqrt(-2.0 * std::log(u)) * std::cos(6.283185307179586 * v);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Evaluate
+
+Description:	Play every candidate in every seat of the rules against the
+				opponents, on random streams first_stream, first_stream + 1, ...
+				(the same games for every candidate and seat).
+
+Arguments:      pool: Work-stealing pool.
+				rules: Rules, ai_ is the line-up of opponents.
+				seed: Random seed.
+				first_stream: Stream of the first game.
+				seat_games: Games played by a candidate in each seat.
+				candidates: Candidates, wins_ is set.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void Evaluate(WorkPool &pool, const RuleSet &rules, unsigned long long seed, unsigned long long first_stream,
+	int seat_games, std::vector<Candidate> &candidates)
+{
+	int num_players = rules.num_players_;
+	int seat_jobs = (seat_games + JOB_GAMES - 1) / JOB_GAMES;
+	int candidate_jobs = num_players * seat_jobs;
+	std::vector<int> wins(candidates.size() * candidate_jobs, 0);
+
+	pool.Run((int)wins.size(), [&](int job, int)
+	{
+		const Candidate &candidate = candidates[job / candidate_jobs];
+		int seat = (job % candidate_jobs) / seat_jobs;
+		int first_game = (job % seat_jobs) * JOB_GAMES;
+		int last_game = std::min(first_game + JOB_GAMES, seat_games);
+
+		RuleSet seat_rules = rules;
+		seat_rules.ai_[seat] = AI_SMART;
+
+		SweepEngine game(seat_rules, seed);
+		game.SetTuning(seat, &candidate.tuning_);
+
+		// without counter-based mode, each part of the games needs its own stream
+		if (!USE_COUNTER_RNG)
+			game.SeedStream(first_stream + first_game + 1);
+
+		GameStats stats;
+		int num_wins = 0;
+		for (int i = first_game; i < last_game; ++i)
+		{
+			if (USE_COUNTER_RNG)
+				game.SeedStream(first_stream + i);
+
+			if (game.Play(stats) == seat)
+				++num_wins;
+		}
+
+		wins[job] = num_wins;
+	});
+
+	for (size_t i = 0; i < candidates.size(); ++i)
+	{
+		candidates[i].wins_ = 0;
+		for (int j = 0; j < candidate_jobs; ++j)
+			candidates[i].wins_ += wins[i * candidate_jobs + j];
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           WriteLogRow
+
+Description:	Write the CSV row of a generation.
+
+Arguments:      log: Output stream.
+				index: Index of the generation.
+				generation: Convergence of the generation.
+				num_candidates: Candidates evaluated so far.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+static void WriteLogRow(std::ostream &log, int index, const TuneGeneration &generation, long long num_candidates)
+{
+	log << index << ',' << num_candidates << ',' << generation.seconds_ << ',' << generation.best_ << ','
+		<< generation.mean_ << ',' << generation.elite_ << ',' << generation.spread_priority_ << ','
+		<< generation.spread_threshold_;
+
+	for (int i = 0; i < AB_NUMBER; ++i)
+		log << ',' << generation.mean_genome_.priority_[i];
+	for (int i = 0; i < AB_NUMBER; ++i)
+		log << ',' << generation.mean_genome_.threshold_[i];
+
+	log << '\n';
+	log.flush();
+}
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           RunTuner
+
+Description:	Tune the smart AI. The mean genome starts at the default weights,
+				never dealing special cards early. Each generation, candidate 0
+				is the mean and the others are drawn around it, each gene with
+				its own spread. Every candidate plays num_games_ games (split
+				across seats) on the streams of the generation. The mean moves
+				to the best quarter, and the spreads move (by SPREAD_RATE) to
+				the spreads of the best quarter around the old mean.
+
+Arguments:      settings: Tuner settings.
+				result: Tuned genome and convergence.
+				log: Output of CSV rows (null: no log).
+
+Returns:        false if the rules can't be played.
+*---------------------------------------------------------------------------*/
+bool POKER::RunTuner(const TuneSettings &settings, TuneResult &result, std::ostream *log)
+{
+	const RuleSet &rules = settings.rules_;
+	if (!rules.IsValid() || (settings.population_ < 2) || (settings.generations_ < 1) ||
+		(settings.num_games_ < rules.num_players_))
+		return false;
+
+	unsigned long long seed = (settings.seed_ != 0) ? settings.seed_ : (unsigned long long)std::time(0);
+	int num_players = rules.num_players_;
+	int seat_games = settings.num_games_ / num_players;
+	int num_elite = std::max(2, settings.population_ / 4);
+
+	WorkPool pool(GetNumThreads(settings.num_threads_, settings.population_ * num_players));
+
+	result = TuneResult();
+	result.seed_ = seed;
+	result.num_threads_ = pool.GetNumThreads();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// mean genome and spreads
+
+	double mean[NUM_GENES];
+	double spread[NUM_GENES];
+	SmartTuning default_tuning;
+
+	for (int i = 0; i < AB_NUMBER; ++i)
+	{
+		mean[i] = default_tuning.priority_[i];
+		spread[i] = 1.0;
+		mean[AB_NUMBER + i] = default_tuning.threshold_[i] + 0.5;
+		spread[AB_NUMBER + i] = rules.limit_ / 4.0;
+	}
+
+	Random rng;
+	rng.Seed(seed, ~0ULL);
+
+	if (log != nullptr)
+	{
+		*log << "generation,candidates,seconds,best,mean,elite,spread_priority,spread_threshold";
+		for (int i = 0; i < AB_NUMBER; ++i)
+			*log << ",priority_" << ABILITY_NAMES[i];
+		for (int i = 0; i < AB_NUMBER; ++i)
+			*log << ",threshold_" << ABILITY_NAMES[i];
+		*log << '\n' << std::setprecision(6);
+	}
+
+	std::vector<Candidate> candidates(settings.population_);
+
+	for (int generation = 0; generation < settings.generations_; ++generation)
+	{
+		// draw candidates around the mean (candidate 0 is the mean)
+
+		for (int i = 0; i < settings.population_; ++i)
+		{
+			for (int j = 0; j < NUM_GENES; ++j)
+				candidates[i].genes_[j] = mean[j] + ((i == 0) ? 0.0 : spread[j] * GetNormal(rng));
+
+			// thresholds below 0 all mean never, above the limit always
+			for (int j = AB_NUMBER; j < NUM_GENES; ++j)
+				candidates[i].genes_[j] = std::min(std::max(candidates[i].genes_[j], -0.5), rules.limit_ + 0.5);
+
+			SetTuning(candidates[i].genes_, candidates[i].tuning_);
+		}
+
+		Evaluate(pool, rules, seed, (unsigned long long)generation * settings.num_games_, seat_games, candidates);
+
+		result.num_candidates_ += settings.population_;
+		result.num_games_ += (long long)settings.population_ * seat_games * num_players;
+
+		// keep the best quarter
+
+		std::sort(candidates.begin(), candidates.end(),
+			[](const Candidate &a, const Candidate &b) { return a.wins_ > b.wins_; });
+
+		double games = (double)seat_games * num_players;
+		TuneGeneration row;
+		row.best_ = candidates[0].wins_ / games;
+		row.mean_ = 0.0;
+		row.elite_ = 0.0;
+		for (int i = 0; i < settings.population_; ++i)
+		{
+			row.mean_ += candidates[i].wins_ / games / settings.population_;
+			if (i < num_elite)
+				row.elite_ += candidates[i].wins_ / games / num_elite;
+		}
+
+		row.spread_priority_ = 0.0;
+		row.spread_threshold_ = 0.0;
+
+		for (int j = 0; j < NUM_GENES; ++j)
+		{
+			double elite_mean = 0.0;
+			double elite_spread = 0.0;
+			for (int i = 0; i < num_elite; ++i)
+			{
+				double gene = candidates[i].genes_[j];
+				elite_mean += gene / num_elite;
+				elite_spread += (gene - mean[j]) * (gene - mean[j]) / num_elite;
+			}
+
+			double min_spread = (j < AB_NUMBER) ? MIN_SPREAD_PRIORITY : MIN_SPREAD_THRESHOLD;
+
+			mean[j] = elite_mean;
+			spread[j] = std::max(min_spread, (1.0 - SPREAD_RATE) * spread[j] + SPREAD_RATE * std::sqrt(elite_spread));
+
+			if (j < AB_NUMBER)
+				row.spread_priority_ += spread[j] / AB_NUMBER;
+			else
+				row.spread_threshold_ += spread[j] / AB_NUMBER;
+		}
+
+		SetTuning(mean, row.mean_genome_);
+		row.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.log_.push_back(row);
+
+		if (log != nullptr)
+			WriteLogRow(*log, generation, row, result.num_candidates_);
+	}
+
+	result.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// check the tuned and the default genome on games no generation has played
+
+	std::vector<Candidate> check(2);
+	SetTuning(mean, check[0].tuning_);
+	check[1].tuning_ = default_tuning;
+
+	int check_seat_games = std::max(1, settings.num_check_games_ / num_players);
+	Evaluate(pool, rules, seed, (unsigned long long)settings.generations_ * settings.num_games_, check_seat_games, check);
+
+	result.best_ = check[0].tuning_;
+	result.best_rate_ = check[0].wins_ / ((double)check_seat_games * num_players);
+	result.default_rate_ = check[1].wins_ / ((double)check_seat_games * num_players);
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Evolutionary tuner of the smart AI
+// the genome is a SmartTuning: a priority and an early-play threshold for each special ability
+// each generation samples candidates around a mean genome (one spread per gene), plays every candidate
+// in every seat against a fixed line-up of opponents on the sweep engine, keeps the best quarter
+// and moves the mean and spreads to them (cross-entropy method, a diagonal evolution strategy)
+// all candidates of a generation play the same games (common random streams), so they are compared
+// on the same deals; each generation moves on to new streams, so the tuner doesn't learn one set of deals
+// the final mean is checked against the default weights on games no generation has played
+
+#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "sweep.h"
+
+namespace POKER
+{
+	// number of candidates of a generation
+	static const int TUNE_POPULATION		= 64;
+	// number of generations
+	static const int TUNE_GENERATIONS		= 30;
+	// number of games played by each candidate in each generation (split evenly across seats)
+	static const int TUNE_GAMES				= 2000;
+	// number of games played to check the result
+	static const int TUNE_CHECK_GAMES		= 200000;
+
+	// settings of the tuner
+	struct TuneSettings
+	{
+		RuleSet rules_;					// rules, ai_ is the line-up of opponents (the tuned player takes a seat in turn)
+		int population_;				// candidates per generation
+		int generations_;				// number of generations
+		int num_games_;					// games per candidate per generation
+		int num_check_games_;			// games to check the result
+		int num_threads_;				// number of threads (0 means all hardware threads)
+		unsigned long long seed_;		// random seed (0 means seed from current time)
+
+		// constructor
+		TuneSettings()
+			: population_(TUNE_POPULATION), generations_(TUNE_GENERATIONS), num_games_(TUNE_GAMES),
+			num_check_games_(TUNE_CHECK_GAMES), num_threads_(NUM_THREADS), seed_(RANDOM_SEED) {}
+	};
+
+	// convergence of a generation
+	struct TuneGeneration
+	{
+		double best_;					// win rate of the best candidate
+		double mean_;					// mean win rate of the candidates
+		double elite_;					// mean win rate of the kept candidates
+		double spread_priority_;		// mean spread of the priority genes after the generation
+		double spread_threshold_;		// mean spread of the threshold genes after the generation
+		double seconds_;				// time since the tuner started
+		SmartTuning mean_genome_;		// mean genome after the generation
+	};
+
+	// result of the tuner
+	struct TuneResult
+	{
+		unsigned long long seed_;			// random seed
+		int num_threads_;					// number of threads
+		long long num_candidates_;			// candidates evaluated
+		long long num_games_;				// games played by the candidates
+		double seconds_;					// time spent
+		SmartTuning best_;					// tuned genome (mean of the last generation)
+		double best_rate_;					// win rate of the tuned genome on the check games
+		double default_rate_;				// win rate of the default weights on the check games
+		std::vector<TuneGeneration> log_;	// convergence of each generation
+
+		// constructor
+		TuneResult() : seed_(0), num_threads_(0), num_candidates_(0), num_games_(0), seconds_(0.0),
+			best_rate_(0.0), default_rate_(0.0) {}
+	};
+
+	// tune the smart AI, write a CSV row of each generation to log (null: no log)
+	// returns false if the rules can't be played
+	bool RunTuner(const TuneSettings &settings, TuneResult &result, std::ostream *log);
+}
@@ -0,0 +1,155 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Work-stealing thread pool
+
+#include <thread>		// std::thread
+
+#include "workpool.h"
+
+using namespace POKER;
+
+// public functions
+
+/*--------------------------------------------------------------------------*
+Name:           WorkPool
+
+Description:	Constructor.
+
+Arguments:      num_threads: Number of worker threads (0 means all hardware threads).
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+WorkPool::WorkPool(int num_threads)
+	: num_threads_(num_threads), num_steals_(0)
+{
+	if (num_threads_ <= 0)
+		num_threads_ = (int)std::thread::hardware_concurrency();
+	if (num_threads_ < 1)
+		num_threads_ = 1;
+
+	std::vector<Queue> queues(num_threads_);
+	queues_.swap(queues);
+}
+
+/*--------------------------------------------------------------------------*
+Name:           Run
+
+Description:	Run jobs [0, num_jobs). Jobs are dealt to the workers in turn,
+				so neighbouring jobs (often of similar length) start on different
+				threads. The calling thread works as worker 0.
+
+Arguments:      num_jobs: Number of jobs.
+				func: Job function.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void WorkPool::Run(int num_jobs, const JobFunc &func)
+{
+	for (int i = 0; i < num_jobs; ++i)
+		queues_[i % num_threads_].jobs_.push_back(i);
+
+	std::vector<int> num_steals(num_threads_, 0);
+	std::vector<std::thread> threads;
+
+	for (int i = 1; i < num_threads_; ++i)
+		threads.emplace_back(&WorkPool::Work, this, i, std::cref(func), &num_steals[i]);
+
+	Work(0, func, &num_steals[0]);
+
+	num_steals_ = 0;
+	for (int i = 0; i < num_threads_; ++i)
+	{
+		if (i > 0)
+			threads[i - 1].join();
+
+		num_steals_ += num_steals[i];
+	}
+}
+
+// private functions
+
+/*--------------------------------------------------------------------------*
+Name:           Work
+
+Description:	Worker thread. Run jobs of its own queue, then steal jobs from
+				other workers. No job is added during a run, so the worker is
+				done once every queue is empty.
+
+Arguments:      worker: Index of the worker.
+				func: Job function.
+				num_steals: Number of jobs stolen by this worker.
+
+Returns:        None.
+*---------------------------------------------------------------------------*/
+void WorkPool::Work(int worker, const JobFunc &func, int *num_steals)
+{
+	for (;;)
+	{
+		int job = PopJob(worker);
+
+		if (job < 0)
+		{
+			job = StealJob(worker);
+			if (job < 0)
+				break;
+
+			++*num_steals;
+		}
+
+		func(job, worker);
+	}
+}
+
+/*--------------------------------------------------------------------------*
+Name:           PopJob
+
+Description:	Take a job from the back of a worker's own queue.
+
+Arguments:      worker: Index of the worker.
+
+Returns:        Index of the job, -1 if the queue is empty.
+*---------------------------------------------------------------------------*/
+int WorkPool::PopJob(int worker)
+{
+	Queue &queue = queues_[worker];
+	std::lock_guard<std::mutex> lock(queue.mutex_);
+
+	if (queue.jobs_.empty())
+		return -1;
+
+	int job = queue.jobs_.back();
+	queue.jobs_.pop_back();
+
+	return job;
+}
+
+/*--------------------------------------------------------------------------*
+Name:           StealJob
+
+Description:	Take a job from the front of another worker's queue
+				(the job its owner would run last), trying the next workers in turn.
+
+Arguments:      worker: Index of the worker that steals.
+
+Returns:        Index of the job, -1 if every queue is empty.
+*---------------------------------------------------------------------------*/
+int WorkPool::StealJob(int worker)
+{
+	for (int i = 1; i < num_threads_; ++i)
+	{
+		Queue &queue = queues_[(worker + i) % num_threads_];
+		std::lock_guard<std::mutex> lock(queue.mutex_);
+
+		if (queue.jobs_.empty())
+			continue;
+
+		int job = queue.jobs_.front();
+		queue.jobs_.pop_front();
+
+		return job;
+	}
+
+	return -1;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+﻿// Author: Chi-Hao Kuo
+// Updated: 10/17/2026
+// All content © 2014 DigiPen(USA) Corporation, all rights reserved.
+
+// Work-stealing thread pool
+// jobs are dealt to the workers up front, each worker runs jobs from the back of its own queue
+// and, when it runs out, steals from the front of another worker's queue
+// so jobs of very different length still keep every thread busy until the last job is done
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "simulation.h"
+
+namespace POKER
+{
+	class WorkPool
+	{
+	public:
+		// job function, called with the index of the job and the index of the worker running it
+		typedef std::function<void(int job, int worker)> JobFunc;
+
+		// constructor (0 threads means all hardware threads)
+		WorkPool(int num_threads);
+
+		// run jobs [0, num_jobs), returns when all jobs are done
+		void Run(int num_jobs, const JobFunc &func);
+
+		// number of worker threads
+		int GetNumThreads(void) const { return num_threads_; }
+		// number of jobs stolen from another worker by the last Run
+		int GetNumSteals(void) const { return num_steals_; }
+
+	private:
+		// job queue of a worker, padded so queues of different workers never share a cache line
+		struct Queue
+		{
+			std::mutex mutex_;				// guards jobs_
+			std::deque<int> jobs_;			// jobs left
+			char padding_[CACHE_LINE_SIZE];
+		};
+
+		int num_threads_;					// number of worker threads
+		int num_steals_;					// number of jobs stolen
+		std::vector<Queue> queues_;			// job queue of each worker
+
+		// worker thread, run jobs until every queue is empty
+		void Work(int worker, const JobFunc &func, int *num_steals);
+		// take a job from the back of a worker's own queue, returns -1 if empty
+		int PopJob(int worker);
+		// take a job from the front of another worker's queue, returns -1 if every queue is empty
+		int StealJob(int worker);
+	};
+}